@@ -0,0 +1,142 @@
+/**
+ * @file ast.cc implementation of the compiled form of a See expression
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/ast.h"
+
+#include "osal/exception.h"
+
+#include <utility> // std::swap
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark ::: AstNode :::
+#pragma mark -
+#endif
+
+casper::see::AstNode::AstNode (casper::see::AstNode::Type a_type)
+    : type_(a_type), slot_(-1), size_(1)
+{
+    /* empty */
+}
+
+casper::see::AstNode::AstNode (casper::see::AstNode::Type a_type, const casper::Term& a_value, const casper::see::location& a_location)
+    : type_(a_type), value_(a_value), location_(a_location), slot_(-1), size_(1)
+{
+    /* empty */
+}
+
+casper::see::AstNode::~AstNode ()
+{
+    /* empty, children are owned by the Ast */
+}
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark ::: Ast :::
+#pragma mark -
+#endif
+
+/**
+ * @brief Constructor
+ */
+casper::see::Ast::Ast ()
+{
+    root_ = nullptr;
+}
+
+/**
+ * @brief Destructor
+ */
+casper::see::Ast::~Ast ()
+{
+    Reset();
+}
+
+/**
+ * @brief Create a node for a grammar rule, the last @a a_argc operands on the stack become it's children
+ *
+ * @param a_type     grammar rule
+ * @param a_argc     number of non terminal operands
+ * @param a_value    semantic value of the rule's first symbol
+ * @param a_location location of the rule's first symbol
+ *
+ * @return the new node, already pushed to the operand stack
+ */
+casper::see::AstNode* casper::see::Ast::Reduce (casper::see::AstNode::Type a_type, size_t a_argc,
+                                                const casper::Term& a_value, const casper::see::location& a_location)
+{
+    if ( stack_.size() < a_argc ) {
+        throw OSAL_EXCEPTION("Expression compiler stack underflow, %zu operands available, %zu required", stack_.size(), a_argc);
+    }
+
+    AstNode* node = new AstNode(a_type, a_value, a_location);
+    allocated_nodes_.push_back(node);
+
+    node->args_.assign(stack_.end() - a_argc, stack_.end());
+    stack_.resize(stack_.size() - a_argc);
+    for ( auto arg : node->args_ ) {
+        node->size_ += arg->size_;
+    }
+    stack_.push_back(node);
+
+    return node;
+}
+
+/**
+ * @brief Create a node for a grammar rule whose first symbol is a non terminal
+ */
+casper::see::AstNode* casper::see::Ast::Reduce (casper::see::AstNode::Type a_type, size_t a_argc)
+{
+    return Reduce(a_type, a_argc, Term(), location());
+}
+
+/**
+ * @brief Push a constant value, rules made only of terminals are folded into a leaf by the parser
+ */
+casper::see::AstNode* casper::see::Ast::Leaf (const casper::Term& a_value, const casper::see::location& a_location)
+{
+    return Reduce(AstNode::TToken, 0, a_value, a_location);
+}
+
+/**
+ * @brief Release all nodes
+ */
+void casper::see::Ast::Reset ()
+{
+    for ( auto node : allocated_nodes_ ) {
+        delete node;
+    }
+    allocated_nodes_.clear();
+    stack_.clear();
+    root_ = nullptr;
+    name_.clear();
+}
+
+/**
+ * @brief Exchange the compiled expression with another tree
+ */
+void casper::see::Ast::Swap (casper::see::Ast& a_ast)
+{
+    allocated_nodes_.swap(a_ast.allocated_nodes_);
+    stack_.swap(a_ast.stack_);
+    std::swap(root_, a_ast.root_);
+    name_.swap(a_ast.name_);
+}
@@ -0,0 +1,204 @@
+/**
+ * @file ast.h declaration of the compiled form of a See expression
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#ifndef NRS_CASPER_CASPER_SEE_AST_H
+#define NRS_CASPER_CASPER_SEE_AST_H
+
+#include "casper/term.h"
+#include "casper/see/location.hh"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace casper
+{
+    namespace see
+    {
+        class Parser;
+        class See;
+        struct TableBinding;
+
+        /**
+         * @brief One reduction of the expression grammar
+         *
+         * There is one node type per grammar rule, the node keeps the semantic value of the
+         * rule's first symbol when it's a terminal (bison's default $$ = $1) plus any other
+         * terminal the rule action needs. Non terminal operands are kept in @a args_ by order.
+         */
+        class AstNode
+        {
+            friend class Ast;
+            friend class Parser;
+            friend class See;
+
+        public: // enumerations
+
+            enum Type : uint8_t {
+                TToken,
+                TVariable,
+                TAssign,
+                TExpression,
+                TCriteria,
+                TCriteriaList,
+                TVlookup,
+                TVlookupRange,
+                TLookup,
+                TSumVector,
+                TSumRange,
+                TSumIf,
+                TSumIfs,
+                TMaxList,
+                TMinList,
+                TAndList,
+                TOrList,
+                TConcatenateList,
+                TRound,
+                TRoundUp,
+                TRoundDown,
+                TIf,
+                TIfTrue,
+                TIfCondition,
+                TDate,
+                TYear,
+                TMonth,
+                TDay,
+                THour,
+                TMinute,
+                TSecond,
+                TDateValue,
+                TAbs,
+                TIsError,
+                TIfError,
+                TFind,
+                TFindFrom,
+                TLeft,
+                TRight,
+                TMid,
+                TMatch,
+                TOffset,
+                TAdd,
+                TSubtract,
+                TMultiply,
+                TDivide,
+                TUnaryMinus,
+                TPow,
+                TPercentage,
+                TEqual,
+                TConcatenate,
+                TGreater,
+                TLess,
+                TGreaterOrEqual,
+                TLessOrEqual,
+                TNotEqual,
+                TVectorIndirect,
+                TSumIfCriteria,
+                TTableCellRef,
+                TTableCellRefForOffset
+            };
+
+        protected: // Data
+
+            Type                  type_;      //!< Grammar rule that created the node
+            Term                  value_;     //!< Semantic value of the first symbol when it's a terminal
+            std::vector<Term>     tokens_;    //!< Other terminals used by the rule action
+            std::vector<AstNode*> args_;      //!< Non terminal operands, managed by Ast
+            std::string           text_;      //!< Source text slice or condition captured by the rule
+            location              location_;  //!< Location of the first symbol
+            int32_t               slot_;      //!< Symbol table slot of the variable or cell, -1 when unresolved
+            uint32_t              size_;      //!< Number of nodes of the sub-tree rooted at this node
+            std::shared_ptr<TableBinding> binding_; //!< Table and columns of a table function with constant references, see See::BindTables
+
+        public: // Constructor(s) / Destructor
+
+            AstNode (Type a_type);
+            AstNode (Type a_type, const Term& a_value, const location& a_location);
+            virtual ~AstNode ();
+
+            AstNode (const AstNode& a_node) = delete;
+            AstNode& operator = (const AstNode& a_node) = delete;
+
+        public: // Method(s) / Function(s)
+
+            Type GetType () const;
+
+        };
+
+        inline AstNode::Type AstNode::GetType () const
+        {
+            return type_;
+        }
+
+        /**
+         * @brief Compiled expression, a tree of grammar reductions built once by the parser
+         */
+        class Ast
+        {
+            friend class Parser;
+            friend class See;
+
+        protected: // Data
+
+            std::vector<AstNode*> allocated_nodes_;  //!< All nodes, released by #Reset
+            std::vector<AstNode*> stack_;            //!< Operands stack used while the parser reduces
+            AstNode*              root_;             //!< The 'input' rule node, NULL if not compiled
+            std::string           name_;             //!< Left hand side variable name, empty for plain expressions
+
+        public: // Constructor(s) / Destructor
+
+            Ast ();
+            virtual ~Ast ();
+
+            Ast (const Ast& a_ast) = delete;
+            Ast& operator = (const Ast& a_ast) = delete;
+
+        public: // Method(s) / Function(s)
+
+            AstNode*           Reduce     (AstNode::Type a_type, size_t a_argc);
+            AstNode*           Reduce     (AstNode::Type a_type, size_t a_argc, const Term& a_value, const location& a_location);
+            AstNode*           Leaf       (const Term& a_value, const location& a_location);
+            void               Reset      ();
+            void               Swap       (Ast& a_ast);
+            bool               IsCompiled () const;
+            AstNode*           Root       () const;
+            const std::string& Name       () const;
+
+        };
+
+        inline bool Ast::IsCompiled () const
+        {
+            return nullptr != root_;
+        }
+
+        inline AstNode* Ast::Root () const
+        {
+            return root_;
+        }
+
+        inline const std::string& Ast::Name () const
+        {
+            return name_;
+        }
+
+    } // namespace see
+} // namespace casper
+
+#endif // NRS_CASPER_CASPER_SEE_AST_H
@@ -0,0 +1,134 @@
+/**
+ * @file batch_bench.cc compares a batch calculation with one calculation per parameter set
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/test/test_helpers.h"
+
+#include <chrono>
+#include <vector>
+
+static const int k_shared_formulas_ = 2000;
+static const int k_lane_formulas_   = 500;
+static const int k_lanes_           = 1000;
+
+/**
+ * @brief Model whose shared formulas only read the month, the lane formulas read the salary parameter and the
+ *        shared results
+ */
+static std::string Model ()
+{
+    Json::Value model;
+    Json::Value lines;
+    char        cell[32];
+    char        formula[256];
+
+    model["values"]["A1"]["type"]  = "DECIMAL";
+    model["values"]["A1"]["value"] = "month=1";
+    model["values"]["salary"]["type"]  = "DECIMAL";
+    model["values"]["salary"]["value"] = "salary";
+    model["lines"]["header"]["C10"]["type"] = "DECIMAL";
+    model["lines"]["header"]["C10"]["name"] = "AMT";
+    model["lines"]["values"]   = Json::Value(Json::arrayValue);
+    model["lines"]["formulas"] = Json::Value(Json::arrayValue);
+
+    for ( int i = 1; i <= k_shared_formulas_; ++i ) {
+        snprintf(cell, sizeof(cell), "S%d", i);
+        if ( 1 == i ) {
+            snprintf(formula, sizeof(formula), "s1=month*1.5+IF(month>6,2,1)");
+        } else {
+            snprintf(formula, sizeof(formula), "s%d=IF(MAX(s%d,7)>30,s%d*0.99+month,s%d+month/3)+ROUND(month*%d/13,2)",
+                     i, i - 1, i - 1, i - 1, i);
+        }
+        model["formulas"][cell]["type"]  = "DECIMAL";
+        model["formulas"][cell]["value"] = formula;
+    }
+    for ( int i = 1; i <= k_lane_formulas_; ++i ) {
+        snprintf(cell, sizeof(cell), "E%d", i);
+        snprintf(formula, sizeof(formula), "e%d=ROUND(salary*%d/100+s%d,2)+IF(salary>1500,salary/10,0)", i, i,
+                 1 + ( i * 37 ) % k_shared_formulas_);
+        model["formulas"][cell]["type"]  = "DECIMAL";
+        model["formulas"][cell]["value"] = formula;
+    }
+
+    return Json::FastWriter().write(model);
+}
+
+/**
+ * @brief Calculate every parameter set with it's own CalculateAll call
+ *
+ * @return elapsed milliseconds
+ */
+static double CalculateEach (const std::string& a_model, bool a_incremental, const std::vector<Json::Value>& a_params,
+                             std::vector<Json::Value>& o_results)
+{
+    casper::see::test::TestSee see;
+    see.SetIncremental(a_incremental);
+    see.LoadModelFromString(a_model.c_str());
+    see.CalculateAll(a_params[0]);
+
+    o_results.resize(a_params.size());
+    const auto start = std::chrono::steady_clock::now();
+    for ( size_t i = 0; i < a_params.size(); ++i ) {
+        see.CalculateAll(a_params[i]);
+        see.SerializeScalarsToJSONObject(o_results[i]);
+    }
+    return casper::see::test::ElapsedMs(start);
+}
+
+int main (int /* a_argc */, char** /* a_argv */)
+{
+    const std::string        model = Model();
+    std::vector<Json::Value> params(k_lanes_);
+    std::vector<Json::Value> full, incremental, batch;
+    double                   full_ms = 0.0, incremental_ms = 0.0, batch_ms = 0.0;
+
+    for ( int i = 0; i < k_lanes_; ++i ) {
+        params[i]["month"]  = 3.0;
+        params[i]["salary"] = 800.0 + i * 7;
+    }
+
+    try {
+        full_ms        = CalculateEach(model, false, params, full);
+        incremental_ms = CalculateEach(model, true, params, incremental);
+
+        casper::see::test::TestSee see;
+        see.SetIncremental(true);
+        see.LoadModelFromString(model.c_str());
+        see.CalculateAll(params[0]);
+        const auto start = std::chrono::steady_clock::now();
+        see.CalculateBatch(params, batch);
+        batch_ms = casper::see::test::ElapsedMs(start);
+    } catch (const osal::Exception& a_exception) {
+        CASPER_CHECK(false, "%s", a_exception.Message());
+        return casper::see::test::Summary("batch_bench");
+    }
+
+    for ( int i = 0; i < k_lanes_; ++i ) {
+        CASPER_CHECK(full[i] == batch[i] && incremental[i] == batch[i], "lane %d differs", i);
+    }
+
+    fprintf(stdout, "%d shared + %d lane formulas, %d lanes:\n", k_shared_formulas_, k_lane_formulas_, k_lanes_);
+    fprintf(stdout, "   %d x CalculateAll             %9.1f ms\n", k_lanes_, full_ms);
+    fprintf(stdout, "   %d x incremental CalculateAll %9.1f ms\n", k_lanes_, incremental_ms);
+    fprintf(stdout, "   CalculateBatch                  %9.1f ms, %.1fx and %.1fx faster\n", batch_ms,
+            full_ms / batch_ms, incremental_ms / batch_ms);
+
+    return casper::see::test::Summary("batch_bench");
+}
@@ -0,0 +1,151 @@
+/**
+ * @file load_bench.cc times the loading of a large generated model, serial and with the worker threads
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/test/test_helpers.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+static const int k_values_     = 4000;
+static const int k_formulas_   = 20000;
+static const int k_line_rows_  = 500;
+static const int k_runs_       = 5;
+
+/**
+ * @brief Model with constant and parameter values, chained formulas and a lines table with four formula columns
+ */
+static Json::Value Model ()
+{
+    Json::Value model;
+    char        cell[32];
+    char        formula[256];
+
+    for ( int i = 0; i < k_values_; ++i ) {
+        // ... the parameters are declared by name ...
+        snprintf(cell, sizeof(cell), "A%d", i + 1);
+        if ( 0 == i % 4 ) {
+            snprintf(cell, sizeof(cell), "v%d", i);
+            snprintf(formula, sizeof(formula), "v%d", i);
+        } else {
+            snprintf(formula, sizeof(formula), "v%d=%d.25", i, i % 97);
+        }
+        model["values"][cell]["type"]  = "DECIMAL";
+        model["values"][cell]["value"] = formula;
+    }
+    for ( int i = 0; i < k_formulas_; ++i ) {
+        const int value = ( i * 37 ) % k_values_;
+        snprintf(cell, sizeof(cell), "B%d", i + 1);
+        if ( 0 == i ) {
+            snprintf(formula, sizeof(formula), "f0=v0*2");
+        } else if ( 0 == i % 3 ) {
+            snprintf(formula, sizeof(formula), "f%d=IF(f%d>v%d,ROUND(f%d/3,2),v%d+f%d)", i, i - 1, value, i - 1, value, i / 2);
+        } else {
+            snprintf(formula, sizeof(formula), "f%d=MAX(f%d,v%d)-MIN(v%d,1)+f%d*0.5", i, i - 1, value, ( value + 1 ) % k_values_, i / 3);
+        }
+        model["formulas"][cell]["type"]  = "DECIMAL";
+        model["formulas"][cell]["value"] = formula;
+    }
+
+    model["lines"]["header"]["C20000"]["type"] = "DECIMAL";
+    model["lines"]["header"]["C20000"]["name"] = "AMT";
+    model["lines"]["header"]["D20000"]["type"] = "DECIMAL";
+    model["lines"]["header"]["D20000"]["name"] = "RATE";
+    model["lines"]["header"]["E20000"]["type"] = "DECIMAL";
+    model["lines"]["header"]["E20000"]["name"] = "BASE";
+    model["lines"]["header"]["F20000"]["type"] = "DECIMAL";
+    model["lines"]["header"]["F20000"]["name"] = "TOTAL";
+    model["lines"]["values"]   = Json::Value(Json::arrayValue);
+    model["lines"]["formulas"] = Json::Value(Json::arrayValue);
+    for ( int row = 20001; row < 20001 + k_line_rows_; ++row ) {
+        Json::Value formulas;
+        snprintf(formula, sizeof(formula), "D%d=ROUND(v%d/100,4)", row, row % k_values_);
+        formulas["RATE"] = formula;
+        snprintf(formula, sizeof(formula), "E%d=f%d+v%d", row, ( row * 7 ) % k_formulas_, ( row * 3 ) % k_values_);
+        formulas["BASE"] = formula;
+        snprintf(formula, sizeof(formula), "C%d=IF(D%d>0.5,E%d*D%d,E%d)", row, row, row, row, row);
+        formulas["AMT"] = formula;
+        snprintf(formula, sizeof(formula), "F%d=C%d+D%d", row, row, row);
+        formulas["TOTAL"] = formula;
+        model["lines"]["formulas"].append(formulas);
+    }
+    model["formulas"]["Z1"]["type"]  = "DECIMAL";
+    model["formulas"]["Z1"]["value"] = "total=SUM(LINES[TOTAL])";
+
+    return model;
+}
+
+/**
+ * @brief Load the model @a k_runs_ times
+ *
+ * @return best load time in milliseconds
+ */
+static double Load (const Json::Value& a_model, size_t a_threads, Json::Value& o_result)
+{
+    double best = 1e30;
+
+    for ( int run = 0; run < k_runs_; ++run ) {
+        casper::see::test::TestSee see;
+        casper::StringMultiHash    clones;
+        Json::Value                model = a_model;
+        Json::Value                params;
+
+        see.SetCalculationThreads(a_threads);
+        const auto start = std::chrono::steady_clock::now();
+        see.LoadModel(model, clones);
+        best = std::min(best, casper::see::test::ElapsedMs(start));
+
+        for ( int i = 0; i < k_values_; i += 4 ) {
+            char name[32];
+            snprintf(name, sizeof(name), "v%d", i);
+            params[name] = static_cast<double>(i % 13);
+        }
+        see.CalculateAll(params);
+        o_result = Json::Value();
+        see.SerializeScalarsToJSONObject(o_result);
+    }
+    return best;
+}
+
+int main (int /* a_argc */, char** /* a_argv */)
+{
+    const Json::Value model   = Model();
+    const size_t      threads = std::max(2u, std::thread::hardware_concurrency());
+    Json::Value       serial_result, parallel_result;
+    double            serial_ms = 0.0, parallel_ms = 0.0;
+
+    try {
+        serial_ms   = Load(model, 0, serial_result);
+        parallel_ms = Load(model, threads, parallel_result);
+    } catch (const osal::Exception& a_exception) {
+        CASPER_CHECK(false, "%s", a_exception.Message());
+        return casper::see::test::Summary("load_bench");
+    }
+
+    CASPER_CHECK(serial_result == parallel_result, "the serial and parallel loads calculate different results");
+
+    fprintf(stdout, "%d values, %d formulas, %d lines of 4 formulas, best of %d loads:\n", k_values_, k_formulas_,
+            k_line_rows_, k_runs_);
+    fprintf(stdout, "   serial      %8.1f ms\n", serial_ms);
+    fprintf(stdout, "   %2zu threads  %8.1f ms, %.2fx\n", threads, parallel_ms, serial_ms / parallel_ms);
+
+    return casper::see::test::Summary("load_bench");
+}
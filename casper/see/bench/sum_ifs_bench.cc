@@ -0,0 +1,124 @@
+/**
+ * @file sum_ifs_bench.cc times SUMIFS over a 1M row table against a row by row scan
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/test/test_helpers.h"
+#include "casper/see/table.h"
+#include "casper/see/value.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+static const int k_rows_  = 1000000;
+static const int k_codes_ = 50;
+static const int k_runs_  = 20;
+
+/**
+ * @brief SUMIFS as a scan of the rows, each row tested against every criteria, the reference
+ */
+static double SumIfsByRow (const casper::see::Table& a_table, const char* a_sum_column, const casper::SymbolTable& a_criteria)
+{
+    const std::vector<casper::see::Table::Column>& columns = a_table.GetColumns();
+    const casper::see::Table::Column&              sum     = columns[a_table.GetColumnIndex(a_sum_column)];
+    std::vector<const casper::see::Table::Column*> tested;
+    std::vector<const casper::Term*>               values;
+    double                                         result  = 0.0;
+
+    for ( auto it = a_criteria.begin(); it != a_criteria.end(); ++it ) {
+        tested.push_back(&columns[a_table.GetColumnIndex(it->first.c_str())]);
+        values.push_back(&it->second);
+    }
+    for ( size_t row = 0; row < sum.Size(); ++row ) {
+        bool match = true;
+        for ( size_t idx = 0; idx < tested.size() && true == match; ++idx ) {
+            match = casper::see::Table::Equal(*values[idx], tested[idx]->At(row));
+        }
+        if ( false == match ) {
+            continue;
+        }
+        const double number = sum.ToNumber(row);
+        if ( false == std::isnan(number) ) {
+            result += number;
+        }
+    }
+    return result;
+}
+
+int main (int /* a_argc */, char** /* a_argv */)
+{
+    casper::see::Table       table("AMOUNTS", false);
+    std::mt19937             generator(3);
+    std::vector<std::string> codes;
+    casper::SymbolTable      criteria;
+    casper::Term             code, year, result;
+    double                   reference = 0.0, by_row_ms = 1e30, sum_ifs_ms = 1e30, column_ms = 1e30, column = 0.0;
+
+    for ( int i = 0; i < k_codes_; ++i ) {
+        std::string text;
+        for ( int letter = 0; letter < 20; ++letter ) {
+            text += static_cast<char>('A' + generator() % 26);
+        }
+        codes.push_back(text);
+    }
+
+    // ... one column at a time, AddColumn may move the columns added before ...
+    casper::see::Table::Column& amount = table.AddColumn("amount");
+    for ( int row = 0; row < k_rows_; ++row ) {
+        amount.Append(casper::see::Value(static_cast<double>(generator() % 100000) / 100.0));
+    }
+    casper::see::Table::Column& code_column = table.AddColumn("code");
+    for ( int row = 0; row < k_rows_; ++row ) {
+        code_column.Append(casper::see::Value(codes[generator() % k_codes_]));
+    }
+    casper::see::Table::Column& year_column = table.AddColumn("year");
+    for ( int row = 0; row < k_rows_; ++row ) {
+        year_column.Append(casper::see::Value(static_cast<double>(2000 + generator() % 20)));
+    }
+
+    code = codes[7];
+    year = 2005.0;
+    criteria["code"] = code;
+    criteria["year"] = year;
+
+    for ( int run = 0; run < k_runs_; ++run ) {
+        auto start = std::chrono::steady_clock::now();
+        reference  = SumIfsByRow(table, "amount", criteria);
+        by_row_ms  = std::min(by_row_ms, casper::see::test::ElapsedMs(start));
+
+        start      = std::chrono::steady_clock::now();
+        table.SumIfs(result, "amount", criteria);
+        sum_ifs_ms = std::min(sum_ifs_ms, casper::see::test::ElapsedMs(start));
+
+        start      = std::chrono::steady_clock::now();
+        column     = table.SumColumn("amount");
+        column_ms  = std::min(column_ms, casper::see::test::ElapsedMs(start));
+    }
+
+    CASPER_CHECK(result.GetNumber() == reference, "SUMIFS %.17g row by row %.17g", result.GetNumber(), reference);
+    CASPER_CHECK(column > reference, "SUM of the column %.17g", column);
+
+    fprintf(stdout, "%d rows, %d codes of 20 letters, 2 criteria, best of %d runs:\n", k_rows_, k_codes_, k_runs_);
+    fprintf(stdout, "   row by row scan %7.2f ms\n", by_row_ms);
+    fprintf(stdout, "   SumIfs          %7.2f ms, %.1fx, sum %.17g\n", sum_ifs_ms, by_row_ms / sum_ifs_ms, result.GetNumber());
+    fprintf(stdout, "   SumColumn       %7.2f ms\n", column_ms);
+
+    return casper::see::test::Summary("sum_ifs_bench");
+}
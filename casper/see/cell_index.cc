@@ -0,0 +1,165 @@
+/**
+ * @file cell_index.cc implementation of the index of the defined cells by column and row
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/cell_index.h"
+#include "casper/see/sum.h"
+
+#include <algorithm>
+#include <string.h>
+
+/**
+ * @brief Constructor
+ */
+casper::see::CellIndex::CellIndex ()
+{
+    /* empty */
+}
+
+/**
+ * @brief Destructor
+ */
+casper::see::CellIndex::~CellIndex ()
+{
+    /* empty */
+}
+
+/**
+ * @brief Index the names of the maps that are cell references
+ *
+ * Only names written the way Sum::MakeRowColRef writes them are cells, a name like "total1" parses as a
+ * cell reference but it's not the name of cell TOTAL1.
+ *
+ * @param a_symtab      symbol table of the model
+ * @param a_aliases     aliases of the model
+ * @param a_line_values literals of the lines table
+ */
+void casper::see::CellIndex::Build (const SymbolTable& a_symtab, const StringHash& a_aliases, const SymbolTable& a_line_values)
+{
+    struct Entry
+    {
+        int32_t            col_;
+        int32_t            row_;
+        int                source_;
+        const std::string* name_;
+    };
+
+    std::vector<Entry> entries;
+    char               cell_ref[20];
+
+    auto add = [&entries, &cell_ref] (const std::string& a_cell_ref, int a_source, const std::string* a_name) {
+        int32_t col, row;
+        if ( false == Sum::ParseCellRef(a_cell_ref.c_str(), &col, &row) ) {
+            return;
+        }
+        Sum::MakeRowColRef(cell_ref, row, col);
+        if ( 0 != strcmp(cell_ref, a_cell_ref.c_str()) ) {
+            return;
+        }
+        entries.push_back({ col, row, a_source, a_name });
+    };
+
+    Clear();
+
+    for ( SymbolTable::const_iterator it = a_symtab.begin(); it != a_symtab.end(); ++it ) {
+        add(it->first, 0, &it->first);
+    }
+    for ( StringHash::const_iterator it = a_aliases.begin(); it != a_aliases.end(); ++it ) {
+        add(it->first, 1, &it->second);
+    }
+    for ( SymbolTable::const_iterator it = a_line_values.begin(); it != a_line_values.end(); ++it ) {
+        add(it->first, 2, &it->first);
+    }
+
+    std::sort(entries.begin(), entries.end(), [] (const Entry& a_lhs, const Entry& a_rhs) {
+        return a_lhs.col_ < a_rhs.col_ || ( a_lhs.col_ == a_rhs.col_ && a_lhs.row_ < a_rhs.row_ );
+    });
+
+    std::vector<Cell>* cells = nullptr;
+    int32_t            col   = 0;
+    for ( const Entry& entry : entries ) {
+        if ( nullptr == cells || entry.col_ != col ) {
+            col   = entry.col_;
+            cells = &columns_[col];
+        }
+        if ( true == cells->empty() || cells->back().row_ != entry.row_ ) {
+            cells->push_back({ entry.row_, nullptr, nullptr, nullptr });
+        }
+        switch (entry.source_) {
+            case 0:
+                cells->back().symbol_ = entry.name_;
+                break;
+            case 1:
+                cells->back().alias_ = entry.name_;
+                break;
+            default:
+                cells->back().line_value_ = entry.name_;
+                break;
+        }
+    }
+}
+
+void casper::see::CellIndex::Clear ()
+{
+    columns_.clear();
+}
+
+/**
+ * @brief Cells of a column between two rows, both included
+ *
+ * @param a_col       column, base is 1
+ * @param a_first_row first row
+ * @param a_last_row  last row
+ * @param o_first     receives the first cell of the range
+ *
+ * @return the number of cells in the range
+ */
+size_t casper::see::CellIndex::Range (int32_t a_col, int32_t a_first_row, int32_t a_last_row, const Cell*& o_first) const
+{
+    o_first = nullptr;
+
+    const auto it = columns_.find(a_col);
+    if ( columns_.end() == it || a_last_row < a_first_row ) {
+        return 0;
+    }
+
+    const std::vector<Cell>& cells = it->second;
+    const auto               first = std::lower_bound(cells.begin(), cells.end(), a_first_row, [] (const Cell& a_cell, int32_t a_row) {
+        return a_cell.row_ < a_row;
+    });
+    const auto               last  = std::upper_bound(first, cells.end(), a_last_row, [] (int32_t a_row, const Cell& a_cell) {
+        return a_row < a_cell.row_;
+    });
+
+    if ( first == last ) {
+        return 0;
+    }
+    o_first = &(*first);
+    return static_cast<size_t>(last - first);
+}
+
+/**
+ * @return the cell or NULL when the model does not define it
+ */
+const casper::see::CellIndex::Cell* casper::see::CellIndex::Find (int32_t a_col, int32_t a_row) const
+{
+    const Cell* cell;
+    return ( 0 != Range(a_col, a_row, a_row, cell) ? cell : nullptr );
+}
@@ -0,0 +1,75 @@
+/**
+ * @file cell_index.h declaration of the index of the defined cells by column and row
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#ifndef NRS_CASPER_CASPER_SEE_CELL_INDEX_H
+#define NRS_CASPER_CASPER_SEE_CELL_INDEX_H
+
+#include "casper/term.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace casper
+{
+    namespace see
+    {
+        /**
+         * @brief Cells the model defines, by column and sorted by row, for the dependency expansion of the sums
+         *
+         * A cell is defined when it's reference is a symbol, is aliased to a name or has a literal in the lines
+         * table. The names point into the maps the index was built from, it's valid while they are not changed.
+         */
+        class CellIndex
+        {
+        public: // Data types
+
+            struct Cell
+            {
+                int32_t            row_;         //!< Excel row, base is 1
+                const std::string* symbol_;      //!< Cell reference in the symbol table, NULL when it's not there
+                const std::string* alias_;       //!< Name the cell is aliased to, NULL when it's not aliased
+                const std::string* line_value_;  //!< Cell reference in the lines table literals, NULL when it has none
+            };
+
+        protected: // Data
+
+            std::map<int32_t, std::vector<Cell>> columns_;  //!< Cells of each column sorted by row
+
+        public: // Constructor(s) / Destructor
+
+            CellIndex ();
+            virtual ~CellIndex ();
+
+        public: // Method(s) / Function(s)
+
+            void        Build (const SymbolTable& a_symtab, const StringHash& a_aliases, const SymbolTable& a_line_values);
+            void        Clear ();
+            size_t      Range (int32_t a_col, int32_t a_first_row, int32_t a_last_row, const Cell*& o_first) const;
+            const Cell* Find  (int32_t a_col, int32_t a_row) const;
+
+        };
+
+    } // namespace see
+} // namespace casper
+
+#endif // NRS_CASPER_CASPER_SEE_CELL_INDEX_H
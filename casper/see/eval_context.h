@@ -0,0 +1,106 @@
+/**
+ * @file eval_context.h declaration of the state of one formula evaluation
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#ifndef NRS_CASPER_CASPER_SEE_EVAL_CONTEXT_H
+#define NRS_CASPER_CASPER_SEE_EVAL_CONTEXT_H
+
+#include "casper/term.h"
+#include "casper/see/slot_table.h"
+#include "casper/see/lookup_cache.h"
+#include "casper/see/lines_index.h"
+
+#include <map>
+#include <memory> // std::shared_ptr
+#include <string>
+#include <vector>
+
+namespace casper
+{
+    namespace see
+    {
+        class Formula;
+
+        /**
+         * @brief Scratch state of the formula being evaluated
+         *
+         * Each calculation thread owns one context. The contexts of the parallel calculation share the symbol
+         * table of the model, a context initialized by See::InitContext has it's own symbol table so that whole
+         * calculations can run concurrently on one loaded model.
+         */
+        class EvalContext
+        {
+        public: // Data
+
+            Term        result_;              //!< Result of the last expression evaluated
+            Formula*    current_formula_;     //!< Formula being calculated
+            std::string expression_name_;     //!< Left hand side variable of the expression being evaluated
+            SymbolTable sum_criterias_;       //!< Criterias collected for SUMIFS (we only handle one at a time)
+            std::vector<int32_t> sum_cache_slots_; //!< Slots of the LINES SUMIF and SUMIFS results cached by the calculation
+            size_t      skipped_expressions_; //!< Sub-expressions not evaluated because of short-circuit
+            bool        check_dependencies_;  //!< The formula being loaded is evaluated for it's dependencies, not calculated
+            std::shared_ptr<SlotTable> slots_;  //!< Symbol table of the calculation, NULL to use the model's one
+            LookupCache::Scope lookups_;      //!< LOOKUP and VLOOKUP results of the running calculation
+            uint64_t    lookups_generation_;  //!< Tables generation of #lookups_
+            std::map<int, LinesIndex> lines_index_;   //!< Search columns of the LINES table VLOOKUP by column, built once per calculation
+
+        public: // Constructor(s) / Destructor
+
+            EvalContext ();
+            virtual ~EvalContext ();
+
+        public: // Method(s) / Function(s)
+
+            void ResetLookups ();
+
+        };
+
+        /**
+         * @brief Constructor
+         */
+        inline EvalContext::EvalContext ()
+        {
+            current_formula_     = nullptr;
+            skipped_expressions_ = 0;
+            check_dependencies_  = false;
+            lookups_generation_  = 0;
+        }
+
+        /**
+         * @brief Destructor
+         */
+        inline EvalContext::~EvalContext ()
+        {
+            /* empty */
+        }
+
+        /**
+         * @brief Forget the lookup results and indexes of the previous calculation
+         */
+        inline void EvalContext::ResetLookups ()
+        {
+            lookups_.clear();
+            lines_index_.clear();
+        }
+
+    } // namespace see
+} // namespace casper
+
+#endif // NRS_CASPER_CASPER_SEE_EVAL_CONTEXT_H
@@ -27,7 +27,7 @@
  */
 casper::see::Formula::Formula ()
 {
-    /* empty */
+    slot_ = SlotTable::k_invalid_slot_;
 }
 
 /**
@@ -44,27 +44,60 @@ void casper::see::Formula::CalculateDependencies (See& a_see)
     OSAL_UNUSED_PARAM(a_see);
 }
 
-double casper::see::Formula::SumAllTerms (SymbolTable& a_symtab, FILE* a_logfile)
+/**
+ * @brief Resolve the formula name and precedents to symbol table slots
+ *
+ * @param a_slots the calculation symbol table
+ */
+void casper::see::Formula::ResolveSlots (SlotTable& a_slots)
+{
+    slot_ = a_slots.Resolve(name_);
+    precedent_slots_.clear();
+    for ( StringSet::iterator it = precedents_.begin(); it != precedents_.end(); ++it ) {
+        precedent_slots_.push_back(a_slots.Resolve(*it));
+    }
+}
+
+double casper::see::Formula::SumAllTerms (SlotTable& a_slots, FILE* a_logfile)
 {
     // Dummy on this class
-    OSAL_UNUSED_PARAM(a_symtab);
+    OSAL_UNUSED_PARAM(a_slots);
     OSAL_UNUSED_PARAM(a_logfile);
     return 0.0;
 }
 
-double casper::see::Formula::SumIfAllTerms (SymbolTable& a_symtab, SymbolTable& a_criterias, FILE* a_logfile)
+double casper::see::Formula::SumIfAllTerms (SlotTable& a_slots, SymbolTable& a_criterias, FILE* a_logfile)
 {
-    OSAL_UNUSED_PARAM(a_symtab);
+    OSAL_UNUSED_PARAM(a_slots);
     OSAL_UNUSED_PARAM(a_criterias);
     OSAL_UNUSED_PARAM(a_logfile);
     return 0.0;
 }
 
-casper::Term casper::see::Formula::VLOOKUP (const Term& a_value, const char* const a_lookup_col, const Term& a_result_index, bool a_range_lookup)
+/**
+ * @brief Write the formula to the model cache, the compiled expression is rebuilt from #formula_
+ *
+ * Specializations write their own data first and then call this method, see #Restore.
+ */
+void casper::see::Formula::Save (ModelCacheWriter& a_writer) const
+{
+    a_writer.Write(name_);
+    a_writer.Write(alias_);
+    a_writer.Write(precedents_);
+    a_writer.Write(formula_);
+    a_writer.Write(description_);
+    a_writer.Write(type_);
+}
+
+/**
+ * @brief Read the data written by #Formula::Save
+ */
+void casper::see::Formula::Restore (ModelCacheReader& a_reader)
 {
-    OSAL_UNUSED_PARAM(a_value);
-    OSAL_UNUSED_PARAM(a_lookup_col);
-    OSAL_UNUSED_PARAM(a_result_index);
-    OSAL_UNUSED_PARAM(a_range_lookup);
-    return casper::Term(casper::Term::EUndefined);
+    name_        = a_reader.ReadString();
+    alias_       = a_reader.ReadString();
+    a_reader.Read(precedents_);
+    formula_     = a_reader.ReadString();
+    description_ = a_reader.ReadString();
+    type_        = a_reader.ReadString();
 }
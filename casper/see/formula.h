@@ -22,6 +22,9 @@
 #define NRS_CASPER_CASPER_SEE_FORMULA_H
 
 #include "casper/term.h"
+#include "casper/see/ast.h"
+#include "casper/see/slot_table.h"
+#include "casper/see/model_cache.h"
 
 #include <string>
 #include <set>
@@ -41,6 +44,17 @@ namespace casper
             friend class See;
             friend class SumIfs;
 
+        public: // Kinds, the specialization written to the model cache
+
+            enum Kind
+            {
+                EFormula = 0,
+                ESum,
+                ESumIf,
+                ESumIfs,
+                EVlookup
+            };
+
         public: // data
 
             virtual bool   IsSum                 () const;
@@ -49,15 +63,21 @@ namespace casper
         protected: // methods
 
             virtual void   CalculateDependencies (See& a_see);
-            virtual double SumAllTerms           (SymbolTable& a_sym_tab, FILE* a_logfile);
-            virtual double SumIfAllTerms         (SymbolTable& a_symtab, SymbolTable& a_criterias, FILE* a_logfile);
-            virtual Term   VLOOKUP               (const Term& a_value, const char* const a_lookup_col, const Term& a_result_index, bool a_range_lookup);
-            std::string name_;         //!< Name of the variable that holds the formula result
-            std::string alias_;        //!< Alias of the formula name, i.e. the excel cell reference
-            StringSet   precedents_;   //!< List of variables the formala depends upon
-            std::string formula_;      //!< The expression to calculate
-            std::string description_;  //!< Human readable descripton of the formula
-            std::string type_;         //!<
+            virtual void   ResolveSlots          (SlotTable& a_slots);
+            virtual double SumAllTerms           (SlotTable& a_slots, FILE* a_logfile);
+            virtual double SumIfAllTerms         (SlotTable& a_slots, SymbolTable& a_criterias, FILE* a_logfile);
+            virtual Kind   GetKind               () const;
+            virtual void   Save                  (ModelCacheWriter& a_writer) const;
+                    void   Restore               (ModelCacheReader& a_reader);
+            std::string          name_;             //!< Name of the variable that holds the formula result
+            std::string          alias_;            //!< Alias of the formula name, i.e. the excel cell reference
+            StringSet            precedents_;       //!< List of variables the formala depends upon
+            std::string          formula_;          //!< The expression to calculate
+            std::string          description_;      //!< Human readable descripton of the formula
+            std::string          type_;             //!<
+            Ast                  ast_;              //!< The expression compiled at load time, see See::CompileFormulas
+            int32_t              slot_;             //!< Slot of the formula name, see #ResolveSlots
+            std::vector<int32_t> precedent_slots_;  //!< Slots of #precedents_ in the same order
 
 
             Formula ();
@@ -90,6 +110,10 @@ namespace casper
         {
             return false;
         }
+        inline Formula::Kind Formula::GetKind () const
+        {
+            return EFormula;
+        }
 
         inline const std::string& Formula::Name () const
         {
@@ -0,0 +1,172 @@
+/**
+ * @file lane_table.h declaration of the values of a batch calculation, one column per slot
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#ifndef NRS_CASPER_CASPER_SEE_LANE_TABLE_H
+#define NRS_CASPER_CASPER_SEE_LANE_TABLE_H
+
+#include "casper/term.h"
+
+#include <map>
+#include <unordered_map>
+#include <utility> // std::move
+#include <vector>
+
+namespace casper
+{
+    namespace see
+    {
+        /**
+         * @brief Values of one expression for every lane of a batch, stored as a struct of arrays
+         *
+         * A number or a boolean is described by the number and type of it's Term, these are kept in
+         * #numbers_ and #types_ so the operators can run over all lanes in plain loops. Lanes holding any
+         * other value, a text, a date or an error, keep the whole Term in #terms_.
+         */
+        struct LaneValues
+        {
+            std::vector<double>    numbers_;  //!< Number of each lane, NAN when the lane is in #terms_
+            std::vector<unsigned>  types_;    //!< Term type of each lane
+            std::map<size_t, Term> terms_;    //!< Lanes whose value is not a plain number or boolean
+
+            /**
+             * @brief Set the number of lanes, all values are undefined
+             */
+            void Resize (size_t a_lanes)
+            {
+                numbers_.assign(a_lanes, 0.0);
+                types_.assign(a_lanes, Term::EUndefined);
+                terms_.clear();
+            }
+
+            /**
+             * @return true if a Term of type @a a_type is only a number or a boolean
+             */
+            static bool IsPlain (unsigned a_type)
+            {
+                return Term::EUndefined != a_type && 0 == ( a_type & ~static_cast<unsigned>(Term::ENumber | Term::EBoolean) );
+            }
+        };
+
+        /**
+         * @brief Lane values of the slots that differ between the lanes of a batch
+         *
+         * The columns are added in calculation order, a slot without a column has the same value in every lane,
+         * the one held by the model's symbol table.
+         */
+        class LaneTable
+        {
+        protected: // Data
+
+            size_t                              lanes_;    //!< Number of lanes
+            std::vector<int32_t>                slots_;    //!< Slot of each column
+            std::vector<LaneValues>             columns_;  //!< Values of each column
+            std::unordered_map<int32_t, size_t> index_;    //!< Maps the slots to their columns
+
+        public: // Constructor(s) / Destructor
+
+            LaneTable (size_t a_lanes);
+            virtual ~LaneTable ();
+
+            LaneTable (const LaneTable& a_table) = delete;
+            LaneTable& operator = (const LaneTable& a_table) = delete;
+
+        public: // Method(s) / Function(s)
+
+            void              Add    (int32_t a_slot, LaneValues&& a_values);
+            const LaneValues* Find   (int32_t a_slot) const;
+            size_t            Lanes  () const;
+            size_t            Size   () const;
+            int32_t           Slot   (size_t a_column) const;
+            const LaneValues& Column (size_t a_column) const;
+
+        };
+
+        /**
+         * @brief Constructor
+         *
+         * @param a_lanes number of lanes of the batch
+         */
+        inline LaneTable::LaneTable (size_t a_lanes)
+        {
+            lanes_ = a_lanes;
+        }
+
+        /**
+         * @brief Destructor
+         */
+        inline LaneTable::~LaneTable ()
+        {
+            /* empty */
+        }
+
+        /**
+         * @brief Add the column of a slot, or replace it's values
+         *
+         * @note Columns returned by #Find are invalidated.
+         */
+        inline void LaneTable::Add (int32_t a_slot, LaneValues&& a_values)
+        {
+            const auto it = index_.find(a_slot);
+            if ( index_.end() != it ) {
+                columns_[it->second] = std::move(a_values);
+                return;
+            }
+            index_[a_slot] = columns_.size();
+            slots_.push_back(a_slot);
+            columns_.push_back(std::move(a_values));
+        }
+
+        /**
+         * @return the column of a slot, NULL when the slot has the same value in all lanes
+         */
+        inline const LaneValues* LaneTable::Find (int32_t a_slot) const
+        {
+            const auto it = index_.find(a_slot);
+            if ( index_.end() == it ) {
+                return nullptr;
+            }
+            return &columns_[it->second];
+        }
+
+        inline size_t LaneTable::Lanes () const
+        {
+            return lanes_;
+        }
+
+        inline size_t LaneTable::Size () const
+        {
+            return columns_.size();
+        }
+
+        inline int32_t LaneTable::Slot (size_t a_column) const
+        {
+            return slots_[a_column];
+        }
+
+        inline const LaneValues& LaneTable::Column (size_t a_column) const
+        {
+            return columns_[a_column];
+        }
+
+    } // namespace see
+} // namespace casper
+
+#endif // NRS_CASPER_CASPER_SEE_LANE_TABLE_H
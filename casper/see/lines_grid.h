@@ -0,0 +1,148 @@
+/**
+ * @file lines_grid.h declaration of the row and column index of the LINES table cells
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#ifndef NRS_CASPER_CASPER_SEE_LINES_GRID_H
+#define NRS_CASPER_CASPER_SEE_LINES_GRID_H
+
+#include "casper/term.h"
+#include "casper/see/slot_table.h"
+
+#include <vector>
+
+namespace casper
+{
+    namespace see
+    {
+        /**
+         * @brief Dense grid with the slots and literals of the LINES table cells
+         *
+         * Built once the slots are resolved, the cells are then read by row and column without making the
+         * cell reference or looking up the aliases. Rows and columns are the excel ones, base is 1.
+         */
+        class LinesGrid
+        {
+        public: // Data types
+
+            struct Cell
+            {
+                int32_t     ref_slot_;  //!< Slot of the cell reference, it's alias is the fallback
+                int32_t     slot_;      //!< Slot of the name the formulas use, the alias or the cell reference
+                const Term* value_;     //!< Literal loaded with the lines table, NULL when the cell has none
+            };
+
+        protected: // Data
+
+            int32_t           first_row_;  //!< Row of the first cell
+            int32_t           first_col_;  //!< Column of the first cell
+            int32_t           rows_;       //!< Number of rows
+            int32_t           cols_;       //!< Number of columns
+            std::vector<Cell> cells_;      //!< Cells, row by row
+
+        public: // Constructor(s) / Destructor
+
+            LinesGrid ();
+            virtual ~LinesGrid ();
+
+        public: // Method(s) / Function(s)
+
+            void        Reset   (int32_t a_first_row, int32_t a_rows, int32_t a_first_col, int32_t a_cols);
+            void        Clear   ();
+            Cell*       At      (int32_t a_row, int32_t a_col);
+            const Cell* At      (int32_t a_row, int32_t a_col) const;
+            const Term& Literal (int32_t a_row, int32_t a_col) const;
+
+        };
+
+        /**
+         * @brief Constructor
+         */
+        inline LinesGrid::LinesGrid ()
+        {
+            Clear();
+        }
+
+        /**
+         * @brief Destructor
+         */
+        inline LinesGrid::~LinesGrid ()
+        {
+            /* empty */
+        }
+
+        /**
+         * @brief Size the grid, all cells are without slots or literals
+         */
+        inline void LinesGrid::Reset (int32_t a_first_row, int32_t a_rows, int32_t a_first_col, int32_t a_cols)
+        {
+            const Cell empty = { SlotTable::k_invalid_slot_, SlotTable::k_invalid_slot_, nullptr };
+
+            first_row_ = a_first_row;
+            first_col_ = a_first_col;
+            rows_      = a_rows > 0 ? a_rows : 0;
+            cols_      = a_cols > 0 ? a_cols : 0;
+            cells_.assign(static_cast<size_t>(rows_) * static_cast<size_t>(cols_), empty);
+        }
+
+        inline void LinesGrid::Clear ()
+        {
+            first_row_ = 0;
+            first_col_ = 0;
+            rows_      = 0;
+            cols_      = 0;
+            cells_.clear();
+        }
+
+        /**
+         * @return the cell or NULL if it's outside the grid
+         */
+        inline LinesGrid::Cell* LinesGrid::At (int32_t a_row, int32_t a_col)
+        {
+            const uint32_t row = static_cast<uint32_t>(a_row - first_row_);
+            const uint32_t col = static_cast<uint32_t>(a_col - first_col_);
+            if ( row >= static_cast<uint32_t>(rows_) || col >= static_cast<uint32_t>(cols_) ) {
+                return nullptr;
+            }
+            return &cells_[static_cast<size_t>(row) * static_cast<size_t>(cols_) + col];
+        }
+
+        inline const LinesGrid::Cell* LinesGrid::At (int32_t a_row, int32_t a_col) const
+        {
+            return const_cast<LinesGrid*>(this)->At(a_row, a_col);
+        }
+
+        /**
+         * @return the literal of a cell, an undefined term when it has none
+         */
+        inline const Term& LinesGrid::Literal (int32_t a_row, int32_t a_col) const
+        {
+            static const Term undefined;
+
+            const Cell* cell = At(a_row, a_col);
+            if ( nullptr == cell || nullptr == cell->value_ ) {
+                return undefined;
+            }
+            return *cell->value_;
+        }
+
+    } // namespace see
+} // namespace casper
+
+#endif // NRS_CASPER_CASPER_SEE_LINES_GRID_H
@@ -0,0 +1,194 @@
+/**
+ * @file lines_index.cc Implementation of the search index of a LINES table column
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/lines_index.h"
+
+#include <algorithm> // std::upper_bound
+#include <cmath>     // std::isnan
+#include <string.h>
+
+/**
+ * @brief Build the exact and range indexes of the appended rows
+ *
+ * Same rules as Table::GetMatchIndex and Table::GetRangeIndex, only the texts are compared by content
+ * instead of by StringPool handle.
+ */
+void casper::see::LinesIndex::Build ()
+{
+    const uint32_t rows        = static_cast<uint32_t>(rows_.size());
+    bool           has_numbers = false;
+    bool           has_texts   = false;
+    double         number;
+
+    numbers_.clear();
+    converted_.clear();
+    texts_.clear();
+    max_numbers_.clear();
+    max_texts_.clear();
+
+    for ( uint32_t row = 0; row < rows; ++row ) {
+        const Term& value = rows_[row];
+        switch (value.type_) {
+
+            case casper::Term::ENumber:
+                if ( false == std::isnan(value.number_) ) {
+                    numbers_.insert(std::make_pair(value.number_, row));
+                    has_numbers = true;
+                }
+                break;
+
+            case casper::Term::EText:
+            {
+                const size_t hash  = std::hash<std::string>()(value.text_);
+                const auto   range = texts_.equal_range(hash);
+                bool         first = true;
+
+                for ( auto it = range.first; it != range.second && true == first; ++it ) {
+                    first = ( rows_[it->second].text_ != value.text_ );
+                }
+                if ( true == first ) {
+                    texts_.insert(std::make_pair(hash, row));
+                }
+                has_texts = true;
+            }
+                // fall through
+            case casper::Term::EBoolean:
+                if ( false == std::isnan( ( number = value.ToNumber() ) ) ) {
+                    converted_.insert(std::make_pair(number, row));
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if ( true == has_numbers ) {
+        double maximum = -INFINITY;
+
+        max_numbers_.resize(rows);
+        for ( uint32_t row = 0; row < rows; ++row ) {
+            if ( casper::Term::ENumber == rows_[row].type_ && rows_[row].number_ > maximum ) {
+                maximum = rows_[row].number_;
+            }
+            max_numbers_[row] = maximum;
+        }
+    }
+    if ( true == has_texts ) {
+        int32_t maximum = -1; // ... the empty string, nothing is lower ...
+
+        max_texts_.resize(rows);
+        for ( uint32_t row = 0; row < rows; ++row ) {
+            if ( casper::Term::EText == rows_[row].type_
+                && strcmp(rows_[row].text_.c_str(), -1 == maximum ? "" : rows_[maximum].text_.c_str()) > 0 ) {
+                maximum = static_cast<int32_t>(row);
+            }
+            max_texts_[row] = maximum;
+        }
+    }
+}
+
+/**
+ * @brief Find the row of an exact lookup, the first one that is Table::Equal to the value
+ *
+ * @return the row or -1 when no row matches
+ */
+int casper::see::LinesIndex::MatchRow (const casper::Term& a_value) const
+{
+    uint32_t best = UINT32_MAX;
+
+    // ... Table::Equal never matches other types ...
+    if ( casper::Term::ENumber != a_value.type_ && casper::Term::EText != a_value.type_ && casper::Term::EBoolean != a_value.type_ ) {
+        return -1;
+    }
+
+    auto first_row = [&best] (const std::unordered_map<double, uint32_t>& a_map, double a_key) {
+        if ( false == std::isnan(a_key) ) {
+            const auto it = a_map.find(a_key);
+            if ( a_map.end() != it && it->second < best ) {
+                best = it->second;
+            }
+        }
+    };
+
+    switch (a_value.type_) {
+
+        case casper::Term::ENumber:
+            first_row(numbers_, a_value.number_);
+            first_row(converted_, a_value.number_);
+            break;
+
+        case casper::Term::EText:
+        {
+            const auto range = texts_.equal_range(std::hash<std::string>()(a_value.text_));
+            for ( auto it = range.first; it != range.second; ++it ) {
+                if ( it->second < best && rows_[it->second].text_ == a_value.text_ ) {
+                    best = it->second;
+                }
+            }
+            first_row(numbers_, a_value.ToNumber());
+            break;
+        }
+
+        default: // EBoolean
+            first_row(numbers_, a_value.ToNumber());
+            break;
+    }
+
+    return ( UINT32_MAX == best ? -1 : static_cast<int>(best) );
+}
+
+/**
+ * @brief Find the row of a range lookup, the row before the first one greater than the value
+ *
+ * The first row is returned when it's already greater and the last row when none is greater.
+ */
+int casper::see::LinesIndex::RangeRow (const casper::Term& a_value) const
+{
+    const size_t rows = rows_.size();
+    size_t       first_greater;
+
+    if ( casper::Term::ENumber == a_value.type_ ) {
+        if ( 0 == max_numbers_.size() ) {
+            first_greater = rows;
+        } else {
+            first_greater = std::upper_bound(max_numbers_.begin(), max_numbers_.end(), a_value.number_) - max_numbers_.begin();
+        }
+    } else if ( casper::Term::EText == a_value.type_ ) {
+        if ( 0 == max_texts_.size() ) {
+            first_greater = rows;
+        } else {
+            const char* text = a_value.text_.c_str();
+            first_greater = std::upper_bound(max_texts_.begin(), max_texts_.end(), text,
+                                             [this] (const char* a_text, int32_t a_row) {
+                                                 return strcmp(a_text, -1 == a_row ? "" : rows_[a_row].text_.c_str()) < 0;
+                                             }) - max_texts_.begin();
+        }
+    } else {
+        // ... other types are never lower ...
+        first_greater = rows;
+    }
+
+    if ( 0 == first_greater ) {
+        return 0;
+    }
+    return static_cast<int>(first_greater - 1);
+}
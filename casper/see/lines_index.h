@@ -0,0 +1,115 @@
+/**
+ * @file lines_index.h declaration of the search index of a LINES table column
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#ifndef NRS_CASPER_CASPER_SEE_LINES_INDEX_H
+#define NRS_CASPER_CASPER_SEE_LINES_INDEX_H
+
+#include "casper/term.h"
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace casper
+{
+    namespace see
+    {
+        /**
+         * @brief Values of a LINES table search column calculated by one calculation, indexed for VLOOKUP
+         *
+         * The values are calculation results so they are kept as terms, owned by the evaluation context and
+         * never interned in the StringPool. The lookups give the same rows as Table::MatchRow and
+         * Table::RangeRow on a table column holding the same values.
+         */
+        class LinesIndex
+        {
+        protected: // Data
+
+            std::vector<Term>                         rows_;          //!< Values of the cloned lines, first clone first
+            std::unordered_map<double, uint32_t>      numbers_;       //!< First number row of each value
+            std::unordered_map<double, uint32_t>      converted_;     //!< First boolean or text row of each numeric conversion
+            std::unordered_multimap<size_t, uint32_t> texts_;         //!< First row of each distinct text by hash of the text
+            std::vector<double>                       max_numbers_;   //!< Maximum number up to each row, empty if there are no numbers
+            std::vector<int32_t>                      max_texts_;     //!< Row of the maximum text up to each row, -1 for the empty string
+
+        public: // Constructor(s) / Destructor
+
+            LinesIndex ();
+            virtual ~LinesIndex ();
+
+        public: // Method(s) / Function(s)
+
+            void Append    (const Term& a_value);
+            void Build     ();
+            int  LookupRow (const Term& a_value, bool a_range_lookup) const;
+
+        protected: // Method(s) / Function(s)
+
+            int  MatchRow  (const Term& a_value) const;
+            int  RangeRow  (const Term& a_value) const;
+
+        };
+
+        /**
+         * @brief Constructor
+         */
+        inline LinesIndex::LinesIndex ()
+        {
+            /* empty */
+        }
+
+        /**
+         * @brief Destructor
+         */
+        inline LinesIndex::~LinesIndex ()
+        {
+            /* empty */
+        }
+
+        /**
+         * @brief Add the value of the next row, #Build must be called after the last one
+         */
+        inline void LinesIndex::Append (const Term& a_value)
+        {
+            rows_.push_back(a_value);
+        }
+
+        /**
+         * @brief Row a VLOOKUP reads it's result from
+         *
+         * @return the row or -1 when no row matched
+         */
+        inline int LinesIndex::LookupRow (const Term& a_value, bool a_range_lookup) const
+        {
+            if ( false == a_range_lookup ) {
+                return MatchRow(a_value);
+            }
+            if ( 0 == rows_.size() ) {
+                return -1;
+            }
+            return RangeRow(a_value);
+        }
+
+    } // namespace see
+} // namespace casper
+
+#endif // NRS_CASPER_CASPER_SEE_LINES_INDEX_H
@@ -0,0 +1,193 @@
+/**
+ * @file lookup_cache.cc implementation of the memo of table lookup results
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/lookup_cache.h"
+
+#include <functional>
+#include <string.h>
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark ::: LookupCache::Key :::
+#pragma mark -
+#endif
+
+bool casper::see::LookupCache::Key::operator == (const casper::see::LookupCache::Key& a_key) const
+{
+    return table_      == a_key.table_
+        && version_    == a_key.version_
+        && search_col_ == a_key.search_col_
+        && result_col_ == a_key.result_col_
+        && kind_       == a_key.kind_
+        && type_       == a_key.type_
+        && number_     == a_key.number_
+        && text_       == a_key.text_;
+}
+
+size_t casper::see::LookupCache::KeyHash::operator () (const casper::see::LookupCache::Key& a_key) const
+{
+    size_t hash = std::hash<const void*>()(a_key.table_);
+
+    const auto combine = [&hash] (size_t a_value) {
+        hash ^= a_value + 0x9e3779b97f4a7c15ULL + ( hash << 6 ) + ( hash >> 2 );
+    };
+    combine(std::hash<uint64_t>()(a_key.version_));
+    combine(std::hash<uint64_t>()(( static_cast<uint64_t>(static_cast<uint32_t>(a_key.search_col_)) << 32 ) | static_cast<uint32_t>(a_key.result_col_)));
+    combine(std::hash<uint64_t>()(( static_cast<uint64_t>(a_key.kind_) << 32 ) | a_key.type_));
+    combine(std::hash<uint64_t>()(a_key.number_));
+    combine(std::hash<std::string>()(a_key.text_));
+    return hash;
+}
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark ::: LookupCache :::
+#pragma mark -
+#endif
+
+/**
+ * @brief Constructor, the LRU keeps 16384 results by default
+ */
+casper::see::LookupCache::LookupCache ()
+{
+    capacity_   = 16384;
+    generation_ = 0;
+    hits_       = 0;
+    misses_     = 0;
+}
+
+/**
+ * @brief Destructor
+ */
+casper::see::LookupCache::~LookupCache ()
+{
+    /* empty */
+}
+
+/**
+ * @brief Search the LRU, a hit becomes the most recently used entry
+ *
+ * @param a_key        lookup arguments
+ * @param a_generation current tables generation, older entries are dropped
+ * @param o_entry      receives the result
+ */
+bool casper::see::LookupCache::Find (const Key& a_key, uint64_t a_generation, Entry& o_entry)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if ( a_generation != generation_ ) {
+        list_.clear();
+        index_.clear();
+        generation_ = a_generation;
+        return false;
+    }
+    const auto it = index_.find(a_key);
+    if ( index_.end() == it ) {
+        return false;
+    }
+    list_.splice(list_.begin(), list_, it->second);
+    o_entry = it->second->second;
+    return true;
+}
+
+/**
+ * @brief Add a result, the least recently used entry is dropped when the LRU is full
+ */
+void casper::see::LookupCache::Insert (const Key& a_key, uint64_t a_generation, const Entry& a_entry)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if ( 0 == capacity_ ) {
+        return;
+    }
+    if ( a_generation != generation_ ) {
+        list_.clear();
+        index_.clear();
+        generation_ = a_generation;
+    }
+    const auto it = index_.find(a_key);
+    if ( index_.end() != it ) {
+        // ... another thread got here first ...
+        return;
+    }
+    list_.push_front(std::make_pair(a_key, a_entry));
+    index_[a_key] = list_.begin();
+    while ( list_.size() > capacity_ ) {
+        index_.erase(list_.back().first);
+        list_.pop_back();
+    }
+}
+
+/**
+ * @brief Drop all the entries
+ */
+void casper::see::LookupCache::Clear ()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    list_.clear();
+    index_.clear();
+}
+
+/**
+ * @brief Set the maximum number of entries of the LRU, 0 disables it
+ */
+void casper::see::LookupCache::SetCapacity (size_t a_capacity)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    capacity_ = a_capacity;
+    while ( list_.size() > capacity_ ) {
+        index_.erase(list_.back().first);
+        list_.pop_back();
+    }
+}
+
+/**
+ * @brief Build the key of a lookup
+ *
+ * The tables compare numbers and booleans by number and texts by text, values of other types never match,
+ * so the key only keeps what the comparison reads.
+ */
+void casper::see::LookupCache::MakeKey (const Table* a_table, uint64_t a_version, int a_search_col, int a_result_col,
+                                        Kind a_kind, const casper::Term& a_value, Key& o_key)
+{
+    o_key.table_      = a_table;
+    o_key.version_    = a_version;
+    o_key.search_col_ = a_search_col;
+    o_key.result_col_ = a_result_col;
+    o_key.kind_       = a_kind;
+    o_key.type_       = a_value.type_;
+    o_key.number_     = 0;
+    o_key.text_.clear();
+
+    switch ( a_value.type_ ) {
+        case casper::Term::ENumber:
+        case casper::Term::EBoolean:
+            memcpy(&o_key.number_, &a_value.number_, sizeof(a_value.number_));
+            break;
+        case casper::Term::EText:
+            o_key.text_ = a_value.text_;
+            break;
+        default:
+            break;
+    }
+}
@@ -0,0 +1,165 @@
+/**
+ * @file lookup_cache.h declaration of the memo of table lookup results
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#ifndef NRS_CASPER_CASPER_SEE_LOOKUP_CACHE_H
+#define NRS_CASPER_CASPER_SEE_LOOKUP_CACHE_H
+
+#include "casper/term.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+namespace casper
+{
+    namespace see
+    {
+        class Table;
+
+        /**
+         * @brief Bounded LRU of LOOKUP and VLOOKUP results shared by all the calculations of a model
+         *
+         * A key holds the table and it's version, so appended rows never return stale results, the whole
+         * cache is dropped when the generation of the tables of the model changes. Each evaluation context
+         * also keeps a #Scope with the results of the running calculation that is read without locking.
+         */
+        class LookupCache
+        {
+        public: // Data types
+
+            enum Kind : uint32_t
+            {
+                ELookup,
+                EVlookupExact,
+                EVlookupRange
+            };
+
+            /**
+             * @brief Lookup arguments, the value is reduced to the fields the table comparisons read
+             */
+            struct Key
+            {
+                const Table* table_;       //!< Searched table
+                uint64_t     version_;     //!< Table version, see Table::GetVersion
+                int32_t      search_col_;  //!< Search column index
+                int32_t      result_col_;  //!< Result column index, or the VLOOKUP column number
+                uint32_t     kind_;        //!< #Kind of lookup
+                uint32_t     type_;        //!< Term type of the searched value
+                uint64_t     number_;      //!< Bits of the number of a number or boolean value
+                std::string  text_;        //!< Text of a text value
+
+                bool operator == (const Key& a_key) const;
+            };
+
+            struct KeyHash
+            {
+                size_t operator () (const Key& a_key) const;
+            };
+
+            /**
+             * @brief Lookup result, a miss only sets the type and number of the result
+             */
+            struct Entry
+            {
+                Term result_;  //!< Value read from the table
+                bool found_;   //!< false when no row matched
+            };
+
+            typedef std::unordered_map<Key, Entry, KeyHash> Scope;
+
+        protected: // Data types
+
+            typedef std::list<std::pair<Key, Entry> > List;
+
+        protected: // Data
+
+            std::mutex                                       mutex_;       //!< Protects the LRU
+            size_t                                           capacity_;    //!< Maximum number of entries, 0 disables the LRU
+            uint64_t                                         generation_;  //!< Tables generation of the entries
+            List                                             list_;        //!< Entries, most recently used first
+            std::unordered_map<Key, List::iterator, KeyHash> index_;       //!< Entries by key
+            std::atomic<uint64_t>                            hits_;        //!< Lookups answered by a scope or the LRU
+            std::atomic<uint64_t>                            misses_;      //!< Lookups that searched the table
+
+        public: // Constructor(s) / Destructor
+
+            LookupCache ();
+            virtual ~LookupCache ();
+
+            LookupCache (const LookupCache& a_cache) = delete;
+            LookupCache& operator = (const LookupCache& a_cache) = delete;
+
+        public: // Method(s) / Function(s)
+
+            bool     Find          (const Key& a_key, uint64_t a_generation, Entry& o_entry);
+            void     Insert        (const Key& a_key, uint64_t a_generation, const Entry& a_entry);
+            void     Clear         ();
+            void     SetCapacity   (size_t a_capacity);
+            size_t   GetCapacity   () const;
+            void     Count         (bool a_hit);
+            uint64_t Hits          () const;
+            uint64_t Misses        () const;
+            void     ResetCounters ();
+
+        public: // Static Method(s) / Function(s)
+
+            static void MakeKey (const Table* a_table, uint64_t a_version, int a_search_col, int a_result_col,
+                                 Kind a_kind, const Term& a_value, Key& o_key);
+
+        };
+
+        inline size_t LookupCache::GetCapacity () const
+        {
+            return capacity_;
+        }
+
+        inline void LookupCache::Count (bool a_hit)
+        {
+            if ( true == a_hit ) {
+                hits_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                misses_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        inline uint64_t LookupCache::Hits () const
+        {
+            return hits_.load(std::memory_order_relaxed);
+        }
+
+        inline uint64_t LookupCache::Misses () const
+        {
+            return misses_.load(std::memory_order_relaxed);
+        }
+
+        inline void LookupCache::ResetCounters ()
+        {
+            hits_   = 0;
+            misses_ = 0;
+        }
+
+    } // namespace see
+} // namespace casper
+
+#endif // NRS_CASPER_CASPER_SEE_LOOKUP_CACHE_H
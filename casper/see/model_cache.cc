@@ -0,0 +1,387 @@
+/**
+ * @file model_cache.cc implementation of the binary file that caches a loaded model
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/model_cache.h"
+
+#include "osal/exception.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark ::: ModelCache :::
+#pragma mark -
+#endif
+
+/**
+ * @brief 64 bit FNV-1a hash, chain calls by passing the previous result as @a a_hash
+ */
+uint64_t casper::see::ModelCache::Hash (const void* a_data, size_t a_length, uint64_t a_hash)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(a_data);
+
+    for ( size_t idx = 0; idx < a_length; ++idx ) {
+        a_hash ^= bytes[idx];
+        a_hash *= 1099511628211ULL;
+    }
+    return a_hash;
+}
+
+/**
+ * @brief Hash a string including it's terminator, so that "a" + "bc" and "ab" + "c" differ
+ */
+uint64_t casper::see::ModelCache::Hash (const std::string& a_string, uint64_t a_hash)
+{
+    return Hash(a_string.c_str(), a_string.size() + 1, a_hash);
+}
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark ::: ModelCacheWriter :::
+#pragma mark -
+#endif
+
+/**
+ * @brief Constructor, writes the file header
+ *
+ * @param a_hash hash of the source model
+ */
+casper::see::ModelCacheWriter::ModelCacheWriter (uint64_t a_hash)
+{
+    Write(ModelCache::k_magic_);
+    Write(ModelCache::k_version_);
+    Write(a_hash);
+}
+
+/**
+ * @brief Destructor
+ */
+casper::see::ModelCacheWriter::~ModelCacheWriter ()
+{
+    /* empty */
+}
+
+void casper::see::ModelCacheWriter::Write (uint8_t a_value)
+{
+    buffer_.append(reinterpret_cast<const char*>(&a_value), sizeof(a_value));
+}
+
+void casper::see::ModelCacheWriter::Write (int32_t a_value)
+{
+    buffer_.append(reinterpret_cast<const char*>(&a_value), sizeof(a_value));
+}
+
+void casper::see::ModelCacheWriter::Write (uint32_t a_value)
+{
+    buffer_.append(reinterpret_cast<const char*>(&a_value), sizeof(a_value));
+}
+
+void casper::see::ModelCacheWriter::Write (uint64_t a_value)
+{
+    buffer_.append(reinterpret_cast<const char*>(&a_value), sizeof(a_value));
+}
+
+void casper::see::ModelCacheWriter::Write (double a_value)
+{
+    buffer_.append(reinterpret_cast<const char*>(&a_value), sizeof(a_value));
+}
+
+/**
+ * @brief Strings are written as a 32 bit length followed by the bytes
+ */
+void casper::see::ModelCacheWriter::Write (const std::string& a_value)
+{
+    Write(static_cast<uint32_t>(a_value.size()));
+    buffer_.append(a_value);
+}
+
+void casper::see::ModelCacheWriter::Write (const casper::Term& a_value)
+{
+    Write(static_cast<uint32_t>(a_value.type_));
+    Write(a_value.number_);
+    Write(a_value.text_);
+    Write(a_value.aux_text_);
+    Write(a_value.aux_condition_);
+}
+
+void casper::see::ModelCacheWriter::Write (const casper::StringSet& a_value)
+{
+    Write(static_cast<uint32_t>(a_value.size()));
+    for ( auto it = a_value.begin(); it != a_value.end(); ++it ) {
+        Write(*it);
+    }
+}
+
+void casper::see::ModelCacheWriter::Write (const casper::StringHash& a_value)
+{
+    Write(static_cast<uint32_t>(a_value.size()));
+    for ( auto it = a_value.begin(); it != a_value.end(); ++it ) {
+        Write(it->first);
+        Write(it->second);
+    }
+}
+
+void casper::see::ModelCacheWriter::Write (const casper::SymbolTable& a_value)
+{
+    Write(static_cast<uint32_t>(a_value.size()));
+    for ( auto it = a_value.begin(); it != a_value.end(); ++it ) {
+        Write(it->first);
+        Write(it->second);
+    }
+}
+
+void casper::see::ModelCacheWriter::Write (const std::vector<std::string>& a_value)
+{
+    Write(static_cast<uint32_t>(a_value.size()));
+    for ( auto it = a_value.begin(); it != a_value.end(); ++it ) {
+        Write(*it);
+    }
+}
+
+void casper::see::ModelCacheWriter::Write (const std::vector<std::vector<std::string> >& a_value)
+{
+    Write(static_cast<uint32_t>(a_value.size()));
+    for ( auto it = a_value.begin(); it != a_value.end(); ++it ) {
+        Write(*it);
+    }
+}
+
+/**
+ * @brief Write the buffer to a temporary file that is renamed over @a a_filename
+ *
+ * Concurrent readers either see the previous file or the complete new one.
+ */
+void casper::see::ModelCacheWriter::Save (const std::string& a_filename)
+{
+    const std::string tmp_filename = a_filename + ".tmp";
+
+    // ... the checksum of everything written so far closes the file ...
+    Write(ModelCache::Hash(buffer_.data(), buffer_.size()));
+
+    FILE* file = fopen(tmp_filename.c_str(), "wb");
+    if ( nullptr == file ) {
+        throw OSAL_EXCEPTION("Unable to create model cache file %s", tmp_filename.c_str());
+    }
+    const size_t written = fwrite(buffer_.data(), 1, buffer_.size(), file);
+    if ( 0 != fclose(file) || written != buffer_.size() ) {
+        unlink(tmp_filename.c_str());
+        throw OSAL_EXCEPTION("Unable to write model cache file %s", tmp_filename.c_str());
+    }
+    if ( 0 != rename(tmp_filename.c_str(), a_filename.c_str()) ) {
+        unlink(tmp_filename.c_str());
+        throw OSAL_EXCEPTION("Unable to rename model cache file to %s", a_filename.c_str());
+    }
+}
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark ::: ModelCacheReader :::
+#pragma mark -
+#endif
+
+/**
+ * @brief Constructor
+ */
+casper::see::ModelCacheReader::ModelCacheReader ()
+{
+    data_   = nullptr;
+    mapped_ = 0;
+    length_ = 0;
+    offset_ = 0;
+}
+
+/**
+ * @brief Destructor, unmaps the file
+ */
+casper::see::ModelCacheReader::~ModelCacheReader ()
+{
+    Close();
+}
+
+/**
+ * @brief Map a cache file and check it's checksum and header
+ *
+ * @param a_filename cache file
+ * @param a_hash     hash of the source model
+ *
+ * @return false if the file does not exist or was written by another version or for another model
+ */
+bool casper::see::ModelCacheReader::Open (const std::string& a_filename, uint64_t a_hash)
+{
+    struct stat info;
+
+    Close();
+
+    const int fd = open(a_filename.c_str(), O_RDONLY);
+    if ( -1 == fd ) {
+        return false;
+    }
+    if ( 0 != fstat(fd, &info) || info.st_size < static_cast<off_t>(2 * sizeof(uint32_t) + 2 * sizeof(uint64_t)) ) {
+        close(fd);
+        return false;
+    }
+    void* data = mmap(NULL, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if ( MAP_FAILED == data ) {
+        return false;
+    }
+    data_   = static_cast<const uint8_t*>(data);
+    mapped_ = static_cast<size_t>(info.st_size);
+    length_ = mapped_;
+    offset_ = mapped_ - sizeof(uint64_t);
+
+    // ... the checksum is not part of the data, #AtEnd stops before it ...
+    const uint64_t checksum = ReadUInt64();
+    length_ = mapped_ - sizeof(uint64_t);
+    offset_ = 0;
+    if ( ModelCache::Hash(data_, length_) != checksum ) {
+        Close();
+        return false;
+    }
+
+    if ( ModelCache::k_magic_ != ReadUInt32() || ModelCache::k_version_ != ReadUInt32() || a_hash != ReadUInt64() ) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Unmap the file
+ */
+void casper::see::ModelCacheReader::Close ()
+{
+    if ( nullptr != data_ ) {
+        munmap(const_cast<uint8_t*>(data_), mapped_);
+        data_ = nullptr;
+    }
+    mapped_ = 0;
+    length_ = 0;
+    offset_ = 0;
+}
+
+/**
+ * @return pointer to the next @a a_length bytes
+ */
+const uint8_t* casper::see::ModelCacheReader::Consume (size_t a_length)
+{
+    if ( a_length > length_ - offset_ ) {
+        throw OSAL_EXCEPTION("Model cache file is truncated, %zu bytes required at offset %zu", a_length, offset_);
+    }
+    const uint8_t* bytes = data_ + offset_;
+    offset_ += a_length;
+    return bytes;
+}
+
+uint8_t casper::see::ModelCacheReader::ReadUInt8 ()
+{
+    return *Consume(sizeof(uint8_t));
+}
+
+int32_t casper::see::ModelCacheReader::ReadInt32 ()
+{
+    int32_t value;
+    memcpy(&value, Consume(sizeof(value)), sizeof(value));
+    return value;
+}
+
+uint32_t casper::see::ModelCacheReader::ReadUInt32 ()
+{
+    uint32_t value;
+    memcpy(&value, Consume(sizeof(value)), sizeof(value));
+    return value;
+}
+
+uint64_t casper::see::ModelCacheReader::ReadUInt64 ()
+{
+    uint64_t value;
+    memcpy(&value, Consume(sizeof(value)), sizeof(value));
+    return value;
+}
+
+double casper::see::ModelCacheReader::ReadDouble ()
+{
+    double value;
+    memcpy(&value, Consume(sizeof(value)), sizeof(value));
+    return value;
+}
+
+std::string casper::see::ModelCacheReader::ReadString ()
+{
+    const uint32_t length = ReadUInt32();
+    return std::string(reinterpret_cast<const char*>(Consume(length)), length);
+}
+
+void casper::see::ModelCacheReader::Read (casper::Term& o_value)
+{
+    o_value.type_          = ReadUInt32();
+    o_value.number_        = ReadDouble();
+    o_value.text_          = ReadString();
+    o_value.aux_text_      = ReadString();
+    o_value.aux_condition_ = ReadString();
+}
+
+void casper::see::ModelCacheReader::Read (casper::StringSet& o_value)
+{
+    o_value.clear();
+    for ( uint32_t count = ReadUInt32(); count > 0; --count ) {
+        o_value.insert(o_value.end(), ReadString());
+    }
+}
+
+void casper::see::ModelCacheReader::Read (casper::StringHash& o_value)
+{
+    o_value.clear();
+    for ( uint32_t count = ReadUInt32(); count > 0; --count ) {
+        std::string key = ReadString();
+        o_value.insert(o_value.end(), std::make_pair(key, ReadString()));
+    }
+}
+
+void casper::see::ModelCacheReader::Read (casper::SymbolTable& o_value)
+{
+    o_value.clear();
+    for ( uint32_t count = ReadUInt32(); count > 0; --count ) {
+        std::string key = ReadString();
+        Read(o_value[key]);
+    }
+}
+
+void casper::see::ModelCacheReader::Read (std::vector<std::string>& o_value)
+{
+    o_value.resize(ReadUInt32());
+    for ( auto it = o_value.begin(); it != o_value.end(); ++it ) {
+        *it = ReadString();
+    }
+}
+
+void casper::see::ModelCacheReader::Read (std::vector<std::vector<std::string> >& o_value)
+{
+    o_value.resize(ReadUInt32());
+    for ( auto it = o_value.begin(); it != o_value.end(); ++it ) {
+        Read(*it);
+    }
+}
@@ -0,0 +1,143 @@
+/**
+ * @file model_cache.h declaration of the binary file that caches a loaded model
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#ifndef NRS_CASPER_CASPER_SEE_MODEL_CACHE_H
+#define NRS_CASPER_CASPER_SEE_MODEL_CACHE_H
+
+#include "casper/term.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace casper
+{
+    namespace see
+    {
+        /**
+         * @brief Layout of the cache file, bump #k_version_ whenever the written data changes
+         *
+         * The file starts with #k_magic_, #k_version_ and the hash of the source model, a file with other
+         * values is ignored and rebuilt. It ends with the hash of all the bytes before it, a truncated or
+         * corrupted file is ignored as well. All numbers are written in the byte order of the host.
+         */
+        class ModelCache
+        {
+        public: // Constants
+
+            static const uint32_t k_magic_   = 0x43455353; // "SSEC"
+            static const uint32_t k_version_ = 2;
+
+        public: // Static Method(s) / Function(s)
+
+            static uint64_t Hash (const void* a_data, size_t a_length, uint64_t a_hash = 14695981039346656037ULL);
+            static uint64_t Hash (const std::string& a_string, uint64_t a_hash);
+
+        };
+
+        /**
+         * @brief Serializes the loaded model to a memory buffer that is saved in one go
+         */
+        class ModelCacheWriter
+        {
+        protected: // Data
+
+            std::string buffer_; //!< Bytes written so far
+
+        public: // Constructor(s) / Destructor
+
+            ModelCacheWriter (uint64_t a_hash);
+            virtual ~ModelCacheWriter ();
+
+        public: // Method(s) / Function(s)
+
+            void Write (uint8_t a_value);
+            void Write (int32_t a_value);
+            void Write (uint32_t a_value);
+            void Write (uint64_t a_value);
+            void Write (double a_value);
+            void Write (const std::string& a_value);
+            void Write (const Term& a_value);
+            void Write (const StringSet& a_value);
+            void Write (const StringHash& a_value);
+            void Write (const SymbolTable& a_value);
+            void Write (const std::vector<std::string>& a_value);
+            void Write (const std::vector<std::vector<std::string> >& a_value);
+            void Save  (const std::string& a_filename);
+
+        };
+
+        /**
+         * @brief Reads a cache file mapped in memory, reading past the end throws
+         */
+        class ModelCacheReader
+        {
+        protected: // Data
+
+            const uint8_t* data_;    //!< Start of the mapped file
+            size_t         mapped_;  //!< Size of the mapped file
+            size_t         length_;  //!< Size of the data, the file without it's checksum
+            size_t         offset_;  //!< Next byte to read
+
+        public: // Constructor(s) / Destructor
+
+            ModelCacheReader ();
+            virtual ~ModelCacheReader ();
+
+            ModelCacheReader (const ModelCacheReader& a_reader) = delete;
+            ModelCacheReader& operator = (const ModelCacheReader& a_reader) = delete;
+
+        public: // Method(s) / Function(s)
+
+            bool        Open            (const std::string& a_filename, uint64_t a_hash);
+            void        Close           ();
+            uint8_t     ReadUInt8       ();
+            int32_t     ReadInt32       ();
+            uint32_t    ReadUInt32      ();
+            uint64_t    ReadUInt64      ();
+            double      ReadDouble      ();
+            std::string ReadString      ();
+            void        Read            (Term& o_value);
+            void        Read            (StringSet& o_value);
+            void        Read            (StringHash& o_value);
+            void        Read            (SymbolTable& o_value);
+            void        Read            (std::vector<std::string>& o_value);
+            void        Read            (std::vector<std::vector<std::string> >& o_value);
+            bool        AtEnd           () const;
+
+        protected: // Method(s) / Function(s)
+
+            const uint8_t* Consume      (size_t a_length);
+
+        };
+
+        /**
+         * @return true when all the bytes of the file were read
+         */
+        inline bool ModelCacheReader::AtEnd () const
+        {
+            return offset_ == length_;
+        }
+
+    } // namespace see
+} // namespace casper
+
+#endif // NRS_CASPER_CASPER_SEE_MODEL_CACHE_H
@@ -9,20 +9,22 @@
   namespace casper {
       namespace see {
           class Scanner;
-          class See;
       }
   }
   #include <cmath> 
   #include <iostream>
   #include "casper/term.h"
+  #include "casper/see/ast.h"
   #include "casper/see/sum.h"
 }
 
-%parse-param { casper::see::Scanner& a_scanner} { casper::see::See& see_}
+%parse-param { casper::see::Scanner& a_scanner} { casper::see::Ast& ast_}
 
 %code {
-  #include "casper/see/see.h"
+  #include "casper/see/see_scanner.h"
+  #include "osal/exception.h"
   #define yylex a_scanner.Scan
+  #define AST(a_type) casper::see::AstNode::a_type
 }
 
 %token END           0
@@ -82,136 +84,131 @@
  * The grammar follows
  */
 %%
+    /*
+     * The actions only build the expression tree, terminals are captured in the nodes and rules
+     * made only of terminals are folded into constants. See::Evaluate replays the calculations.
+     */
     input:
-        VAR  '=' term END                                     { $$ = $3; see_.SetVariable($1, $$, @1); see_.result_ = $$;   }
-      | term  END                                             { $$ = $1; see_.result_ = $$;                                 }
+        VAR  '=' term END                                     { ast_.root_ = ast_.Reduce(AST(TAssign), 1, $1, @1); ast_.name_ = $1.text_; }
+      | term  END                                             { ast_.root_ = ast_.Reduce(AST(TExpression), 1);                       }
 
     criteria:
-            vector_ref ',' term
-            {
-                see_.sum_criterias_[$$.aux_text_] = $3;
-            }
-
-        |  vector_ref ',' vector_ref
-            {
-               see_.sum_criterias_[$$.aux_text_] = $3;
-            }
+            vector_ref ',' term                                 { ast_.Reduce(AST(TCriteria), 2);                           }
+        |   vector_ref ',' vector_ref                           { ast_.Reduce(AST(TCriteria), 2);                           }
         ;
 
-    criteria_list: criteria | criteria_list ',' criteria;
+    criteria_list: criteria | criteria_list ',' criteria        { ast_.Reduce(AST(TCriteriaList), 2);                       }
 
     term:
-        VAR                                                     { see_.GetVariable($$, $1, @1);                             }
+        VAR                                                     { ast_.Reduce(AST(TVariable), 0, $1, @1);                   }
       | VLOOKUP '(' term ',' vector_ref ',' term ')'            {
-                                                                    see_.Vlookup($$, $3, $5, $7, false,
+                                                                    ast_.Reduce(AST(TVlookup), 3, $1, @1)->text_.assign(
                                                                                  a_scanner.GetInput() + @1.begin.column, @8.begin.column - @1.begin.column);
                                                                 }
       | VLOOKUP '(' term ',' vector_ref ',' term ',' term ')'   {
-                                                                    see_.Vlookup($$, $3, $5, $7, $9.ConvertToNumber() != 0,
+                                                                    ast_.Reduce(AST(TVlookupRange), 4, $1, @1)->text_.assign(
                                                                                  a_scanner.GetInput() + @1.begin.column, @8.begin.column - @1.begin.column);
                                                                 }
-      | LOOKUP '(' term ',' vector_ref ',' vector_ref ')'       { see_.Lookup($$, $3, $5, $7);                              }
-      | SUM         '(' vector_ref ')'                          { see_.Sum($$, $3);                                         }
-      | SUM         '(' VAR ':' VAR ')'                         { see_.Sum($$, $3, $5);                                     }
+      | LOOKUP '(' term ',' vector_ref ',' vector_ref ')'       { ast_.Reduce(AST(TLookup), 3, $1, @1);                     }
+      | SUM         '(' vector_ref ')'                          { ast_.Reduce(AST(TSumVector), 1, $1, @1);                  }
+      | SUM         '(' VAR ':' VAR ')'                         {
+                                                                    AstNode* node = ast_.Reduce(AST(TSumRange), 0, $1, @1);
+                                                                    node->tokens_.push_back($3);
+                                                                    node->tokens_.push_back($5);
+                                                                }
       | SUMIF       '(' vector_ref ',' sum_if_criteria ')'                             {
-                                                                                            see_.SumIf($$, $3, $5,
+                                                                                            ast_.Reduce(AST(TSumIf), 2, $1, @1)->text_.assign(
                                                                                                        a_scanner.GetInput() + @1.begin.column, @6.begin.column - @1.begin.column);
                                                                                        }
 //      | SUMIF       '(' vector_ref ',' sum_if_criteria ',' vector_ref ')'              {
 //                                                                                            see_.SumIf($$, $3, $5, $7,
 //                                                                                                        a_scanner.GetInput() + @1.begin.column, @8.begin.column - @1.begin.column);
 //                                                                                        }
-      | SUMIFS      '(' vector_ref ',' criteria_list ')'        { see_.SumIfs($$, $3);                                      }
-      | TEXTLITERAL                                             { $$.SetString($1);                                         }
-      | NUM                                                     { $$ = $1;                                                  }
-      | TK_TRUE                                                 { $$.BooleanTrue();                                         }
-      | TK_FALSE                                                { $$.BooleanFalse();                                        }
-      | MAX         '(' max_list ')'                            { $$ = $3;                                                  }
-      | MIN         '(' min_list ')'                            { $$ = $3;                                                  }
-      | CONCATENATE '(' concatenate_list ')'                    { $$ = $3;                                                  }
-      | ROUND       '(' term ',' term ')'                       { $$.Round($3, $5);                                         }
-      | ROUNDUP     '(' term ',' term ')'                       { $$.RoundUp($3, $5);                                       }
-      | ROUNDDOWN   '(' term ',' term ')'                       { $$.RoundDown($3, $5);                                     }
-      | IF          '(' term ',' term ',' term ')'              { $$.If($3, $5, $7);                                        }
-      | IF          '(' term ',' term ')'                       { $$.If($3, $5);                                            }
-      | IF          '(' term ')'                                { $$.If($3);                                                }
-      | DATE        '(' term ',' term ',' term ')'              { $$.SetExcelDate($3, $5, $7);                              }
-      | YEAR        '(' term ')'                                { $$.ExcelYear($3);                                         }
-      | MONTH       '(' term ')'                                { $$.ExcelMonth($3);                                        }
-      | DAY         '(' term ')'                                { $$.ExcelDay($3);                                          }
-      | HOUR        '(' term ')'                                { $$.ExcelHour($3);                                         }
-      | MINUTE      '(' term ')'                                { $$.ExcelMinute($3);                                       }
-      | SECOND      '(' term ')'                                { $$.ExcelSecond($3);                                       }
-      | DATEVALUE   '(' term ')'                                { $$.ExcelDateValue($3);                                    }
-      | EXCEL_DATE  '(' term ')'                                { $$.ExcelDateValue($3);                                    }
-      | ABS         '(' term  ')'                               { $$.Absolute($3);                                          }
-      | INDIRECT    '(' term ')'                                { $$ = $3;                                                  }
-      | ISERROR     '(' term ')'                                { $$.IsError($3);                                           }
-      | IFERROR     '(' term ',' term ')'                       { $$.IfError($3, $5);                                       }
-      | FIND        '(' term ',' term ',' term ')'              { $$.Find($3, $5, $7);                                      }
-      | FIND        '(' term ',' term ')'                       { $$.Find($3, $5);                                          }
-      | AND         '(' and_list ')'                            { $$ = $3;                                                  }
-      | OR          '(' or_list ')'                             { $$ = $3;                                                  }
-      | LEFT        '(' term ',' term ')'                       { $$.Left($3,$5);                                           }
-      | RIGHT       '(' term ',' term ')'                       { $$.Right($3,$5);                                          }
-      | MID         '(' term ',' term ',' term ')'              { $$.Mid($3,$5,$7);                                         }
-      | MATCH       '(' term ',' VAR TABLE_HEADERS ',' term ')' { see_.TableHeaderMatch($$,$3,$5);                          }
-      | OFFSET      '(' table_cell_ref_for_offset ',' term ',' term ')'    { see_.Offset($$,$3,$5,$7);                                 }
-      | term '+' term                                           { $$.Add($1,$3);                                            }
-      | term '-' term                                           { $$.Subtract($1,$3);                                       }
-      | term '*' term                                           { $$.Multiply($1,$3);                                       }
-      | term '/' term                                           { $$.Divide($1,$3);                                         }
-      | '-' term  %prec NEG                                     { $$.UnaryMinus($2);                                        }
-      | '+' term  %prec NEG                                     { $$ = $2;                                                  }
-      | term '^' term                                           { $$.Pow($1,$3);                                            }
-      | term '%'                                                { $$ = $1.Percentage();                                     }
-      | '(' term ')'                                            { $$ = $2;                                                  }
-      | term '=' term                                           { $$.Equal($1,$3);                                          }
-      | term '&' term                                           { $$.Concatenate($1, $3);                                   }
-      | term '>' term                                           { $$.Greater($1, $3);                                       }
-      | term '<' term                                           { $$.Less($1, $3);                                          }
-      | term GE  term                                           { $$.GreaterOrEqual($1, $3);                                }
-      | term LE  term                                           { $$.LessOrEqual($1, $3);                                   }
-      | term NE  term                                           { $$.NotEqual($1,$3);                                       }
+      | SUMIFS      '(' vector_ref ',' criteria_list ')'        { ast_.Reduce(AST(TSumIfs), 2, $1, @1);                     }
+      | TEXTLITERAL                                             { $$.SetString($1); ast_.Leaf($$, @1);                      }
+      | NUM                                                     { $$ = $1; ast_.Leaf($$, @1);                               }
+      | TK_TRUE                                                 { $$.BooleanTrue(); ast_.Leaf($$, @1);                      }
+      | TK_FALSE                                                { $$.BooleanFalse(); ast_.Leaf($$, @1);                     }
+      | MAX         '(' max_list ')'
+      | MIN         '(' min_list ')'
+      | CONCATENATE '(' concatenate_list ')'
+      | ROUND       '(' term ',' term ')'                       { ast_.Reduce(AST(TRound), 2, $1, @1);                      }
+      | ROUNDUP     '(' term ',' term ')'                       { ast_.Reduce(AST(TRoundUp), 2, $1, @1);                    }
+      | ROUNDDOWN   '(' term ',' term ')'                       { ast_.Reduce(AST(TRoundDown), 2, $1, @1);                  }
+      | IF          '(' term ',' term ',' term ')'              { ast_.Reduce(AST(TIf), 3, $1, @1);                         }
+      | IF          '(' term ',' term ')'                       { ast_.Reduce(AST(TIfTrue), 2, $1, @1);                     }
+      | IF          '(' term ')'                                { ast_.Reduce(AST(TIfCondition), 1, $1, @1);                }
+      | DATE        '(' term ',' term ',' term ')'              { ast_.Reduce(AST(TDate), 3, $1, @1);                       }
+      | YEAR        '(' term ')'                                { ast_.Reduce(AST(TYear), 1, $1, @1);                       }
+      | MONTH       '(' term ')'                                { ast_.Reduce(AST(TMonth), 1, $1, @1);                      }
+      | DAY         '(' term ')'                                { ast_.Reduce(AST(TDay), 1, $1, @1);                        }
+      | HOUR        '(' term ')'                                { ast_.Reduce(AST(THour), 1, $1, @1);                       }
+      | MINUTE      '(' term ')'                                { ast_.Reduce(AST(TMinute), 1, $1, @1);                     }
+      | SECOND      '(' term ')'                                { ast_.Reduce(AST(TSecond), 1, $1, @1);                     }
+      | DATEVALUE   '(' term ')'                                { ast_.Reduce(AST(TDateValue), 1, $1, @1);                  }
+      | EXCEL_DATE  '(' term ')'                                { ast_.Reduce(AST(TDateValue), 1, $1, @1);                  }
+      | ABS         '(' term  ')'                               { ast_.Reduce(AST(TAbs), 1, $1, @1);                        }
+      | INDIRECT    '(' term ')'
+      | ISERROR     '(' term ')'                                { ast_.Reduce(AST(TIsError), 1, $1, @1);                    }
+      | IFERROR     '(' term ',' term ')'                       { ast_.Reduce(AST(TIfError), 2, $1, @1);                    }
+      | FIND        '(' term ',' term ',' term ')'              { ast_.Reduce(AST(TFindFrom), 3, $1, @1);                   }
+      | FIND        '(' term ',' term ')'                       { ast_.Reduce(AST(TFind), 2, $1, @1);                       }
+      | AND         '(' and_list ')'
+      | OR          '(' or_list ')'
+      | LEFT        '(' term ',' term ')'                       { ast_.Reduce(AST(TLeft), 2, $1, @1);                       }
+      | RIGHT       '(' term ',' term ')'                       { ast_.Reduce(AST(TRight), 2, $1, @1);                      }
+      | MID         '(' term ',' term ',' term ')'              { ast_.Reduce(AST(TMid), 3, $1, @1);                        }
+      | MATCH       '(' term ',' VAR TABLE_HEADERS ',' term ')' { ast_.Reduce(AST(TMatch), 2, $1, @1)->tokens_.push_back($5); }
+      | OFFSET      '(' table_cell_ref_for_offset ',' term ',' term ')'    { ast_.Reduce(AST(TOffset), 3, $1, @1);          }
+      | term '+' term                                           { ast_.Reduce(AST(TAdd), 2);                                }
+      | term '-' term                                           { ast_.Reduce(AST(TSubtract), 2);                           }
+      | term '*' term                                           { ast_.Reduce(AST(TMultiply), 2);                           }
+      | term '/' term                                           { ast_.Reduce(AST(TDivide), 2);                             }
+      | '-' term  %prec NEG                                     { ast_.Reduce(AST(TUnaryMinus), 1, $1, @1);                 }
+      | '+' term  %prec NEG
+      | term '^' term                                           { ast_.Reduce(AST(TPow), 2);                                }
+      | term '%'                                                { ast_.Reduce(AST(TPercentage), 1);                         }
+      | '(' term ')'
+      | term '=' term                                           { ast_.Reduce(AST(TEqual), 2);                              }
+      | term '&' term                                           { ast_.Reduce(AST(TConcatenate), 2);                        }
+      | term '>' term                                           { ast_.Reduce(AST(TGreater), 2);                            }
+      | term '<' term                                           { ast_.Reduce(AST(TLess), 2);                               }
+      | term GE  term                                           { ast_.Reduce(AST(TGreaterOrEqual), 2);                     }
+      | term LE  term                                           { ast_.Reduce(AST(TLessOrEqual), 2);                        }
+      | term NE  term                                           { ast_.Reduce(AST(TNotEqual), 2);                           }
       | table_cell_ref
 
-    min_list: term                                              { $$ = $1;                                                  }
-            | min_list ',' term                                 { $$.Minimum($1, $3);                                       }
+    min_list: term
+            | min_list ',' term                                 { ast_.Reduce(AST(TMinList), 2);                            }
 
-    max_list: term                                              { $$ = $1;                                                  }
-            | max_list ',' term                                 { $$.Maximum($1, $3);                                       }
+    max_list: term
+            | max_list ',' term                                 { ast_.Reduce(AST(TMaxList), 2);                            }
 
-    and_list: term                                              { $$ = $1;                                                  }
-            | and_list ',' term                                 { $$.And($1, $3);                                           }
+    and_list: term
+            | and_list ',' term                                 { ast_.Reduce(AST(TAndList), 2);                            }
 
     or_list: term
-           | or_list  ',' term                                  { $$.Or($1, $3);                                            }
+           | or_list  ',' term                                  { ast_.Reduce(AST(TOrList), 2);                             }
 
     concatenate_list: term
-                    | concatenate_list ',' term                 { $$.Concatenate($1, $3);                                   }
+                    | concatenate_list ',' term                 { ast_.Reduce(AST(TConcatenateList), 2);                    }
 
     vector_ref:
         table_cell_ref
-      | VAR '[' VAR ']'                                         { $$ = $1; $$.aux_text_ = $3.text_;                         }
-      | VAR '[' ']'                                             { $$ = $1; $$.aux_text_ = "";                               }
-      | VAR                                                     { $$ = $1; $$.aux_text_ = "";                               }
-      | INDIRECT '(' term ')'                                   { $$ = $3; $$.aux_text_ = "";                               }
+      | VAR '[' VAR ']'                                         { $$ = $1; $$.aux_text_ = $3.text_; ast_.Leaf($$, @1);      }
+      | VAR '[' ']'                                             { $$ = $1; $$.aux_text_ = ""; ast_.Leaf($$, @1);            }
+      | VAR                                                     { $$ = $1; $$.aux_text_ = ""; ast_.Leaf($$, @1);            }
+      | INDIRECT '(' term ')'                                   { ast_.Reduce(AST(TVectorIndirect), 1, $1, @1);             }
 
     sum_if_criteria:
-         TEXTLITERAL '&' table_cell_ref                         { $$ = $3; $$.aux_condition_ = $1.text_;                       }
-       | TEXTLITERAL '&' VAR '[' VAR ']'                        { $$ = $3; $$.aux_condition_ = $2.text_; $$.aux_text_ = $5.text_; }
+         TEXTLITERAL '&' table_cell_ref                         { ast_.Reduce(AST(TSumIfCriteria), 1, $1, @1)->text_ = $1.text_; }
+       | TEXTLITERAL '&' VAR '[' VAR ']'                        { $$ = $3; $$.aux_condition_ = $1.text_; $$.aux_text_ = $5.text_; ast_.Leaf($$, @1); }
 
     table_cell_ref:
-        VAR '[' THIS_ROW ',' '[' VAR ']' ']'                    { see_.GetLinesTableValue($$, $6); $$.aux_text_ = $6.text_; }
+        VAR '[' THIS_ROW ',' '[' VAR ']' ']'                    { ast_.Reduce(AST(TTableCellRef), 0, $1, @1)->tokens_.push_back($6); }
 
     table_cell_ref_for_offset:
-        VAR '[' THIS_ROW ',' '[' VAR ']' ']'                    {
-                                                                    const bool for_dependencies_check = see_.check_dependencies_;
-                                                                    see_.check_dependencies_ = false;
-                                                                    see_.GetLinesTableValue($$, $6);
-                                                                    see_.check_dependencies_ = for_dependencies_check;
-                                                                    $$.aux_text_ = $6.text_;
-                                                                }
+        VAR '[' THIS_ROW ',' '[' VAR ']' ']'                    { ast_.Reduce(AST(TTableCellRefForOffset), 0, $1, @1)->tokens_.push_back($6); }
 
 %%
 
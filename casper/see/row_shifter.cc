@@ -32,6 +32,7 @@ casper::see::RowShifter::RowShifter ()
     buffer_size_      = 0;
     clone_suffix_     = -1;
     grab_definitions_ = false;
+    short_circuit_    = false; // all branches must be visited to patch every cell reference
 }
 
 /**
@@ -56,9 +57,11 @@ casper::see::RowShifter::~RowShifter ()
  */
 void casper::see::RowShifter::GrabVariableDefinitions (const char* a_formula)
 {
+    Ast ast;
+
     grab_definitions_ = true;
-    scanner_.SetInput(a_formula, strlen(a_formula));
-    parser_.parse();
+    Compile(a_formula, strlen(a_formula), ast);
+    Execute(ast);
     grab_definitions_ = false;
 }
 
@@ -95,12 +98,13 @@ void casper::see::RowShifter::ParseSuffix (const char* a_clone_name)
 const char* casper::see::RowShifter::ShiftFormula (const char* a_formula, int a_row_shift)
 {
     size_t len = strlen(a_formula);
+    Ast    ast;
     
     patches_.clear();
     grab_definitions_ = false;
     row_shift_ = a_row_shift;
-    scanner_.SetInput(a_formula, len);
-    parser_.parse();
+    Compile(a_formula, len, ast);
+    Execute(ast);
     
     /*
      * Sort patches and account for the space diference for patched formula
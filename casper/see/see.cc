@@ -25,7 +25,9 @@
 #include "casper/see/sum_if.h"
 #include "casper/see/row_shifter.h"
 #include "casper/see/table.h"
+#include "casper/see/table_parser.h"
 #include "casper/see/vlookup.h"
+#include "casper/see/model_cache.h"
 
 #include "lemon/topology_sort.h"
 #include "osal/utils/tmp_json_parser.h"
@@ -33,8 +35,16 @@
 #include "osal/osal_date.h"
 #include "osal/debug_trace.h"
 #include <algorithm>
+#include <climits>
 #include <sstream>
 #include <strings.h>
+#include <unordered_map>
+
+// ... the standard containers take it by reference, C++11 needs a namespace scope definition ...
+const int32_t casper::see::SlotTable::k_invalid_slot_;
+
+thread_local casper::see::See*         casper::see::See::tls_owner_   = nullptr;
+thread_local casper::see::EvalContext* casper::see::See::tls_context_ = nullptr;
 
 #ifdef __APPLE__
 #pragma mark -
@@ -46,9 +56,8 @@
  * @brief Constructor
  */
 casper::see::See::See ()
-    : parser_(scanner_, *this)
+    : parser_(scanner_, ast_)
 {
-    check_dependencies_          = false;
     temp_formula_                = NULL;
     row_count_                   = 0;
     log_file_                    = NULL;
@@ -68,6 +77,18 @@ casper::see::See::See ()
     lines_clones_count_        = 0;
     lines_clones_offset_       = 0;
     track_lookups_             = false;
+    short_circuit_             = true;
+    calculate_folded_          = false;
+    constant_folding_          = true;
+    incremental_               = false;
+    incremental_ready_         = false;
+    incremental_generation_    = 0;
+    incremental_run_           = false;
+    symtab_stale_              = false;
+    calculated_formulas_       = 0;
+    worker_pool_               = nullptr;
+    model_cache_hash_          = 0;
+    tables_generation_         = 0;
 }
 
 /**
@@ -81,6 +102,31 @@ casper::see::See::~See ()
         fclose(log_file_);
         log_file_ = nullptr;
     }
+    if ( nullptr != worker_pool_ ) {
+        delete worker_pool_;
+        worker_pool_ = nullptr;
+    }
+}
+
+/**
+ * @brief Set the number of threads used by #CalculateAll
+ *
+ * Formulas of the same dependency level are calculated in parallel, 0 or 1 calculates serially. The
+ * threads also parse the formulas of the models loaded afterwards.
+ *
+ * @param a_count number of threads, including the calling one
+ */
+void casper::see::See::SetCalculationThreads (size_t a_count)
+{
+    if ( nullptr != worker_pool_ ) {
+        delete worker_pool_;
+        worker_pool_ = nullptr;
+    }
+    worker_contexts_.clear();
+    if ( a_count > 1 ) {
+        worker_pool_ = new WorkerPool(a_count);
+        worker_contexts_.resize(a_count);
+    }
 }
 
 #ifdef __APPLE__
@@ -104,6 +150,21 @@ void casper::see::See::Clear ()
         delete *it;
     }
     formulas_.clear();
+    for ( FormulaList::iterator it = folded_formulas_.begin(); it != folded_formulas_.end(); ++it) {
+        delete *it;
+    }
+    folded_formulas_.clear();
+    folded_precedents_.clear();
+    calculate_folded_ = false;
+    dependents_.clear();
+    readers_.clear();
+    formula_index_.clear();
+    lines_sum_ifs_.clear();
+    volatile_.clear();
+    dirty_.clear();
+    folded_dirty_.clear();
+    previous_params_   = Json::Value::null;
+    incremental_ready_ = false;
 
     // Release all tables
     std::set<std::string> deletable_tables;
@@ -119,13 +180,19 @@ void casper::see::See::Clear ()
         delete tbl_it->second;
         tables_.erase(tbl_it);
     }
+    tables_generation_++;
     aliases_.clear();
     precedents_.clear();
     symtab_.clear();
+    symtab_stale_ = false;
     name_to_cell_aliases_.clear();
     line_values_.clear();
-    sum_criterias_.clear();
+    lines_grid_.Clear();
+    Context().sum_criterias_.clear();
+    slots_.Clear();
+    reference_slots_.clear();
     columns_.clear();
+    lines_columns_.clear();
     column_name_index_.clear();
     code_list_.clear();
     data_source_row_index_ = -1;
@@ -160,13 +227,56 @@ void casper::see::See::LoadModelFromFile (const char* a_filename, StringMultiHas
     osal::utils::Swatch tf;
     TmpJsonParser       parser;
     Json::Value*        parsed_json;
+    uint64_t            hash = 0;
 
     tf.Start();
+
+    // ... the dependency analysis reads the symbol table, it must hold the previous calculation ...
+    RefreshSymbolTable();
+
+    /*
+     * The cache is keyed by the model file contents and everything else that changes the loaded model
+     */
+    if ( 0 != model_cache_file_.length() && nullptr == a_patch_scalars && nullptr == a_clone_lines ) {
+        FILE* file = fopen(a_filename, "rb");
+        if ( nullptr != file ) {
+            char   buffer[65536];
+            size_t length;
+
+            hash = ModelCache::Hash(nullptr, 0);
+            while ( 0 != ( length = fread(buffer, 1, sizeof(buffer), file) ) ) {
+                hash = ModelCache::Hash(buffer, length, hash);
+            }
+            fclose(file);
+            for ( auto it = a_clone_map.begin(); it != a_clone_map.end(); ++it ) {
+                hash = ModelCache::Hash(it->first, hash);
+                hash = ModelCache::Hash(it->second, hash);
+            }
+            // ... as strings, a char pointer would pick the (data, length) overload ...
+            hash = ModelCache::Hash(std::string(code_col_name_), hash);
+            hash = ModelCache::Hash(std::string(condition_col_name_), hash);
+            hash = ModelCache::Hash(std::string(true == has_template_lines_ ? "T" : "F"), hash);
+            hash = ModelCache::Hash(std::string(0 != log_file_name_.length() ? "L" : "N"), hash);
+        }
+        if ( 0 != hash && true == LoadModelCache(hash) ) {
+            tf.Stop();
+            printf("Loading time %ld ms (model cache)\n", tf.Ticks() / 1000);
+            return;
+        }
+    }
+
     parsed_json = parser.LoadAndParse(a_filename);
     if ( parsed_json == NULL ) {
         throw OSAL_EXCEPTION("model file %s not found", a_filename);
     }
-    LoadModel(*parsed_json, a_clone_map, a_patch_scalars, a_clone_lines);
+    model_cache_hash_ = hash;
+    try {
+        LoadModel(*parsed_json, a_clone_map, a_patch_scalars, a_clone_lines);
+    } catch (...) {
+        model_cache_hash_ = 0;
+        throw;
+    }
+    model_cache_hash_ = 0;
     tf.Stop();
     printf("Loading time %ld ms\n", tf.Ticks() / 1000);
 }
@@ -175,23 +285,23 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
                                   const std::function<void(Json::Value& a_scalars)> a_patch_scalars,
                                   const std::function<void(Json::Value& a_lines, size_t& o_number_of_added_lines)> a_clone_lines)
 {
-    Json::Value           values, formulas, lines, line_formulas, line_values, lines_header;
-    Json::Value::Members  members;
-    StringHash            line_values_expressions;
-    Term                  term1, term2;
-    char                  cell_ref[20];
-    char                  tmp_cell_ref[20];
-    size_t                row_count;
-    casper::see::location location;
-    std::stringstream     ss;
+    Json::Value                             values, formulas, lines, line_formulas, line_values, lines_header;
+    Json::Value::Members                    members;
+    ValueScanHash                           value_scans;              // Scalar values by cell ref
+    std::vector<ValueScanHash>              line_scans;               // Lines values of each row by column name
+    std::map<std::string, const ValueScan*> line_values_expressions;  // Lines values by cell ref
+    std::vector<const char*>                expressions;              // Formulas being loaded, in load order
+    std::vector<CompiledFormula>            compiled;                 // Their trees when parsed in parallel
+    size_t                                  expression_idx;
+    Term                                    term1, term2;
+    char                                    cell_ref[20];
+    char                                    tmp_cell_ref[20];
+    size_t                                  row_count;
+    std::stringstream                       ss;
 
     row_count_ = 0;
     data_source_row_index_ = -1;
 
-    if ( true == untouched_model_.isNull() ) {
-        untouched_model_ = a_model;
-    }
-
     /*
      * Basic model validation, make sure we have the necessary pieces
      */
@@ -244,6 +354,7 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
         columns_[cinfo.name_] = cinfo;
         column_name_index_[cinfo.col_] = cinfo.name_;
     }
+    IndexLinesColumns();
 
     if ( nullptr == a_clone_lines ) {
         CloneLinesTableLines(a_clone_map, line_formulas, line_values);
@@ -275,18 +386,21 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
 
     };
 
-    const auto evaluate_value_members = [this, &ss, &term1, &term2, &location, &evaluate_value] (Json::Value& a_value) {
+    const auto evaluate_value_members = [this, &evaluate_value] (Json::Value& a_value, ValueScanHash& a_scans) {
         for ( auto member : a_value.getMemberNames() ) {
-            std::string exp = a_value[member].asString();
-            scanner_.SetInput(exp.c_str(), exp.size());
-            if ( scanner_.Scan(&term1, &location) == Parser::token::VAR && scanner_.Scan(&term2, &location) == '=' ) {
-                if ( term1.ToString() != member ) {
-                    evaluate_value(member.c_str(), term1.text_.c_str(), exp.c_str(), a_value);
-                    name_to_cell_aliases_[term1.text_] = member;
-                } else {
-                    evaluate_value(member.c_str(), nullptr, exp.c_str(), a_value);
-                }
+            const std::string exp  = a_value[member].asString();
+            ValueScan&        scan = a_scans[member];
+            if ( false == ScanValue(exp, scan).assignment_ ) {
+                continue;
+            }
+            if ( scan.name_.ToString() != member ) {
+                evaluate_value(member.c_str(), scan.name_.text_.c_str(), exp.c_str(), a_value);
+                name_to_cell_aliases_[scan.name_.text_] = member;
+            } else {
+                evaluate_value(member.c_str(), nullptr, exp.c_str(), a_value);
             }
+            // ... an excel date was replaced by it's serial number ...
+            ScanValue(a_value[member].asString(), scan);
         }
     };
 
@@ -296,12 +410,9 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
      */
     members = values.getMemberNames();
     for (Json::Value::Members::iterator it = members.begin(); it != members.end(); ++it ) {
-        std::string exp = values[it->c_str()].asString();
-        scanner_.SetInput(exp.c_str(), exp.size());
-        if ( scanner_.Scan(&term1, &location) == Parser::token::VAR && scanner_.Scan(&term2, &location) == '=' ) {
-            if ( term1.ToString() != it->c_str() ) {
-                name_to_cell_aliases_[term1.text_] = it->c_str();
-            }
+        ValueScan& scan = value_scans[*it];
+        if ( true == ScanValue(values[it->c_str()].asString(), scan).assignment_ && scan.name_.ToString() != it->c_str() ) {
+            name_to_cell_aliases_[scan.name_.text_] = it->c_str();
         }
     }
 
@@ -345,8 +456,13 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
      * Load the scalar formulas
      */
     members = formulas.getMemberNames();
+    expressions.clear();
     for (Json::Value::Members::iterator it = members.begin(); it != members.end(); ++it ) {
-        LoadFormula(formulas[it->c_str()].asCString(), it->c_str());
+        expressions.push_back(formulas[it->c_str()].asCString());
+    }
+    CompileInParallel(expressions, compiled);
+    for ( size_t idx = 0 ; idx < members.size() ; ++idx ) {
+        LoadFormula(expressions[idx], members[idx].c_str(), compiled.empty() ? nullptr : &compiled[idx]);
     }
 
     // ... for debug proposes only ...
@@ -362,7 +478,7 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
     if ( nullptr != a_patch_scalars ) {
         a_patch_scalars(values);
     }
-    evaluate_value_members(values);
+    evaluate_value_members(values, value_scans);
 
     // ... remove empty line(s) ...
     lines_templates_start_idx_ = 0;
@@ -383,13 +499,14 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
         lines_clones_end_idx_ += row_count_ - 1;
     }
 
+    line_scans.resize(line_values.size());
     row_count = 1;
     for ( Json::Value::iterator it = line_values.begin(); it != line_values.end(); ++it ) {
         if ( row_count < lines_templates_count_ ) {
             row_count += 1;
             continue;
         }
-        evaluate_value_members((*it));
+        evaluate_value_members((*it), line_scans[row_count - 1]);
         row_count += 1;
     }
 
@@ -397,7 +514,23 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
      * Load the formulas from the document lines, keep track of the cell ref to make
      * formula aliases as needed
      */
+    expressions.clear();
     row_count = 1;
+    for ( Json::Value::iterator rit = line_formulas.begin(); rit != line_formulas.end(); ++rit ) {
+        if ( row_count < lines_templates_count_ ) {
+            row_count += 1;
+            continue;
+        }
+        members = (*rit).getMemberNames();
+        for (Json::Value::Members::iterator cit = members.begin(); cit != members.end(); ++cit ) {
+            expressions.push_back((*rit)[cit->c_str()].asCString());
+        }
+        row_count += 1;
+    }
+    CompileInParallel(expressions, compiled);
+
+    expression_idx = 0;
+    row_count      = 1;
     for ( Json::Value::iterator rit = line_formulas.begin(); rit != line_formulas.end(); ++rit ) {
         if ( row_count < lines_templates_count_ ) {
             row_count += 1;
@@ -410,7 +543,8 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
                 throw OSAL_EXCEPTION("Column '%s' is not declared in the table header", cit->c_str());
             }
             Sum::MakeRowColRef(cell_ref, columns_[cit->c_str()].row_ + static_cast<int>(row_count), columns_[cit->c_str()].col_);
-            LoadFormula((*rit)[cit->c_str()].asCString(), cell_ref);
+            LoadFormula(expressions[expression_idx], cell_ref, compiled.empty() ? nullptr : &compiled[expression_idx]);
+            expression_idx += 1;
         }
         row_count += 1;
     }
@@ -452,17 +586,13 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
             }
             Sum::MakeRowColRef(cell_ref, columns_[cit->c_str()].row_ + static_cast<int>(row_count), columns_[cit->c_str()].col_);
 
-            std::string exp = (*rit)[cit->c_str()].asString();
-            scanner_.SetInput(exp.c_str(), exp.size());
-            if ( scanner_.Scan(&term1, &location) == Parser::token::VAR && scanner_.Scan(&term2, &location) == '=' ) {
-                if ( strcmp(term1.text_.c_str(), cell_ref) != 0 ) {
-                    name_to_cell_aliases_[term1.text_] = cell_ref;
+            const ValueScan& scan = ScanValue((*rit)[cit->c_str()].asString(), line_scans[row_count - 1][*cit]);
+            if ( true == scan.assignment_ ) {
+                if ( strcmp(scan.name_.text_.c_str(), cell_ref) != 0 ) {
+                    name_to_cell_aliases_[scan.name_.text_] = cell_ref;
                 }
 
-                term1.SetNull();
-                if ( ( (Parser::token_type) '-' ) == scanner_.Scan(&term1, &location) ) {
-                    scanner_.Scan(&term1, &location);
-                }
+                term1 = scan.literal_;
 
                 tmp_cell_ref[0] = '\0';
                 Sum::MakeRowColRef(tmp_cell_ref, table_header_row_, columns_[cit->c_str()].col_);
@@ -485,25 +615,29 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
                 line_values_[cell_ref] = term1;
             }
 
-            line_values_expressions[cell_ref] = (*rit)[cit->c_str()].asString();
+            line_values_expressions[cell_ref] = &scan;
         }
         row_count += 1;
     }
 
     /*
-     * Expand the sums and calculate the dependencies
+     * Expand the sums and calculate the dependencies, these passes stay serial: CalculateSumDependencies
+     * shares the cell index and the evaluation context of the calling thread and SortDependencies orders the
+     * whole graph, both are under a tenth of the load time
      */
     CalculateSumDependencies();
     SortDependencies();
+    CompileFormulas();
 
     reference_symtab_.clear();
 
     /*
-     * Resolve independent terms
+     * Resolve independent terms, keep track of the ones the model defines with a literal
      */
+    StringSet constants;
     for ( StringSet::iterator it = precedents_.begin(); it != precedents_.end(); ++it ) {
-        const char* variable_name;
-        std::string value;
+        const char*      variable_name;
+        const ValueScan* value = nullptr;
 
         variable_name = it->c_str();
 
@@ -511,13 +645,19 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
         bool        is_nullable = false;
         std::string excel_type;
 
+        const auto scalar_value = [&values, &value_scans] (const std::string& a_ref) -> const ValueScan* {
+            if ( values[a_ref].isNull() == true ) {
+                return nullptr;
+            }
+            return &value_scans[a_ref];
+        };
+
         do {
             variable_is_null_or_does_not_exists = false;
             /*
              * 1st attempt, the variable is known by cell ref in the scalar values
              */
-            if ( values[variable_name].isNull() == false ) {
-                value = values[it->c_str()].asString();
+            if ( nullptr != ( value = scalar_value(*it) ) ) {
                 break;
             }
 
@@ -526,8 +666,7 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
              */
             StringHash::iterator nit = name_to_cell_aliases_.find(variable_name);
             if ( nit != name_to_cell_aliases_.end() ) {
-                if ( values[nit->second].isNull() == false ) {
-                    value = values[nit->second].asString();
+                if ( nullptr != ( value = scalar_value(nit->second) ) ) {
                     break;
                 }
             }
@@ -535,9 +674,9 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
             /*
              * 3rd attempt, the variable is known by cell ref in one of the lines
              */
-            nit = line_values_expressions.find(variable_name);
-            if ( nit != line_values_expressions.end() ) {
-                value = nit->second;
+            auto lit = line_values_expressions.find(variable_name);
+            if ( lit != line_values_expressions.end() ) {
+                value = lit->second;
                 break;
             }
 
@@ -546,9 +685,9 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
              */
             nit = name_to_cell_aliases_.find(variable_name);
             if ( nit != name_to_cell_aliases_.end() ) {
-                nit = line_values_expressions.find(nit->second);
-                if ( nit != line_values_expressions.end() ) {
-                    value = nit->second;
+                lit = line_values_expressions.find(nit->second);
+                if ( lit != line_values_expressions.end() ) {
+                    value = lit->second;
                     break;
                 }
             }
@@ -559,8 +698,6 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
             if ( strcmp(variable_name, "LINES") != 0 ) {
                 // ... value is null or does not exist ...
                 variable_is_null_or_does_not_exists = true;
-            } else {
-                value = "";
             }
 
             break;
@@ -578,29 +715,291 @@ void casper::see::See::LoadModel (Json::Value& a_model, StringMultiHash& a_clone
             SetDefaultTermValue(model_type, term2);
             reference_symtab_[variable_name] = term2;
 
-        } else {
+        } else if ( nullptr != value && true == value->assignment_ ) {
+
+            switch (value->token_) {
+                case Parser::token::TEXTLITERAL:
+                case Parser::token::NUM:
+                    reference_symtab_[variable_name] = value->value_;
+                    constants.insert(variable_name);
+                    break;
+                default:
+                    break;
+            }
+
+        }
+    }
+
+    if ( 0 != model_cache_hash_ ) {
+        SaveModelCache(constants);
+    }
+
+    FinishLoading(constants);
+}
+
+/**
+ * @brief Last steps of the loading, shared by the JSON model and the model cache
+ *
+ * @param a_constants names the model defines with a literal
+ */
+void casper::see::See::FinishLoading (const casper::StringSet& a_constants)
+{
+    /*
+     * Names are known, bind the compiled formulas to the symbol table slots
+     */
+    ResolveSlots();
+
+    /*
+     * Evaluate once the formulas that can't be changed by the parameters
+     */
+    if ( true == constant_folding_ && false == ( has_template_lines_ == true && 0 == lines_clones_count_ ) ) {
+        FoldConstantFormulas(a_constants);
+    }
+
+    BuildDependents();
+}
+
+#ifdef __APPLE__
+#pragma mark ... MODEL CACHE
+#endif
+
+/**
+ * @brief Write the state of the model loaded from JSON to #model_cache_file_
+ *
+ * Called once the formulas are sorted and the independent terms resolved, the slots, the folding and the
+ * dependents are rebuilt by #FinishLoading. A cache that can't be written is reported but doesn't fail the load.
+ *
+ * @param a_constants names the model defines with a literal
+ */
+void casper::see::See::SaveModelCache (const casper::StringSet& a_constants)
+{
+    try {
+        ModelCacheWriter writer(model_cache_hash_);
+
+        writer.Write(static_cast<int32_t>(row_count_));
+        writer.Write(static_cast<int32_t>(table_header_row_));
+        writer.Write(static_cast<uint64_t>(lines_templates_start_idx_));
+        writer.Write(static_cast<uint64_t>(lines_templates_end_idx_));
+        writer.Write(static_cast<uint64_t>(lines_templates_count_));
+        writer.Write(static_cast<uint64_t>(lines_clones_start_idx_));
+        writer.Write(static_cast<uint64_t>(lines_clones_end_idx_));
+        writer.Write(static_cast<uint64_t>(lines_clones_count_));
+        writer.Write(static_cast<uint64_t>(lines_clones_offset_));
+
+        for ( auto types : { &scalars_types_map_, &lines_columns_types_map_ } ) {
+            writer.Write(static_cast<uint32_t>(types->size()));
+            for ( auto it = types->begin(); it != types->end(); ++it ) {
+                writer.Write(it->first);
+                writer.Write(it->second.excel_);
+                writer.Write(static_cast<int32_t>(it->second.term_));
+                writer.Write(static_cast<uint8_t>(it->second.nullable_));
+            }
+        }
 
-            scanner_.SetInput(value.c_str(), value.size());
-            if ( scanner_.Scan(&term1, &location) == Parser::token::VAR && scanner_.Scan(&term2, &location) == '=' ) {
-                switch (scanner_.Scan(&term2, &location)) {
-                    case Parser::token::TEXTLITERAL:
-                    case Parser::token::NUM:
-                        reference_symtab_[variable_name] = term2;
-                        break;
-                    default:
-                        break;
+        writer.Write(static_cast<uint32_t>(columns_.size()));
+        for ( auto it = columns_.begin(); it != columns_.end(); ++it ) {
+            std::string type_ref;
+            for ( auto type_it = lines_columns_types_map_.begin(); type_it != lines_columns_types_map_.end(); ++type_it ) {
+                if ( &type_it->second == it->second.col_type_ ) {
+                    type_ref = type_it->first;
+                    break;
                 }
             }
+            writer.Write(it->first);
+            writer.Write(it->second.name_);
+            writer.Write(static_cast<int32_t>(it->second.col_));
+            writer.Write(static_cast<int32_t>(it->second.row_));
+            writer.Write(type_ref);
+        }
+
+        writer.Write(static_cast<uint32_t>(column_name_index_.size()));
+        for ( auto it = column_name_index_.begin(); it != column_name_index_.end(); ++it ) {
+            writer.Write(static_cast<int32_t>(it->first));
+            writer.Write(it->second);
+        }
+
+        writer.Write(name_to_cell_aliases_);
+        writer.Write(aliases_);
+        writer.Write(line_values_);
+        writer.Write(symtab_);
+        writer.Write(precedents_);
+        writer.Write(reference_symtab_);
+        writer.Write(a_constants);
+
+        writer.Write(static_cast<uint32_t>(formulas_.size()));
+        for ( auto formula : formulas_ ) {
+            writer.Write(static_cast<uint8_t>(formula->GetKind()));
+            formula->Save(writer);
+        }
+
+        writer.Save(model_cache_file_);
+
+    } catch (osal::Exception& a_exception) {
+        fprintf(stderr, "Model cache not saved: %s\n", a_exception.Message());
+    }
+}
+
+/**
+ * @brief Load the model from #model_cache_file_
+ *
+ * @param a_hash hash of the source model
+ *
+ * @return false if there is no valid cache for this model, the See is left empty and the model must be loaded from JSON
+ */
+bool casper::see::See::LoadModelCache (uint64_t a_hash)
+{
+    ModelCacheReader reader;
+    StringSet        constants;
+
+    if ( false == reader.Open(model_cache_file_, a_hash) ) {
+        return false;
+    }
+
+    try {
+        row_count_                 = reader.ReadInt32();
+        table_header_row_          = reader.ReadInt32();
+        lines_templates_start_idx_ = static_cast<size_t>(reader.ReadUInt64());
+        lines_templates_end_idx_   = static_cast<size_t>(reader.ReadUInt64());
+        lines_templates_count_     = static_cast<size_t>(reader.ReadUInt64());
+        lines_clones_start_idx_    = static_cast<size_t>(reader.ReadUInt64());
+        lines_clones_end_idx_      = static_cast<size_t>(reader.ReadUInt64());
+        lines_clones_count_        = static_cast<size_t>(reader.ReadUInt64());
+        lines_clones_offset_       = static_cast<size_t>(reader.ReadUInt64());
+        data_source_row_index_     = -1;
+
+        for ( auto types : { &scalars_types_map_, &lines_columns_types_map_ } ) {
+            types->clear();
+            for ( uint32_t count = reader.ReadUInt32(); count > 0; --count ) {
+                TypeMapEntry& entry = (*types)[reader.ReadString()];
+                entry.excel_    = reader.ReadString();
+                entry.term_     = reader.ReadInt32();
+                entry.nullable_ = ( 0 != reader.ReadUInt8() );
+            }
+        }
+
+        columns_.clear();
+        for ( uint32_t count = reader.ReadUInt32(); count > 0; --count ) {
+            ColumnInfo& cinfo = columns_[reader.ReadString()];
+            cinfo.name_ = reader.ReadString();
+            cinfo.col_  = reader.ReadInt32();
+            cinfo.row_  = reader.ReadInt32();
+
+            const auto type_it = lines_columns_types_map_.find(reader.ReadString());
+            if ( lines_columns_types_map_.end() != type_it ) {
+                cinfo.col_type_ = &type_it->second;
+            }
+        }
+        IndexLinesColumns();
+
+        column_name_index_.clear();
+        for ( uint32_t count = reader.ReadUInt32(); count > 0; --count ) {
+            const int col = reader.ReadInt32();
+            column_name_index_[col] = reader.ReadString();
+        }
+
+        reader.Read(name_to_cell_aliases_);
+        reader.Read(aliases_);
+        reader.Read(line_values_);
+        reader.Read(symtab_);
+        reader.Read(precedents_);
+        reader.Read(reference_symtab_);
+        reader.Read(constants);
+
+        const uint32_t formula_count = reader.ReadUInt32();
+        formulas_.reserve(formula_count);
+        for ( uint32_t idx = 0; idx < formula_count; ++idx ) {
+            // ... owned here until it's restored, a truncated cache throws half way, the destructor is only open to See ...
+            std::unique_ptr<Formula, void (*)(Formula*)> formula(nullptr, [] (Formula* a_formula) { delete a_formula; });
+
+            switch ( reader.ReadUInt8() ) {
+                case Formula::EFormula:
+                    formula.reset(new Formula());
+                    formula->Restore(reader);
+                    break;
+                case Formula::ESum:
+                    formula.reset(new class Sum(reader));
+                    break;
+                case Formula::ESumIf:
+                    formula.reset(new class SumIf(reader));
+                    break;
+                case Formula::ESumIfs:
+                    formula.reset(new class SumIfs(reader));
+                    break;
+                case Formula::EVlookup:
+                    formula.reset(new class Vlookup(*this, reader));
+                    break;
+                default:
+                    throw OSAL_EXCEPTION("Model cache file %s is corrupted, unknown formula kind", model_cache_file_.c_str());
+            }
+            formulas_.push_back(formula.get());
+            formula.release();
+        }
 
+        if ( false == reader.AtEnd() ) {
+            throw OSAL_EXCEPTION("Model cache file %s is corrupted, unexpected trailing data", model_cache_file_.c_str());
         }
+
+    } catch (osal::Exception& a_exception) {
+        fprintf(stderr, "Model cache ignored: %s\n", a_exception.Message());
+        Clear();
+        scalars_types_map_.clear();
+        lines_columns_types_map_.clear();
+        return false;
+    }
+    reader.Close();
+
+    CompileFormulas();
+    FinishLoading(constants);
+
+    return true;
+}
+
+/**
+ * @brief Scan the leading tokens of a value expression, "name = literal", unless they are already scanned
+ *
+ * @param a_expression the value expression
+ * @param io_scan      the previous scan of the value, updated when it was of another expression
+ *
+ * @return the scan
+ */
+const casper::see::ValueScan& casper::see::See::ScanValue (const std::string& a_expression, casper::see::ValueScan& io_scan)
+{
+    casper::see::location location;
+    Term                  term;
+
+    if ( io_scan.expression_ == a_expression ) {
+        return io_scan;
     }
+
+    io_scan.expression_ = a_expression;
+    io_scan.assignment_ = false;
+    io_scan.token_      = 0;
+    io_scan.name_.SetNull();
+    io_scan.value_.SetNull();
+    io_scan.literal_.SetNull();
+
+    scanner_.SetInput(io_scan.expression_.c_str(), io_scan.expression_.size());
+    if ( scanner_.Scan(&io_scan.name_, &location) == Parser::token::VAR && scanner_.Scan(&term, &location) == '=' ) {
+        io_scan.assignment_ = true;
+        io_scan.token_      = scanner_.Scan(&io_scan.value_, &location);
+        io_scan.literal_    = io_scan.value_;
+        if ( ( (Parser::token_type) '-' ) == io_scan.token_ ) {
+            scanner_.Scan(&io_scan.literal_, &location);
+        }
+    }
+    return io_scan;
 }
 
-void casper::see::See::LoadFormula (const char* a_expression, const char* a_alias)
+/**
+ * @brief Load one formula, compile it and register it's name, alias and dependencies
+ *
+ * @param a_expression formula expression
+ * @param a_alias      cell reference of the formula, NULL if none
+ * @param a_compiled   expression tree compiled by #CompileInParallel, NULL to compile it here
+ */
+void casper::see::See::LoadFormula (const char* a_expression, const char* a_alias, CompiledFormula* a_compiled)
 {
     try {
-        casper::see::location location;
-        Term term1, term2;
         int exp_len;
 
         temp_formula_ = new Formula();
@@ -609,22 +1008,29 @@ void casper::see::See::LoadFormula (const char* a_expression, const char* a_alia
             temp_formula_->alias_ = a_alias;
         }
         exp_len = (int) strlen(a_expression);
-        scanner_.SetInput(a_expression, exp_len);
-        if ( scanner_.Scan(&term1, &location) == Parser::token::VAR && scanner_.Scan(&term2, &location) == '=' ) {
-            temp_formula_->name_ = term1.text_;
-            expression_name_ = term1.text_;
-            if ( a_alias != NULL ) {
-                name_to_cell_aliases_[expression_name_] = a_alias;
+
+        /*
+         * Parse the expression only once, the dependency analysis and all calculations run on the compiled tree
+         */
+        if ( nullptr != a_compiled ) {
+            if ( a_compiled->error_ ) {
+                std::rethrow_exception(a_compiled->error_);
             }
+            temp_formula_->ast_.Swap(a_compiled->ast_);
+            BindTables(temp_formula_->ast_);
         } else {
-            expression_name_ = "";
+            Compile(a_expression, exp_len, temp_formula_->ast_);
+        }
+        if ( temp_formula_->ast_.Name().length() != 0 ) {
+            temp_formula_->name_ = temp_formula_->ast_.Name();
+            if ( a_alias != NULL ) {
+                name_to_cell_aliases_[temp_formula_->name_] = a_alias;
+            }
         }
 
-        scanner_.SetInput(a_expression, exp_len);
-
-        check_dependencies_ = true;
-        parser_.parse();
-        check_dependencies_ = false;
+        main_context_.check_dependencies_ = true;
+        Execute(temp_formula_->ast_);
+        main_context_.check_dependencies_ = false;
 
         formulas_.push_back(temp_formula_);
 
@@ -645,12 +1051,14 @@ void casper::see::See::LoadFormula (const char* a_expression, const char* a_alia
 
     } catch (osal::Exception& a_exception) {
 
+        main_context_.check_dependencies_ = false;
         delete temp_formula_;
         temp_formula_ = NULL;
         throw a_exception;
 
     } catch (...) {
 
+        main_context_.check_dependencies_ = false;
         delete temp_formula_;
         temp_formula_ = NULL;
         throw OSAL_EXCEPTION_NA("unexpected exception type");
@@ -672,18 +1080,40 @@ casper::see::Table* casper::see::See::GetTableByName (const char* a_table_name)
     TableHash::iterator it;
     Table* table;
 
+    std::lock_guard<std::mutex> lock(tables_mutex_);
+
     it = tables_.find(a_table_name);
     if ( it == tables_.end() ) {
         table = LoadTable(a_table_name, NULL);
     } else {
         table = it->second;
         if ( table->IsPartialyLoaded() ) {
+            // ... other contexts may be reading it, #LoadPartialTables completes them before they calculate ...
+            if ( &main_context_ != &Context() ) {
+                throw OSAL_EXCEPTION("Table '%s' was partially loaded after the calculation started", a_table_name);
+            }
             LoadTable(a_table_name, table);
         }
     }
     return table;
 }
 
+/**
+ * @brief Complete the loading of the partially loaded tables
+ *
+ * Called before the calculations that run on other threads, a table is never amended while it can be read.
+ */
+void casper::see::See::LoadPartialTables ()
+{
+    std::lock_guard<std::mutex> lock(tables_mutex_);
+
+    for ( TableHash::iterator it = tables_.begin(); it != tables_.end(); ++it ) {
+        if ( true == it->second->IsPartialyLoaded() ) {
+            LoadTable(it->first.c_str(), it->second);
+        }
+    }
+}
+
 /**
  * @brief Load an already prepared table
  *
@@ -699,6 +1129,7 @@ void casper::see::See::LoadTable (casper::see::Table* a_table)
     tbl_name = a_table->GetName();
     UnloadTable(tbl_name);
     tables_[tbl_name] = a_table;
+    tables_generation_++;
 }
 
 /**
@@ -713,41 +1144,68 @@ void casper::see::See::LoadTable (casper::see::Table* a_table)
  */
 casper::see::Table* casper::see::See::LoadTable (const char* a_table_name, Table* a_partially_loaded_table)
 {
-    Table*        table;
-    TmpJsonParser parser;
-    Json::Value*  parsed_json;
+    Table* table = a_partially_loaded_table;
+    FILE*  file  = nullptr;
 
     try {
-        table = a_partially_loaded_table;
         std::string path = json_tables_path_;
         path += a_table_name;
         path += ".json";
 
         /*
-         * Parse the datafile
+         * Stream the datafile straight into the table columns, no JSON document is built
          */
-        parsed_json = parser.LoadAndParse(path.c_str());
-        if ( parsed_json == NULL ) {
+        file = fopen(path.c_str(), "rb");
+        if ( nullptr == file ) {
             throw OSAL_EXCEPTION("Table '%s' not found", a_table_name);
         }
         if ( table == NULL ) {
             table = new Table(a_table_name, false); // on a full load create a fresh table
         }
-        table->Load(*parsed_json, a_table_name);
+
+        TableParser parser(*table, a_table_name);
+        char        buffer[65536];
+        size_t      length;
+        bool        parsed;
+
+        parsed = parser.InitParse();
+        while ( true == parsed && 0 != ( length = fread(buffer, 1, sizeof(buffer), file) ) ) {
+            parsed = parser.ParseSlice(buffer, length);
+        }
+        if ( false == parsed || 0 != ferror(file) || false == parser.FinishParse() ) {
+            throw OSAL_EXCEPTION("Table '%s' json file is invalid near offset %zu", a_table_name, parser.ErrorOffset());
+        }
+        fclose(file);
+        file = nullptr;
+
+        if ( nullptr != log_file_ ) {
+            const size_t cells = table->GetCellCount();
+            fprintf(log_file_, "--- table %s loaded, %zu values in %zu KB, %zu KB as terms, %zu strings interned ---\n",
+                    a_table_name, cells, table->GetBytes() / 1024, cells * sizeof(Term) / 1024, StringPool::Size());
+        }
 
         /*
          * Last but not the least add the table to the index
          */
         if ( a_partially_loaded_table == NULL ) {
             LoadTable(table);
+        } else {
+            table->SetPartiallyLoaded(false);
+            tables_generation_++;
         }
 
     } catch (osal::Exception& a_exception) {
-        if ( table != NULL ) {
+        if ( nullptr != file ) {
+            fclose(file);
+        }
+        if ( table != NULL && a_partially_loaded_table == NULL ) {
             delete table;
         }
         throw a_exception;
     } catch (...) {
+        if ( nullptr != file ) {
+            fclose(file);
+        }
         if ( table != NULL && a_partially_loaded_table == NULL ) {
             delete table;
         }
@@ -766,6 +1224,7 @@ void casper::see::See::UnloadTable (const std::string& a_table_name)
     if ( it != tables_.end() ) {
         delete it->second;
         tables_.erase(a_table_name);
+        tables_generation_++;
     }
 }
 
@@ -963,86 +1422,143 @@ bool casper::see::See::CloneLinesTableLines (StringMultiHash& a_clone_map, Json:
 #pragma mark -
 #endif
 
+/**
+ * @brief Expand the cells the SUM, SUMIF, SUMIFS and VLOOKUP formulas depend upon
+ *
+ * The defined cells are indexed once so that each formula queries the rows of it's columns.
+ */
 void casper::see::See::CalculateSumDependencies ()
 {
+    cell_index_.Build(symtab_, aliases_, line_values_);
     for ( FormulaList::iterator it = formulas_.begin(); it != formulas_.end(); ++it) {
-        current_formula_ = (*it);
-        current_formula_->CalculateDependencies(*this);
+        Context().current_formula_ = (*it);
+        (*it)->CalculateDependencies(*this);
     }
+    cell_index_.Clear();
 }
 
+/**
+ * @brief Sort #formulas_ so that each formula comes after the formulas it depends upon
+ *
+ * The aliased precedents are replaced by the cell they alias and the precedents that are not formulas are
+ * collected in #precedents_. Formula names are numbered once, the sort then runs on the precedent indexes
+ * with Kahn's algorithm, formulas that are ready keep their relative order. The lemon graph is only built
+ * to report a circular dependency.
+ */
 void casper::see::See::SortDependencies ()
 {
-    typedef lemon::ListDigraph              GR;
-    typedef std::map<std::string, GR::Node> NodeMap;
-    typedef GR::ArcMap<int>                 ArcCost;
-
-    std::vector<Formula*> tmp_formulas;        // Copy of the formula array
-    GR                    dep_graph;           // Formula dependency graph
-    GR::NodeMap<int>      order(dep_graph);    // Helper map for topological sorting
-    NodeMap               name_to_node;        // Hash to track nodes by formula name
-    ArcCost               arc_cost(dep_graph);
-    int                   formula_count;
+    const uint32_t                            formula_count = static_cast<uint32_t>(formulas_.size());
+    std::unordered_map<std::string, uint32_t> name_to_index;   // Formula index by name, the last formula wins duplicated names
+    std::vector<uint32_t>                     first_arc(formula_count + 1, 0);
+    std::vector<uint32_t>                     arc_target;      // Precedent formulas of formula i are in [first_arc[i], first_arc[i + 1])
+    std::vector<uint32_t>                     first_dependent(formula_count + 1, 0);
+    std::vector<uint32_t>                     dependents;      // Same layout, the formulas that depend on formula i
+    std::vector<uint32_t>                     pending(formula_count, 0);
+    std::vector<uint32_t>                     order;
 
     precedents_.clear();
 
-    /*
-     * Create a graph node for each formula and save the formula pointer
-     * in the temporary array. Keep track of the node id assigned to each name
-     */
-    formula_count = (int) formulas_.size() - 1;
-    for ( unsigned i = 0; i < formulas_.size(); ++i ) {
-        GR::Node node = dep_graph.addNode();
-        name_to_node[formulas_[i]->name_] = node;
-        tmp_formulas.push_back(formulas_[i]);
+    name_to_index.reserve(formulas_.size());
+    for ( uint32_t i = 0; i < formula_count; ++i ) {
+        name_to_index[formulas_[i]->name_] = i;
     }
 
     /*
-     * Update aliased cell references
+     * Update aliased cell references, the set is only rebuilt when one of it's names is aliased
      */
-    for ( unsigned i = 0; i < formulas_.size(); ++i ) {
-        StringSet to_remove;
-
-        for (StringSet::iterator iter = formulas_[i]->precedents_.begin(); iter != formulas_[i]->precedents_.end(); ++iter ) {
+    for ( uint32_t i = 0; i < formula_count; ++i ) {
+        StringSet& precedents = formulas_[i]->precedents_;
+        bool       aliased    = false;
 
-            StringHash::iterator ait = aliases_.find(*iter);
-            if ( ait != aliases_.end() && strcmp(iter->c_str(), ait->second.c_str()) != 0 ) {
-                formulas_[i]->precedents_.insert(ait->second);
-                to_remove.insert(*iter);
-            }
+        for ( StringSet::const_iterator it = precedents.begin(); it != precedents.end() && false == aliased; ++it ) {
+            const StringHash::const_iterator ait = aliases_.find(*it);
+            aliased = ( ait != aliases_.end() && *it != ait->second );
         }
-        for ( StringSet::iterator iter = to_remove.begin(); iter != to_remove.end(); ++iter ) {
-            formulas_[i]->precedents_.erase(*iter);
+        if ( false == aliased ) {
+            continue;
+        }
+
+        StringSet resolved;
+        for ( StringSet::const_iterator it = precedents.begin(); it != precedents.end(); ++it ) {
+            const StringHash::const_iterator ait = aliases_.find(*it);
+            resolved.insert( ait != aliases_.end() ? ait->second : *it );
         }
+        precedents.swap(resolved);
     }
 
     /*
-     * Visit the formula precendent lists to add dependency arcs to the graph
+     * Number the precedents that are formulas, the others are the independent terms of the model
      */
-    for ( unsigned i = 0; i < formulas_.size(); ++i ) {
-        StringSet& precedents = formulas_[i]->precedents_;
+    for ( uint32_t i = 0; i < formula_count; ++i ) {
+        const StringSet& precedents = formulas_[i]->precedents_;
+
+        for ( StringSet::const_iterator it = precedents.begin(); it != precedents.end(); ++it ) {
+            const auto index_it = name_to_index.find(*it);
+            if ( index_it != name_to_index.end() ) {
+                arc_target.push_back(index_it->second);
+                first_dependent[index_it->second + 1]++;
+            } else if ( aliases_.find(*it) == aliases_.end() ) {
+                precedents_.insert(*it);
+            }
+        }
+        first_arc[i + 1] = static_cast<uint32_t>(arc_target.size());
+        pending[i]       = first_arc[i + 1] - first_arc[i];
+    }
 
-        GR::Node& formula_node = name_to_node[formulas_[i]->name_];
+    for ( uint32_t i = 0; i < formula_count; ++i ) {
+        first_dependent[i + 1] += first_dependent[i];
+    }
+    dependents.resize(arc_target.size());
+    {
+        std::vector<uint32_t> next(first_dependent.begin(), first_dependent.end() - 1);
+        for ( uint32_t i = 0; i < formula_count; ++i ) {
+            for ( uint32_t arc = first_arc[i]; arc < first_arc[i + 1]; ++arc ) {
+                dependents[next[arc_target[arc]]++] = i;
+            }
+        }
+    }
 
-        for ( StringSet::iterator it = precedents.begin(); it != precedents.end(); ++it ) {
-            NodeMap::iterator bn_it = name_to_node.find(*it);
-            if ( bn_it != name_to_node.end() ) {
-                GR::Arc arc = dep_graph.addArc(formula_node, bn_it->second);
-                arc_cost.set(arc, 1);
-            } else {
-                if ( aliases_.find(*it) == aliases_.end() ) {
-                    precedents_.insert(*it);
-                }
+    /*
+     * Formulas without pending precedents are ready, order is also the queue of the ready formulas
+     */
+    order.reserve(formula_count);
+    for ( uint32_t i = 0; i < formula_count; ++i ) {
+        if ( 0 == pending[i] ) {
+            order.push_back(i);
+        }
+    }
+    for ( size_t head = 0; head < order.size(); ++head ) {
+        const uint32_t formula = order[head];
+        for ( uint32_t d = first_dependent[formula]; d < first_dependent[formula + 1]; ++d ) {
+            if ( 0 == --pending[dependents[d]] ) {
+                order.push_back(dependents[d]);
             }
         }
     }
 
     /*
-     * Make sure the dependency graph is acyclic
+     * Formulas left unsorted are on or after a cycle, let lemon find one to report it
      */
-    if ( lemon::checkedTopologicalSort(dep_graph, order) == false ) {
+    if ( order.size() != formula_count ) {
+        typedef lemon::ListDigraph GR;
+        typedef GR::ArcMap<int>    ArcCost;
+
+        GR                                    dep_graph;
+        ArcCost                               arc_cost(dep_graph);
+        std::vector<GR::Node>                 nodes;
         std::string                           circular_dep_report;
         lemon::Path<GR>                       path;
+
+        nodes.reserve(formula_count);
+        for ( uint32_t i = 0; i < formula_count; ++i ) {
+            nodes.push_back(dep_graph.addNode());
+        }
+        for ( uint32_t i = 0; i < formula_count; ++i ) {
+            for ( uint32_t arc = first_arc[i]; arc < first_arc[i + 1]; ++arc ) {
+                arc_cost.set(dep_graph.addArc(nodes[i], nodes[arc_target[arc]]), 1);
+            }
+        }
+
         lemon::HartmannOrlinMmc<GR, ArcCost > hart(dep_graph, arc_cost);
 
         hart.cycle(path).run();
@@ -1053,9 +1569,9 @@ void casper::see::See::SortDependencies ()
             GR::Arc arc = path.nth(i);
 
             circular_dep_report += "  Formula: '";
-            circular_dep_report += tmp_formulas[dep_graph.id(dep_graph.source(arc))]->formula_;
+            circular_dep_report += formulas_[dep_graph.id(dep_graph.source(arc))]->formula_;
             circular_dep_report += "'\n      <= '";
-            circular_dep_report += tmp_formulas[dep_graph.id(dep_graph.target(arc))]->formula_.c_str();
+            circular_dep_report += formulas_[dep_graph.id(dep_graph.target(arc))]->formula_.c_str();
             circular_dep_report += "'\n";
         }
         fprintf(stderr, "\n%s\n", circular_dep_report.c_str());
@@ -1063,231 +1579,2328 @@ void casper::see::See::SortDependencies ()
     }
 
     /*
-     * Copy the formula pointers back to array using the topological sort ordering,
-     * each array entry depends only on the items with lower indexes
+     * Copy the formula pointers back in the sorted order, each entry depends only on the items with lower indexes
      */
-    for (GR::NodeIt n(dep_graph); n != lemon::INVALID; ++n) {
-        formulas_[formula_count - order[n]] = tmp_formulas[dep_graph.id(n)];
+    FormulaList sorted;
+    sorted.reserve(formula_count);
+    for ( uint32_t i = 0; i < formula_count; ++i ) {
+        sorted.push_back(formulas_[order[i]]);
     }
+    formulas_.swap(sorted);
 }
 
 #ifdef __APPLE__
 #pragma mark -
-#pragma mark ::: FORMULA CALCULATION :::
+#pragma mark ::: FORMULA COMPILATION :::
 #pragma mark -
 #endif
 
 /**
- * @brief Public entry point to calculate one expression
+ * @brief Compile the formulas created by the dependency analysis
  *
- * @param a_expression expression string
+ * Formulas loaded from the model were compiled by #LoadFormula, the SUMIF, SUMIFS and VLOOKUP helper formulas
+ * are compiled here so that #CalculateAll never parses. A formula that fails to compile is left as is, the
+ * error is reported by #CalculateAll when it's calculated.
  */
-void casper::see::See::Calculate (const char* a_expression, size_t a_len)
+void casper::see::See::CompileFormulas ()
 {
-    casper::see::location location;
-    Term term1, term2;
-
-    result_.type_   = Term::ENan;
-    result_.number_ = 0;
-    result_.text_   = "";
-
-    scanner_.SetInput(a_expression, a_len);
-    if ( scanner_.Scan(&term1, &location) == Parser::token::VAR && scanner_.Scan(&term2, &location) == '=' ) {
-        expression_name_ = term1.text_;
-    } else {
-        expression_name_ = "";
+    for ( FormulaList::iterator it = formulas_.begin(); it != formulas_.end(); ++it) {
+        if ( (*it)->IsSum() || Formula::EVlookup == (*it)->GetKind() || (*it)->ast_.IsCompiled() ) {
+            continue;
+        }
+        try {
+            Compile((*it)->formula_.c_str(), (*it)->formula_.size(), (*it)->ast_);
+        } catch (osal::Exception&) {
+            (*it)->ast_.Reset();
+        }
     }
-    scanner_.SetInput(a_expression, a_len);
-    check_dependencies_ = false;
-    parser_.parse();
 }
 
 /**
- * @brief Public entry point to calculate the whole model
+ * @brief Resolve all the names used by the calculations to symbol table slots
  *
- * @param a_params
+ * Called once the model is loaded, the variables, cells and aliases of the compiled formulas are bound to
+ * their slots, #CalculateAll then reads and writes the symbol table without looking up names.
  */
-void casper::see::See::CalculateAll (const Json::Value& a_params)
+void casper::see::See::ResolveSlots ()
 {
-    Term val;
+    slots_.Clear();
 
-    /*
-     * Clear the symbol table and reload the "static" symbols created when the model was loaded
-     */
-    symtab_.clear();
+    reference_slots_.clear();
     for ( SymbolTable::iterator it = reference_symtab_.begin(); it != reference_symtab_.end(); ++it ) {
-        symtab_[it->first] = it->second;
+        reference_slots_.push_back(slots_.Resolve(it->first));
     }
 
-    /*
-     * Clear tracked lookups.
-     */
-    track_filter_params_ = a_params;
-    for ( auto lt_it : lt_tables_ ) {
-        const auto table_it = tables_.find(lt_it.first);
-        if ( tables_.end() != table_it ) {
-            table_it->second->SetTrackLookups(lt_it.second, track_filter_params_);
-        }
+    for ( FormulaList::iterator it = formulas_.begin(); it != formulas_.end(); ++it) {
+        ResolveSlots(*it);
+    }
+    // ... a parameter that overrides a folded name makes #CalculateAll evaluate them again ...
+    for ( FormulaList::iterator it = folded_formulas_.begin(); it != folded_formulas_.end(); ++it) {
+        ResolveSlots(*it);
     }
 
-    // ... for all object members ...
-    bool        is_nullable = false;
-    std::string excel_type  = "";
-    for ( auto member : a_params.getMemberNames() ) {
-        // ... pick and keep track if it's value  ...
-        const Json::Value& tmp_field = a_params[member];
-        switch (tmp_field.type()) {
-            case Json::ValueType::nullValue:
-            {
-                casper::Term default_value = casper::Term(casper::Term::EUndefined);
-                const int model_type = GetParamType(member.c_str(), nullptr, is_nullable, excel_type, casper::Term::EUndefined);
-                if ( casper::Term::EUndefined == model_type ) {
-                    throw OSAL_EXCEPTION("Type for scalar '%s' not defined!",
-                                         member.c_str()
-                    );
-                }
-                SetDefaultTermValue(model_type, default_value);
-                symtab_[member] = default_value;
-                break;
-            }
-            case Json::ValueType::intValue:
-                symtab_[member] = static_cast<double>(tmp_field.asInt64());
-                break;
-            case Json::ValueType::uintValue:
-                symtab_[member] = static_cast<double>(tmp_field.asUInt64());
-                break;
-            case Json::ValueType::realValue:
-                symtab_[member] = static_cast<double>(tmp_field.asDouble());
-                break;
-            case Json::ValueType::stringValue:
-                symtab_[member] = tmp_field.asString();
-                break;
-            case Json::ValueType::booleanValue:
-                symtab_[member] = tmp_field.asBool();
+    for ( StringHash::iterator it = aliases_.begin(); it != aliases_.end(); ++it ) {
+        slots_.SetAlias(slots_.Resolve(it->first), slots_.Resolve(it->second));
+    }
+
+    BuildLinesGrid();
+}
+
+/**
+ * @brief Index the slots and literals of the lines table cells by row and column
+ *
+ * Cells that no formula, alias or constant names are left without a slot, the grid is rebuilt whenever the
+ * slots are resolved again.
+ */
+void casper::see::See::BuildLinesGrid ()
+{
+    char cell_ref[20];
+
+    lines_grid_.Clear();
+    if ( 0 == columns_.size() ) {
+        return;
+    }
+
+    int32_t first_col = INT32_MAX;
+    int32_t last_col  = INT32_MIN;
+    for ( ColumnHash::const_iterator it = columns_.begin(); it != columns_.end(); ++it ) {
+        first_col = std::min(first_col, static_cast<int32_t>(it->second.col_));
+        last_col  = std::max(last_col,  static_cast<int32_t>(it->second.col_));
+    }
+    const int32_t first_row = columns_.begin()->second.row_ + 1;
+
+    lines_grid_.Reset(first_row, row_count_, first_col, last_col - first_col + 1);
+    for ( int32_t row = first_row; row < first_row + row_count_; ++row ) {
+        for ( ColumnHash::const_iterator it = columns_.begin(); it != columns_.end(); ++it ) {
+            LinesGrid::Cell* cell = lines_grid_.At(row, it->second.col_);
+
+            Sum::MakeRowColRef(cell_ref, row, it->second.col_);
+            cell->ref_slot_ = slots_.Find(cell_ref);
+
+            const StringHash::const_iterator alias_it = aliases_.find(cell_ref);
+            cell->slot_ = ( aliases_.end() != alias_it ? slots_.Find(alias_it->second) : cell->ref_slot_ );
+
+            const SymbolTable::const_iterator value_it = line_values_.find(cell_ref);
+            cell->value_ = ( line_values_.end() != value_it ? &value_it->second : nullptr );
+        }
+    }
+}
+
+/**
+ * @brief Resolve the names used by one formula to symbol table slots
+ *
+ * @param a_formula the formula to bind
+ */
+void casper::see::See::ResolveSlots (casper::see::Formula* a_formula)
+{
+    char cellref[20];
+
+    a_formula->ResolveSlots(slots_);
+
+    Context().expression_name_ = a_formula->ast_.Name();
+    for ( auto node : a_formula->ast_.allocated_nodes_ ) {
+        switch ( node->type_ ) {
+            case AstNode::TVariable:
+            case AstNode::TAssign:
+                node->slot_ = slots_.Resolve(node->value_.text_);
+                break;
+            case AstNode::TTableCellRef:
+            case AstNode::TTableCellRefForOffset:
+                try {
+                    node->slot_ = slots_.Resolve(LinesTableSymbolName(node->tokens_[0], cellref));
+                } catch (osal::Exception&) {
+                    // ... left unresolved, the error is raised when the formula is calculated ...
+                    node->slot_ = SlotTable::k_invalid_slot_;
+                }
                 break;
             default:
-                throw OSAL_EXCEPTION("Unexpected scalar type %d for member name '%s'!", tmp_field.type(), member.c_str());
+                break;
+        }
+    }
+}
+
+#ifdef __APPLE__
+#pragma mark ... CONSTANT FOLDING
+#endif
+
+/**
+ * @brief Evaluate at load time the formulas that do not depend on the calculation parameters
+ *
+ * A formula is folded when all it's precedents are literals of the model or other folded formulas and it
+ * does not read the lookup tables, those can be replaced between calculations. The folded values are moved
+ * to #reference_symtab_ and the formulas to #folded_formulas_, #CalculateAll only evaluates them again when
+ * a parameter overrides one of the names they use.
+ *
+ * @param a_constants names of the #reference_symtab_ entries defined by a literal in the model
+ */
+void casper::see::See::FoldConstantFormulas (const casper::StringSet& a_constants)
+{
+    StringSet   known  = a_constants;
+    const Term  result = Context().result_;
+    FormulaList remaining;
+
+    slots_.Invalidate();
+    size_t reference_idx = 0;
+    for ( SymbolTable::iterator it = reference_symtab_.begin(); it != reference_symtab_.end(); ++it ) {
+        slots_[reference_slots_[reference_idx++]] = it->second;
+    }
+
+    /*
+     * The formulas are sorted, the precedents of a formula were already visited
+     */
+    for ( FormulaList::iterator it = formulas_.begin(); it != formulas_.end(); ++it) {
+        Formula* formula  = (*it);
+        bool     foldable = IsFoldable(formula, known);
+
+        if ( true == foldable ) {
+            try {
+                CalculateFormula(formula);
+                foldable = slots_.IsSet(formula->slot_);
+            } catch (osal::Exception&) {
+                // ... the error is reported by #CalculateAll ...
+                foldable = false;
+            }
+        }
+        if ( true == foldable ) {
+            known.insert(formula->name_);
+            folded_formulas_.push_back(formula);
+        } else {
+            remaining.push_back(formula);
         }
     }
 
-    CalculateAll();
+    for ( FormulaList::iterator it = folded_formulas_.begin(); it != folded_formulas_.end(); ++it) {
+        reference_symtab_[(*it)->name_] = slots_[(*it)->slot_];
+        folded_precedents_.insert((*it)->name_);
+        if ( 0 != (*it)->alias_.length() ) {
+            folded_precedents_.insert((*it)->alias_);
+        }
+        folded_precedents_.insert((*it)->precedents_.begin(), (*it)->precedents_.end());
+    }
+    formulas_.swap(remaining);
+    Context().result_ = result;
+
+    /*
+     * The folded values are now references, bind them
+     */
+    ResolveSlots();
 }
 
-void casper::see::See::CalculateAll ()
+/**
+ * @brief Check if a formula can be evaluated at load time
+ *
+ * @param a_formula   the formula to check
+ * @param a_constants names whose value is known at load time
+ */
+bool casper::see::See::IsFoldable (const casper::see::Formula* a_formula, const casper::StringSet& a_constants) const
 {
-    osal::utils::Swatch tf;
-    int32_t col;
-    int32_t row;
+    if ( SlotTable::k_invalid_slot_ == a_formula->slot_ ) {
+        return false;
+    }
+    for ( StringSet::const_iterator it = a_formula->precedents_.begin(); it != a_formula->precedents_.end(); ++it ) {
+        if ( a_constants.end() == a_constants.find(*it) ) {
+            return false;
+        }
+    }
+    if ( a_formula->IsSum() ) {
+        return true;
+    }
+    if ( false == a_formula->ast_.IsCompiled() ) {
+        return false;
+    }
+    for ( auto node : a_formula->ast_.allocated_nodes_ ) {
+        switch ( node->type_ ) {
+            case AstNode::TVlookup:
+            case AstNode::TVlookupRange:
+            case AstNode::TLookup:
+            case AstNode::TSumVector:
+            case AstNode::TSumIf:
+            case AstNode::TSumIfs:
+            case AstNode::TOffset:
+            case AstNode::TMatch:
+            case AstNode::TTableCellRefForOffset:
+                return false;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Parse an expression into it's expression tree
+ *
+ * @param a_expression expression string
+ * @param a_len        expression length
+ * @param o_ast        receives the compiled expression
+ */
+void casper::see::See::Compile (const char* a_expression, size_t a_len, casper::see::Ast& o_ast)
+{
+    Parse(scanner_, parser_, ast_, a_expression, a_len, o_ast);
+    BindTables(o_ast);
+}
 
+/**
+ * @brief Parse an expression with the given scanner and parser, the table references are not bound
+ *
+ * @param a_scanner    scanner used by @a a_parser
+ * @param a_parser     parser that builds the tree in @a a_ast
+ * @param a_ast        expression tree of @a a_parser
+ * @param a_expression expression string
+ * @param a_len        expression length
+ * @param o_ast        receives the compiled expression
+ */
+void casper::see::See::Parse (casper::see::Scanner& a_scanner, casper::see::Parser& a_parser, casper::see::Ast& a_ast,
+                              const char* a_expression, size_t a_len, casper::see::Ast& o_ast)
+{
+    a_ast.Reset();
+    a_scanner.SetInput(a_expression, a_len);
+    a_parser.parse();
+    if ( false == a_ast.IsCompiled() || 1 != a_ast.stack_.size() ) {
+        throw OSAL_EXCEPTION("Unable to compile expression '%.*s'", (int) a_len, a_expression);
+    }
+    a_ast.stack_.clear();
+    o_ast.Reset();
+    o_ast.Swap(a_ast);
+}
 
-    if ( has_template_lines_ == true && 0 == lines_clones_count_ ) {
+/**
+ * @brief Parse a batch of formulas on the #worker_pool_ threads
+ *
+ * Each worker owns a scanner and a parser, only the parsing runs in parallel. The formulas are then
+ * loaded in their original order by #LoadFormula, the dependency analysis, the aliases and the helper
+ * formulas are created serially so #formulas_ is the same as the one of the serial load. An expression
+ * that fails to compile keeps it's exception, it is thrown when the formula is loaded.
+ *
+ * @param a_expressions formula expressions
+ * @param o_compiled    receives one entry per expression, left empty when the load is serial
+ */
+void casper::see::See::CompileInParallel (const std::vector<const char*>& a_expressions, std::vector<CompiledFormula>& o_compiled)
+{
+    o_compiled.clear();
+    if ( nullptr == worker_pool_ || a_expressions.size() < 2 ) {
+        return;
+    }
+
+    std::vector<CompiledFormula>           compiled(a_expressions.size());
+    std::vector<std::unique_ptr<Compiler>> compilers(worker_pool_->Size());
+
+    worker_pool_->Run(a_expressions.size(), [&] (size_t a_worker, size_t a_index) {
+        if ( nullptr == compilers[a_worker] ) {
+            compilers[a_worker].reset(new Compiler());
+        }
+        Compiler& compiler = *compilers[a_worker];
+        try {
+            Parse(compiler.scanner_, compiler.parser_, compiler.ast_,
+                  a_expressions[a_index], strlen(a_expressions[a_index]), compiled[a_index].ast_);
+        } catch (...) {
+            compiled[a_index].error_ = std::current_exception();
+        }
+    });
+    o_compiled.swap(compiled);
+}
+
+/**
+ * @brief Parse the table and column names of the table functions whose references are constant
+ *
+ * The names are parsed exactly like #Lookup, #Vlookup, #Sum and #SumIfs do on every call, references
+ * built by INDIRECT and the ones to the LINES table are left to those functions. The search column of a
+ * VLOOKUP on the LINES table is resolved here, it's index is only calculated on load.
+ *
+ * @param a_ast compiled expression
+ */
+void casper::see::See::BindTables (casper::see::Ast& a_ast)
+{
+    for ( auto node : a_ast.allocated_nodes_ ) {
+        const std::vector<AstNode*>& args = node->args_;
+        std::string                  table_name;
+        std::string                  search_col;
+        std::string                  result_col;
+        int                          lines_col = -1;
+
+        switch ( node->type_ ) {
+
+            case AstNode::TLookup:
+                if ( AstNode::TToken != args[1]->type_ || AstNode::TToken != args[2]->type_ ) {
+                    continue;
+                }
+                Sum::ParseTableColRef(args[1]->value_.text_.c_str(), &table_name, &search_col);
+                Sum::ParseTableColRef(args[2]->value_.text_.c_str(), &table_name, &result_col);
+                if ( 0 == search_col.size() ) {
+                    search_col = args[1]->value_.aux_text_;
+                }
+                if ( 0 == result_col.size() ) {
+                    result_col = args[2]->value_.aux_text_;
+                }
+                break;
+
+            case AstNode::TVlookup:
+            case AstNode::TVlookupRange:
+                if ( AstNode::TToken != args[1]->type_ ) {
+                    continue;
+                }
+                Sum::ParseTableColRef(args[1]->value_.text_.c_str(), &table_name, &search_col);
+                if ( 0 == search_col.size() ) {
+                    search_col = args[1]->value_.aux_text_;
+                }
+                if ( 0 == strcasecmp(table_name.c_str(), "lines") ) {
+                    const ColumnInfo* search_column;
+                    const ColumnInfo* result_column;
+
+                    LinesVlookupColumns(search_col.c_str(), 0, search_column, result_column);
+                    lines_col = static_cast<int>(std::find(lines_columns_.begin(), lines_columns_.end(), search_column) - lines_columns_.begin());
+                }
+                break;
+
+            case AstNode::TSumVector:
+                if ( AstNode::TToken != args[0]->type_ || "LINES" == args[0]->value_.text_ ) {
+                    continue;
+                }
+                table_name = args[0]->value_.text_;
+                search_col = args[0]->value_.aux_text_;
+                break;
+
+            case AstNode::TSumIf:
+            case AstNode::TSumIfs:
+                if ( AstNode::TToken != args[0]->type_ ) {
+                    continue;
+                }
+                Sum::ParseTableColRef(args[0]->value_.text_.c_str(), &table_name, &search_col);
+                if ( 0 == search_col.size() ) {
+                    search_col = args[0]->value_.aux_text_;
+                }
+                if ( "LINES" == table_name || ( AstNode::TSumIf == node->type_ && 0 == strcasecmp(table_name.c_str(), "lines") ) ) {
+                    continue;
+                }
+                break;
+
+            default:
+                continue;
+        }
+
+        node->binding_ = std::make_shared<TableBinding>();
+        node->binding_->table_name_ = table_name;
+        node->binding_->search_col_ = search_col;
+        node->binding_->result_col_ = result_col;
+        node->binding_->lines_col_  = lines_col;
+    }
+}
+
+/**
+ * @brief Resolve the table and columns of a node bound by #BindTables
+ *
+ * The resolution is kept until a table is loaded or unloaded and is shared by the parallel calculations,
+ * a missing table is loaded by #GetTableByName. Invalid columns raise the errors the name based table
+ * functions would.
+ *
+ * @param a_node LOOKUP, VLOOKUP, SUM, SUMIF or SUMIFS node with a binding
+ */
+std::shared_ptr<const casper::see::BoundTable> casper::see::See::Bind (const casper::see::AstNode* a_node)
+{
+    TableBinding&  binding    = *a_node->binding_;
+    const uint64_t generation = tables_generation_.load();
+
+    std::shared_ptr<const BoundTable> bound = std::atomic_load(&binding.bound_);
+    if ( nullptr != bound && generation == bound->generation_ && false == bound->table_->IsPartialyLoaded() ) {
+        return bound;
+    }
+
+    std::shared_ptr<BoundTable> resolved = std::make_shared<BoundTable>();
+    Table*                      table    = GetTableByName(binding.table_name_.c_str());
+    const char*                 search   = binding.search_col_.c_str();
+
+    resolved->table_      = table;
+    resolved->search_col_ = 0;
+    resolved->result_col_ = -1;
+    resolved->generation_ = generation;
+
+    switch ( a_node->type_ ) {
+
+        case AstNode::TLookup:
+            if ( 0 != search[0] && -1 == ( resolved->search_col_ = table->GetColumnIndex(search) ) ) {
+                throw OSAL_EXCEPTION("'%s' is not a valid search column", search);
+            }
+            if ( -1 == ( resolved->result_col_ = table->GetColumnIndex(binding.result_col_.c_str()) ) ) {
+                throw OSAL_EXCEPTION("'%s' is not a valid result column", binding.result_col_.c_str());
+            }
+            break;
+
+        case AstNode::TVlookup:
+        case AstNode::TVlookupRange:
+            if ( 0 != search[0] && -1 == ( resolved->search_col_ = table->GetColumnIndex(search) ) ) {
+                throw OSAL_EXCEPTION("'%s' is not a valid result column", search);
+            }
+            break;
+
+        default: // ... SUM, SUMIF and SUMIFS ...
+            if ( -1 == ( resolved->search_col_ = table->GetColumnIndex(search) ) ) {
+                throw OSAL_EXCEPTION("table '%s' does not have '%s' column", table->GetName(), search);
+            }
+            break;
+    }
+
+    bound = resolved;
+    std::atomic_store(&binding.bound_, bound);
+    return bound;
+}
+
+/**
+ * @brief LOOKUP or VLOOKUP on a bound table, answered from the cache when the same search was already done
+ *
+ * The results of the running calculation are kept by it's #EvalContext, the shared #lookup_cache_ keeps
+ * them between calculations. The keys carry the table version so a table changed in place is searched
+ * again, loading or unloading a table drops everything. Tracked lookups and column numbers that are not
+ * numbers always go to the table.
+ *
+ * @param o_result    the lookup result
+ * @param a_table     the table and columns resolved by #Bind
+ * @param a_kind      LOOKUP, exact or range VLOOKUP
+ * @param a_value     the value to search
+ * @param a_col_index VLOOKUP result column, NULL for LOOKUP
+ */
+void casper::see::See::CachedLookup (casper::Term& o_result, const casper::see::BoundTable& a_table, casper::see::LookupCache::Kind a_kind,
+                                     casper::Term& a_value, casper::Term* a_col_index)
+{
+    Table* const table = a_table.table_;
+    int          column = a_table.result_col_;
+
+    const auto search = [&] () -> bool {
+        if ( nullptr == a_col_index ) {
+            return table->Lookup(o_result, a_value, a_table.search_col_, a_table.result_col_);
+        }
+        return table->Vlookup(o_result, a_value, a_table.search_col_, *a_col_index, LookupCache::EVlookupRange == a_kind);
+    };
+
+    if ( true == table->IsTrackingLookups() ) {
+        search();
+        return;
+    }
+    if ( nullptr != a_col_index ) {
+        const double number = a_col_index->ToNumber();
+        if ( std::isnan(number) || number < INT_MIN || number > INT_MAX ) {
+            search();
+            return;
+        }
+        column = (int) number;
+    }
+
+    LookupCache::Key   key;
+    LookupCache::Entry entry;
+    EvalContext&       context    = Context();
+    const uint64_t     generation = tables_generation_.load();
+
+    LookupCache::MakeKey(table, table->GetVersion(), a_table.search_col_, column, a_kind, a_value, key);
+
+    if ( generation != context.lookups_generation_ ) {
+        context.lookups_.clear();
+        context.lookups_generation_ = generation;
+    }
+
+    const auto it = context.lookups_.find(key);
+    if ( context.lookups_.end() != it ) {
+        entry = it->second;
+    } else if ( true == lookup_cache_.Find(key, generation, entry) ) {
+        context.lookups_[key] = entry;
+    } else {
+        lookup_cache_.Count(false);
+        entry.found_  = search();
+        entry.result_ = o_result;
+        context.lookups_[key] = entry;
+        lookup_cache_.Insert(key, generation, entry);
         return;
     }
 
-    tf.Start();
+    lookup_cache_.Count(true);
+    if ( true == entry.found_ ) {
+        o_result = entry.result_;
+    } else {
+        o_result.type_   = Term::ENan;
+        o_result.number_ = NAN;
+    }
+}
+
+/**
+ * @brief Run a compiled expression
+ *
+ * @param a_ast the expression tree created by #Compile
+ */
+void casper::see::See::Execute (casper::see::Ast& a_ast)
+{
+    Term         result;
+    EvalContext& context = Context();
+
+    context.result_.type_   = Term::ENan;
+    context.result_.number_ = 0;
+    context.result_.text_   = "";
+
+    context.expression_name_ = a_ast.Name();
+    Evaluate(a_ast.Root(), result);
+}
+
+/**
+ * @brief Evaluate one node of the expression tree
+ *
+ * Operands are evaluated from left to right before the node itself, just like the parser reductions
+ * did, the result starts with the value of the rule's first symbol (bison's $$ = $1) and each function
+ * receives private copies of the terminals so the compiled tree is never modified.
+ *
+ * @param a_node   the node to evaluate
+ * @param o_result receives the value of the node
+ */
+void casper::see::See::Evaluate (const casper::see::AstNode* a_node, casper::Term& o_result)
+{
+    const std::vector<AstNode*>& args = a_node->args_;
+
+    switch ( a_node->type_ ) {
+
+        case AstNode::TToken:
+            o_result = a_node->value_;
+            break;
+
+        case AstNode::TVariable:
+        {
+            if ( SlotTable::k_invalid_slot_ != a_node->slot_ && false == Context().check_dependencies_ ) {
+                const Term* value = Slots().Lookup(a_node->slot_);
+                if ( nullptr == value ) {
+                    throw OSAL_EXCEPTION("Variable %s not found", a_node->value_.text_.c_str());
+                }
+                o_result = *value;
+                break;
+            }
+
+            Term     name     = a_node->value_;
+            location location = a_node->location_;
+
+            o_result = a_node->value_;
+            GetVariable(o_result, name, location);
+            break;
+        }
+
+        case AstNode::TAssign:
+        {
+            Evaluate(args[0], o_result);
+            if ( SlotTable::k_invalid_slot_ != a_node->slot_ && false == Context().check_dependencies_ ) {
+                Slots()[a_node->slot_] = o_result;
+            } else {
+                Term     name     = a_node->value_;
+                location location = a_node->location_;
+
+                SetVariable(name, o_result, location);
+            }
+            Context().result_ = o_result;
+            break;
+        }
+
+        case AstNode::TExpression:
+            Evaluate(args[0], o_result);
+            Context().result_ = o_result;
+            break;
+
+        case AstNode::TCriteria:
+        {
+            Term value;
+
+            Evaluate(args[0], o_result);
+            Evaluate(args[1], value);
+            Context().sum_criterias_[o_result.aux_text_] = value;
+            break;
+        }
+
+        case AstNode::TCriteriaList:
+        {
+            Term criteria;
+
+            Evaluate(args[0], o_result);
+            Evaluate(args[1], criteria);
+            break;
+        }
+
+        case AstNode::TVlookup:
+        case AstNode::TVlookupRange:
+        {
+            Term         value, lookup_vector, col_index, range_lookup;
+            const size_t formula_length = a_node->text_.size();
+
+            const bool   bound          = ( nullptr != a_node->binding_ && false == Context().check_dependencies_ );
+
+            Evaluate(args[0], value);
+            if ( false == bound ) {
+                Evaluate(args[1], lookup_vector);
+            }
+            Evaluate(args[2], col_index);
+            if ( AstNode::TVlookupRange == a_node->type_ ) {
+                Evaluate(args[3], range_lookup);
+            }
+            o_result = a_node->value_;
+            if ( true == bound && -1 != a_node->binding_->lines_col_ ) {
+                LinesVlookup(o_result, value, *lines_columns_[a_node->binding_->lines_col_], col_index,
+                             AstNode::TVlookupRange == a_node->type_ ? range_lookup.ConvertToNumber() != 0 : false);
+                break;
+            }
+            if ( true == bound ) {
+                const std::shared_ptr<const BoundTable> table = Bind(a_node);
+                const bool range = ( AstNode::TVlookupRange == a_node->type_ ? range_lookup.ConvertToNumber() != 0 : false );
+                CachedLookup(o_result, *table, true == range ? LookupCache::EVlookupRange : LookupCache::EVlookupExact,
+                             value, &col_index);
+                break;
+            }
+            Vlookup(o_result, value, lookup_vector, col_index,
+                    AstNode::TVlookupRange == a_node->type_ ? range_lookup.ConvertToNumber() != 0 : false,
+                    a_node->text_.c_str(), formula_length);
+            break;
+        }
+
+        case AstNode::TLookup:
+        {
+            Term value, lookup_vector, result_vector;
+
+            Evaluate(args[0], value);
+            o_result = a_node->value_;
+            if ( nullptr != a_node->binding_ && false == Context().check_dependencies_ ) {
+                const std::shared_ptr<const BoundTable> table = Bind(a_node);
+                CachedLookup(o_result, *table, LookupCache::ELookup, value, nullptr);
+                break;
+            }
+            Evaluate(args[1], lookup_vector);
+            Evaluate(args[2], result_vector);
+            Lookup(o_result, value, lookup_vector, result_vector);
+            break;
+        }
+
+        case AstNode::TSumVector:
+        {
+            Term vector_ref;
+
+            o_result = a_node->value_;
+            if ( nullptr != a_node->binding_ && false == Context().check_dependencies_ ) {
+                const std::shared_ptr<const BoundTable> table = Bind(a_node);
+                o_result = table->table_->SumColumn(table->search_col_);
+                break;
+            }
+            Evaluate(args[0], vector_ref);
+            Sum(o_result, vector_ref);
+            break;
+        }
+
+        case AstNode::TSumRange:
+        {
+            Term cell_start = a_node->tokens_[0];
+            Term cell_end   = a_node->tokens_[1];
+
+            o_result = a_node->value_;
+            Sum(o_result, cell_start, cell_end);
+            break;
+        }
+
+        case AstNode::TSumIf:
+        {
+            Term         range, criteria;
+            const size_t formula_length = a_node->text_.size();
+
+            if ( nullptr != a_node->binding_ && false == Context().check_dependencies_ ) {
+                Evaluate(args[1], criteria);
+                o_result = a_node->value_;
+                const std::shared_ptr<const BoundTable> table = Bind(a_node);
+                table->table_->SumIf(o_result, table->search_col_, criteria);
+                break;
+            }
+            Evaluate(args[0], range);
+            Evaluate(args[1], criteria);
+            o_result = a_node->value_;
+            SumIf(o_result, range, criteria, a_node->text_.c_str(), formula_length);
+            break;
+        }
+
+        case AstNode::TSumIfs:
+        {
+            Term sum_range, criteria_list;
+
+            if ( nullptr != a_node->binding_ && false == Context().check_dependencies_ ) {
+                EvalContext& context = Context();
+
+                Evaluate(args[1], criteria_list);
+                o_result = a_node->value_;
+                const std::shared_ptr<const BoundTable> table = Bind(a_node);
+                table->table_->SumIfs(o_result, table->search_col_, context.sum_criterias_);
+                context.sum_criterias_.clear();
+                break;
+            }
+            Evaluate(args[0], sum_range);
+            Evaluate(args[1], criteria_list);
+            o_result = a_node->value_;
+            SumIfs(o_result, sum_range);
+            break;
+        }
+
+        case AstNode::TOffset:
+        {
+            Term ref, rows, cols;
+
+            Evaluate(args[0], ref);
+            Evaluate(args[1], rows);
+            Evaluate(args[2], cols);
+            o_result = a_node->value_;
+            Offset(o_result, ref, rows, cols);
+            break;
+        }
+
+        case AstNode::TMatch:
+        {
+            Term colname, unused;
+            Term tablename = a_node->tokens_[0];
+
+            Evaluate(args[0], colname);
+            Evaluate(args[1], unused);
+            o_result = a_node->value_;
+            TableHeaderMatch(o_result, colname, tablename);
+            break;
+        }
+
+        case AstNode::TTableCellRef:
+        {
+            if ( SlotTable::k_invalid_slot_ != a_node->slot_ && false == Context().check_dependencies_ ) {
+                o_result = Slots()[a_node->slot_];
+                o_result.aux_text_ = a_node->tokens_[0].text_;
+                break;
+            }
+
+            Term column_name = a_node->tokens_[0];
+
+            o_result = a_node->value_;
+            GetLinesTableValue(o_result, column_name);
+            o_result.aux_text_ = column_name.text_;
+            break;
+        }
+
+        case AstNode::TTableCellRefForOffset:
+        {
+            if ( SlotTable::k_invalid_slot_ != a_node->slot_ ) {
+                o_result = Slots()[a_node->slot_];
+                o_result.aux_text_ = a_node->tokens_[0].text_;
+                break;
+            }
+
+            EvalContext& context                = Context();
+            Term         column_name            = a_node->tokens_[0];
+            const bool   for_dependencies_check = context.check_dependencies_;
+
+            o_result = a_node->value_;
+            context.check_dependencies_ = false;
+            GetLinesTableValue(o_result, column_name);
+            context.check_dependencies_ = for_dependencies_check;
+            o_result.aux_text_ = column_name.text_;
+            break;
+        }
+
+        case AstNode::TVectorIndirect:
+            Evaluate(args[0], o_result);
+            o_result.aux_text_ = "";
+            break;
+
+        case AstNode::TSumIfCriteria:
+            Evaluate(args[0], o_result);
+            o_result.aux_condition_ = a_node->text_;
+            break;
+
+        /*
+         * Functions of one argument
+         */
+        case AstNode::TYear:
+        case AstNode::TMonth:
+        case AstNode::TDay:
+        case AstNode::THour:
+        case AstNode::TMinute:
+        case AstNode::TSecond:
+        case AstNode::TDateValue:
+        case AstNode::TAbs:
+        case AstNode::TIsError:
+        case AstNode::TUnaryMinus:
+        {
+            Term arg1;
+
+            Evaluate(args[0], arg1);
+            o_result = a_node->value_;
+            switch ( a_node->type_ ) {
+                case AstNode::TYear:        o_result.ExcelYear(arg1);      break;
+                case AstNode::TMonth:       o_result.ExcelMonth(arg1);     break;
+                case AstNode::TDay:         o_result.ExcelDay(arg1);       break;
+                case AstNode::THour:        o_result.ExcelHour(arg1);      break;
+                case AstNode::TMinute:      o_result.ExcelMinute(arg1);    break;
+                case AstNode::TSecond:      o_result.ExcelSecond(arg1);    break;
+                case AstNode::TDateValue:   o_result.ExcelDateValue(arg1); break;
+                case AstNode::TAbs:         o_result.Absolute(arg1);       break;
+                case AstNode::TIsError:     o_result.IsError(arg1);        break;
+                case AstNode::TUnaryMinus:  o_result.UnaryMinus(arg1);     break;
+                default:                                                   break;
+            }
+            break;
+        }
+
+        /*
+         * Functions of two arguments
+         */
+        case AstNode::TRound:
+        case AstNode::TRoundUp:
+        case AstNode::TRoundDown:
+        case AstNode::TFind:
+        case AstNode::TLeft:
+        case AstNode::TRight:
+        {
+            Term arg1, arg2;
+
+            Evaluate(args[0], arg1);
+            Evaluate(args[1], arg2);
+            o_result = a_node->value_;
+            switch ( a_node->type_ ) {
+                case AstNode::TRound:     o_result.Round(arg1, arg2);     break;
+                case AstNode::TRoundUp:   o_result.RoundUp(arg1, arg2);   break;
+                case AstNode::TRoundDown: o_result.RoundDown(arg1, arg2); break;
+                case AstNode::TFind:      o_result.Find(arg1, arg2);      break;
+                case AstNode::TLeft:      o_result.Left(arg1, arg2);      break;
+                case AstNode::TRight:     o_result.Right(arg1, arg2);     break;
+                default:                                                  break;
+            }
+            break;
+        }
+
+        /*
+         * Functions of three arguments
+         */
+        case AstNode::TDate:
+        case AstNode::TFindFrom:
+        case AstNode::TMid:
+        {
+            Term arg1, arg2, arg3;
+
+            Evaluate(args[0], arg1);
+            Evaluate(args[1], arg2);
+            Evaluate(args[2], arg3);
+            o_result = a_node->value_;
+            switch ( a_node->type_ ) {
+                case AstNode::TDate:     o_result.SetExcelDate(arg1, arg2, arg3); break;
+                case AstNode::TFindFrom: o_result.Find(arg1, arg2, arg3);         break;
+                case AstNode::TMid:      o_result.Mid(arg1, arg2, arg3);          break;
+                default:                                                          break;
+            }
+            break;
+        }
+
+        /*
+         * Conditionals, with short-circuit only the branch taken is evaluated, errors in the other branch are
+         * irrelevant just like in Excel. The dependency analysis always visits all branches.
+         */
+        case AstNode::TIf:
+        case AstNode::TIfTrue:
+        case AstNode::TIfCondition:
+        {
+            Term condition, value_if_true, value_if_false;
+
+            Evaluate(args[0], condition);
+            if ( true == short_circuit_ && false == Context().check_dependencies_ ) {
+                // ... same test as Term::If, converting the condition again yields the same number ...
+                if ( condition.ConvertToNumber() != 0.0 ) {
+                    if ( args.size() > 1 ) {
+                        Evaluate(args[1], value_if_true);
+                    }
+                    if ( args.size() > 2 ) {
+                        Context().skipped_expressions_ += args[2]->size_;
+                    }
+                } else {
+                    if ( args.size() > 1 ) {
+                        Context().skipped_expressions_ += args[1]->size_;
+                    }
+                    if ( args.size() > 2 ) {
+                        Evaluate(args[2], value_if_false);
+                    }
+                }
+            } else {
+                for ( size_t idx = 1; idx < args.size(); ++idx ) {
+                    Evaluate(args[idx], 1 == idx ? value_if_true : value_if_false);
+                }
+            }
+            o_result = a_node->value_;
+            switch ( a_node->type_ ) {
+                case AstNode::TIf:          o_result.If(condition, value_if_true, value_if_false); break;
+                case AstNode::TIfTrue:      o_result.If(condition, value_if_true);                 break;
+                case AstNode::TIfCondition: o_result.If(condition);                                break;
+                default:                                                                           break;
+            }
+            break;
+        }
+
+        case AstNode::TIfError:
+        {
+            Term value, value_if_error;
+
+            Evaluate(args[0], value);
+            if ( true == short_circuit_ && false == Context().check_dependencies_ && 0 == ( value.type_ & Term::EErrorMask ) ) {
+                Context().skipped_expressions_ += args[1]->size_;
+            } else {
+                Evaluate(args[1], value_if_error);
+            }
+            o_result = a_node->value_;
+            o_result.IfError(value, value_if_error);
+            break;
+        }
+
+        /*
+         * Excel propagates errors from any argument of AND and OR, the remaining argument can only be skipped
+         * when the arguments evaluated so far are already an error.
+         */
+        case AstNode::TAndList:
+        case AstNode::TOrList:
+        {
+            Term lhs, rhs;
+
+            Evaluate(args[0], lhs);
+            o_result = lhs;
+            if ( true == short_circuit_ && false == Context().check_dependencies_ && isnan(lhs.ConvertToNumber()) ) {
+                Context().skipped_expressions_ += args[1]->size_;
+            } else {
+                Evaluate(args[1], rhs);
+            }
+            if ( AstNode::TAndList == a_node->type_ ) {
+                o_result.And(lhs, rhs);
+            } else {
+                o_result.Or(lhs, rhs);
+            }
+            break;
+        }
+
+        case AstNode::TPercentage:
+        {
+            Term lhs;
+
+            Evaluate(args[0], lhs);
+            o_result = lhs;
+            o_result = lhs.Percentage();
+            break;
+        }
+
+        /*
+         * Binary operators and argument lists, the result starts as a copy of the left operand
+         */
+        default:
+        {
+            Term lhs, rhs;
+
+            Evaluate(args[0], lhs);
+            Evaluate(args[1], rhs);
+            o_result = lhs;
+            switch ( a_node->type_ ) {
+                case AstNode::TAdd:             o_result.Add(lhs, rhs);            break;
+                case AstNode::TSubtract:        o_result.Subtract(lhs, rhs);       break;
+                case AstNode::TMultiply:        o_result.Multiply(lhs, rhs);       break;
+                case AstNode::TDivide:          o_result.Divide(lhs, rhs);         break;
+                case AstNode::TPow:             o_result.Pow(lhs, rhs);            break;
+                case AstNode::TEqual:           o_result.Equal(lhs, rhs);          break;
+                case AstNode::TConcatenate:     o_result.Concatenate(lhs, rhs);    break;
+                case AstNode::TGreater:         o_result.Greater(lhs, rhs);        break;
+                case AstNode::TLess:            o_result.Less(lhs, rhs);           break;
+                case AstNode::TGreaterOrEqual:  o_result.GreaterOrEqual(lhs, rhs); break;
+                case AstNode::TLessOrEqual:     o_result.LessOrEqual(lhs, rhs);    break;
+                case AstNode::TNotEqual:        o_result.NotEqual(lhs, rhs);       break;
+                case AstNode::TMinList:         o_result.Minimum(lhs, rhs);        break;
+                case AstNode::TMaxList:         o_result.Maximum(lhs, rhs);        break;
+                case AstNode::TConcatenateList: o_result.Concatenate(lhs, rhs);    break;
+                default:
+                    throw OSAL_EXCEPTION("Unexpected expression node type %d", (int) a_node->type_);
+            }
+            break;
+        }
+    }
+}
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark ::: FORMULA CALCULATION :::
+#pragma mark -
+#endif
+
+/**
+ * @brief Public entry point to calculate one expression
+ *
+ * @param a_expression expression string
+ */
+void casper::see::See::Calculate (const char* a_expression, size_t a_len)
+{
+    Ast ast;
+
+    Compile(a_expression, a_len, ast);
+    main_context_.check_dependencies_ = false;
+    incremental_ready_  = false; // ... the expression may change any symbol ...
+    Execute(ast);
+
+    /*
+     * Keep the name based view up to date with the assigned variable
+     */
+    if ( 0 != ast.Name().length() ) {
+        const int32_t slot = slots_.Find(ast.Name());
+        if ( SlotTable::k_invalid_slot_ != slot && true == slots_.IsSet(slot) ) {
+            symtab_[ast.Name()] = slots_[slot];
+        }
+    }
+}
+
+/**
+ * @brief Public entry point to calculate the whole model
+ *
+ * @param a_params
+ */
+void casper::see::See::CalculateAll (const Json::Value& a_params)
+{
+    Term val;
+
+    /*
+     * A parameter that overrides a name used by the folded formulas disables the folding
+     */
+    calculate_folded_ = false;
+    for ( auto member : a_params.getMemberNames() ) {
+        if ( true == OverridesFolded(member) ) {
+            calculate_folded_ = true;
+            break;
+        }
+    }
+
+    /*
+     * Incremental mode, diff the parameters against the ones of the previous calculation
+     */
+    bool      incremental = ( true == incremental_ && true == incremental_ready_ && incremental_generation_ == tables_generation_.load()
+                              && false == track_lookups_ );
+    StringSet changed;
+    StringSet removed;
+    if ( true == incremental ) {
+        for ( auto member : a_params.getMemberNames() ) {
+            if ( false == previous_params_.isMember(member) || previous_params_[member] != a_params[member] ) {
+                changed.insert(member);
+            }
+        }
+        for ( auto member : previous_params_.getMemberNames() ) {
+            if ( false == a_params.isMember(member) ) {
+                if ( true == OverridesFolded(member) ) {
+                    incremental = false;
+                    break;
+                }
+                changed.insert(member);
+                removed.insert(member);
+            }
+        }
+    }
+    incremental_ready_ = false;
+
+    if ( false == incremental ) {
+        main_context_.sum_cache_slots_.clear();
+        /*
+         * Clear the symbol table and reload the "static" symbols created when the model was loaded
+         */
+        slots_.Invalidate();
+        size_t reference_idx = 0;
+        for ( SymbolTable::iterator it = reference_symtab_.begin(); it != reference_symtab_.end(); ++it ) {
+            slots_[reference_slots_[reference_idx++]] = it->second;
+        }
+    } else {
+        /*
+         * The SUMIF and SUMIFS results cached by criteria values may read cells that are calculated again
+         */
+        for ( auto slot : main_context_.sum_cache_slots_ ) {
+            slots_.Unset(slot);
+        }
+        main_context_.sum_cache_slots_.clear();
+        /*
+         * Parameters that are gone fallback to the value the model was loaded with
+         */
+        for ( auto member : removed ) {
+            const int32_t slot = slots_.Find(member);
+            if ( SlotTable::k_invalid_slot_ == slot ) {
+                continue;
+            }
+            const auto ref_it = reference_symtab_.find(member);
+            if ( reference_symtab_.end() != ref_it ) {
+                slots_[slot] = ref_it->second;
+            } else {
+                slots_.Unset(slot);
+            }
+        }
+    }
+
+    /*
+     * Clear tracked lookups.
+     */
+    track_filter_params_ = a_params;
+    for ( auto lt_it : lt_tables_ ) {
+        const auto table_it = tables_.find(lt_it.first);
+        if ( tables_.end() != table_it ) {
+            table_it->second->SetTrackLookups(lt_it.second, track_filter_params_);
+        }
+    }
+
+    // ... for all object members ...
+    for ( auto member : a_params.getMemberNames() ) {
+        // ... on an incremental run the unchanged parameters are already set ...
+        if ( true == incremental && changed.end() == changed.find(member) ) {
+            continue;
+        }
+        SetParameter(member, a_params[member], slots_);
+    }
+
+    if ( true == incremental ) {
+        if ( true == calculate_folded_ ) {
+            MarkFoldedDirty(changed);
+        }
+        MarkDirty(changed);
+    }
+
+    incremental_run_ = incremental;
+    try {
+        CalculateAll();
+    } catch (...) {
+        incremental_run_  = false;
+        calculate_folded_ = false;
+        symtab_stale_     = true;
+        throw;
+    }
+    incremental_run_   = false;
+    calculate_folded_  = false;
+    previous_params_        = a_params;
+    incremental_ready_      = true;
+    incremental_generation_ = tables_generation_.load();
+}
+
+/**
+ * @brief Write one calculation parameter to a symbol table
+ *
+ * @param a_member name of the parameter
+ * @param a_value  JSON value of the parameter
+ * @param o_slots  symbol table of the calculation
+ */
+void casper::see::See::SetParameter (const std::string& a_member, const Json::Value& a_value, casper::see::SlotTable& o_slots)
+{
+    ConvertParameter(a_member, a_value, o_slots[a_member]);
+}
+
+/**
+ * @brief Convert one calculation parameter to the term of it's model type
+ *
+ * @param a_member name of the parameter
+ * @param a_value  JSON value of the parameter
+ * @param o_term   receives the value
+ */
+void casper::see::See::ConvertParameter (const std::string& a_member, const Json::Value& a_value, casper::Term& o_term)
+{
+    bool        is_nullable = false;
+    std::string excel_type  = "";
+
+    // ... pick and keep track if it's value  ...
+    switch (a_value.type()) {
+        case Json::ValueType::nullValue:
+        {
+            casper::Term default_value = casper::Term(casper::Term::EUndefined);
+            const int model_type = GetParamType(a_member.c_str(), nullptr, is_nullable, excel_type, casper::Term::EUndefined);
+            if ( casper::Term::EUndefined == model_type ) {
+                throw OSAL_EXCEPTION("Type for scalar '%s' not defined!",
+                                     a_member.c_str()
+                );
+            }
+            SetDefaultTermValue(model_type, default_value);
+            o_term = default_value;
+            break;
+        }
+        case Json::ValueType::intValue:
+            o_term = static_cast<double>(a_value.asInt64());
+            break;
+        case Json::ValueType::uintValue:
+            o_term = static_cast<double>(a_value.asUInt64());
+            break;
+        case Json::ValueType::realValue:
+            o_term = static_cast<double>(a_value.asDouble());
+            break;
+        case Json::ValueType::stringValue:
+            o_term = a_value.asString();
+            break;
+        case Json::ValueType::booleanValue:
+            o_term = a_value.asBool();
+            break;
+        default:
+            throw OSAL_EXCEPTION("Unexpected scalar type %d for member name '%s'!", a_value.type(), a_member.c_str());
+    }
+}
+
+/**
+ * @brief Calculate the whole model with a context of the calling thread, the model is not changed
+ *
+ * Several threads can calculate the same loaded model at the same time, each with it's own context
+ * initialized by #InitContext. Lookup tracking, logging and the incremental mode are not available, the
+ * results are read with #SerializeScalarsToJSONObject(const EvalContext&, Json::Value&).
+ *
+ * @param a_params  the calculation parameters
+ * @param a_context the evaluation context of the calling thread
+ */
+void casper::see::See::CalculateAll (const Json::Value& a_params, casper::see::EvalContext& a_context)
+{
+    if ( nullptr == a_context.slots_ ) {
+        throw OSAL_EXCEPTION_NA("Evaluation context was not initialized by InitContext");
+    }
+    if ( true == track_lookups_ ) {
+        throw OSAL_EXCEPTION_NA("Lookup tracking is not available with a shared model");
+    }
+    if ( 0 != log_file_name_.length() ) {
+        throw OSAL_EXCEPTION_NA("Calculation logging is not available with a shared model");
+    }
+
+    SlotTable&   slots         = *a_context.slots_;
+    See*         owner         = tls_owner_;
+    EvalContext* context       = tls_context_;
+    bool         with_folded   = false;
+
+    tls_owner_   = this;
+    tls_context_ = &a_context;
+    a_context.skipped_expressions_ = 0;
+    a_context.sum_cache_slots_.clear();
+    a_context.ResetLookups();
+
+    try {
+        slots.Invalidate();
+        size_t reference_idx = 0;
+        for ( SymbolTable::iterator it = reference_symtab_.begin(); it != reference_symtab_.end(); ++it ) {
+            slots[reference_slots_[reference_idx++]] = it->second;
+        }
+        for ( auto member : a_params.getMemberNames() ) {
+            if ( false == with_folded ) {
+                with_folded = OverridesFolded(member);
+            }
+            SetParameter(member, a_params[member], slots);
+        }
+
+        if ( false == has_template_lines_ || 0 != lines_clones_count_ ) {
+            if ( true == with_folded ) {
+                for ( auto formula : folded_formulas_ ) {
+                    CalculateFormula(formula);
+                }
+            }
+            for ( auto formula : formulas_ ) {
+                CalculateFormula(formula);
+            }
+        }
+    } catch (...) {
+        tls_owner_   = owner;
+        tls_context_ = context;
+        throw;
+    }
+    tls_owner_   = owner;
+    tls_context_ = context;
+}
+
+/**
+ * @brief Prepare an evaluation context for #CalculateAll(const Json::Value&, EvalContext&)
+ *
+ * Must be called after the model and it's tables are loaded, the context gets it's own symbol table that
+ * shares the slots of the model. The partially loaded tables are completed here, the calculations of the
+ * contexts only read them.
+ *
+ * @param o_context the context to initialize
+ */
+void casper::see::See::InitContext (casper::see::EvalContext& o_context)
+{
+    LoadPartialTables();
+
+    o_context.slots_ = std::make_shared<SlotTable>();
+    o_context.slots_->Fork(slots_);
+    o_context.result_              = Term();
+    o_context.current_formula_     = nullptr;
+    o_context.skipped_expressions_ = 0;
+}
+
+void casper::see::See::CalculateAll ()
+{
+    osal::utils::Swatch tf;
+    int32_t col;
+    int32_t row;
+
+
+    if ( has_template_lines_ == true && 0 == lines_clones_count_ ) {
+        symtab_stale_ = true;
+        return;
+    }
+
+    tf.Start();
+    main_context_.skipped_expressions_ = 0;
+    main_context_.ResetLookups();
+    calculated_formulas_ = 0;
+
+    if ( 0 != log_file_name_.length() && nullptr == log_file_ ) {
+        log_file_ = fopen(log_file_name_.c_str(), "w");
+    }
+
+    if ( nullptr != worker_pool_ && nullptr == log_file_ && false == track_lookups_ ) {
+        LoadPartialTables();
+        CalculateLevels();
+    } else {
+        /*
+         * The folded formulas come first, they only depend on each other
+         */
+        const size_t folded_count = ( true == calculate_folded_ ? folded_formulas_.size() : 0 );
+
+        for ( size_t i = 0; i < folded_count + formulas_.size(); ++i ) {
+
+            Formula* formula = ( i < folded_count ? folded_formulas_[i] : formulas_[i - folded_count] );
+
+            if ( true == incremental_run_ ) {
+                if ( false == ( i < folded_count ? folded_dirty_[i] : dirty_[i - folded_count] ) ) {
+                    continue;
+                }
+                // ... forget the previous result, SUMIF, SUMIFS and VLOOKUP use it as a cache ...
+                slots_.Unset(formula->slot_);
+            }
+            calculated_formulas_ += 1;
+
+            // ... log formulas ...
+            if ( nullptr != log_file_ ) {
+                fprintf(log_file_, "--- %s[%s] : %s ---\n", formula->name_.c_str(), formula->alias_.c_str(), formula->type_.c_str());
+                fprintf(log_file_, "%s\n", formula->formula_.c_str());
+                for ( auto precedent : formula->precedents_ ) {
+                    const char* cell_ref;
+                    const auto n_it = name_to_cell_aliases_.find(precedent.c_str());
+                    std::string colname = "";
+
+                    if ( name_to_cell_aliases_.end() != n_it ) {
+                        cell_ref = n_it->second.c_str();
+                    } else {
+                        cell_ref = precedent.c_str();
+                    }
+                    if ( Sum::ParseCellRef(cell_ref, &col, &row) ) {
+                        if ( row >= (int32_t) (lines_clones_offset_ -1) && row < (int32_t) (lines_clones_offset_ + lines_clones_count_) ) {
+                            const auto cnit = column_name_index_.find(col);
+
+                            if ( cnit != column_name_index_.end() ) {
+                                colname = "(@" + cnit->second + ")";
+                            }
+                         }
+                    }
+                    const int32_t l_slot = slots_.Find(precedent);
+                    if ( SlotTable::k_invalid_slot_ != l_slot && true == slots_.IsSet(l_slot) ) {
+                        fprintf(log_file_, "\t%s%s=%s\n", precedent.c_str(), colname.c_str(), slots_[l_slot].DebugString().c_str());
+                    } else {
+                        fprintf(log_file_, "\t%s=%s\n", precedent.c_str(), "<wtf>");
+                    }
+                }
+                fflush(log_file_);
+            }
+            // ... end of formulas logging ...
+
+            CalculateFormula(formula);
+
+            DEBUGTRACE("see-calc", "%-150.150s %s", formula->formula_.c_str(), slots_[formula->slot_].ToString().c_str());
+
+            if ( nullptr != log_file_ ) {
+                fprintf(log_file_, "%s=%s\n", formula->name_.c_str(), Context().result_.DebugString().c_str());
+                fflush(log_file_);
+            }
+
+        }
+    }
+
+    if ( nullptr != log_file_ ) {
+        fflush(log_file_);
+    }
+
+    // ... the name based view is only built when it's read ...
+    symtab_stale_ = true;
+
+    tf.Stop();
+    if ( nullptr != log_file_ ) {
+        fprintf(log_file_, "--- %zu formulas calculated, %zu sub-expressions skipped ---\n", calculated_formulas_, main_context_.skipped_expressions_);
+        fflush(log_file_);
+    }
+    printf("Calculation time %ld ms\n", tf.Ticks() / 1000);
+}
+
+/**
+ * @brief Calculate the model for several parameter sets
+ *
+ * Meant for the same model evaluated for many employees, the first lane is calculated by #CalculateAll and
+ * only the formulas that depend on the parameters that differ between the lanes are calculated for the other
+ * lanes, all lanes at once, see #CalculateLanes. When the lanes don't have the same parameter names or the
+ * formulas to calculate sum the lines table, read cells by offset or override folded names the lanes are
+ * calculated one by one as incremental calculations.
+ *
+ * @param a_params  one parameters object per lane
+ * @param o_results receives the scalars of each lane, see #SerializeScalarsToJSONObject
+ */
+void casper::see::See::CalculateBatch (const std::vector<Json::Value>& a_params, std::vector<Json::Value>& o_results)
+{
+    o_results.resize(a_params.size());
+    if ( 0 == a_params.size() ) {
+        return;
+    }
+
+    CalculateAll(a_params[0]);
+    SerializeScalarsToJSONObject(o_results[0]);
+
+    /*
+     * Parameters that differ between the lanes
+     */
+    const Json::Value& first  = a_params[0];
+    bool               lanes  = ( true == incremental_ready_ && nullptr == log_file_ && false == track_lookups_
+                                  && false == ( true == has_template_lines_ && 0 == lines_clones_count_ ) );
+    StringSet          varying;
+    for ( size_t lane = 1; lane < a_params.size() && true == lanes; ++lane ) {
+        if ( a_params[lane].size() != first.size() ) {
+            lanes = false;
+            break;
+        }
+        for ( auto member : a_params[lane].getMemberNames() ) {
+            if ( false == first.isMember(member) ) {
+                lanes = false;
+                break;
+            }
+            if ( a_params[lane][member] != first[member] ) {
+                varying.insert(member);
+            }
+        }
+    }
+    for ( auto member : varying ) {
+        if ( true == OverridesFolded(member) ) {
+            lanes = false;
+            break;
+        }
+    }
+
+    /*
+     * The lane calculation only replays compiled formulas that read their operands from slots
+     */
+    if ( true == lanes ) {
+        MarkDirty(varying);
+        for ( size_t idx = 0; idx < formulas_.size(); ++idx ) {
+            if ( true == dirty_[idx] && ( true == serial_[idx] || Formula::EFormula != formulas_[idx]->GetKind() ) ) {
+                lanes = false;
+                break;
+            }
+        }
+    }
+
+    if ( true == lanes ) {
+        try {
+            CalculateLanes(a_params, varying, o_results);
+        } catch (...) {
+            incremental_ready_ = false;
+            symtab_stale_      = true;
+            throw;
+        }
+        return;
+    }
+
+    const bool incremental = incremental_;
+
+    incremental_ = true;
+    try {
+        for ( size_t lane = 1; lane < a_params.size(); ++lane ) {
+            CalculateAll(a_params[lane]);
+            SerializeScalarsToJSONObject(o_results[lane]);
+        }
+    } catch (...) {
+        incremental_ = incremental;
+        throw;
+    }
+    incremental_ = incremental;
+}
+
+#ifdef __APPLE__
+#pragma mark ... BATCH CALCULATION
+#endif
+
+/**
+ * @brief Calculate the formulas that depend on the parameters that differ between the lanes of a batch
+ *
+ * The slots hold the results of the first lane, the parameters that differ and the formulas that read them,
+ * marked in #dirty_, get one column per slot in a #LaneTable. A formula made only of the numeric operators
+ * is evaluated for all lanes at once by #EvaluateLanes, any other formula, or a lane whose operands are not
+ * plain numbers, is calculated lane by lane by #CalculateLane. The scalars of each lane are the ones of the
+ * first lane with the columns serialized over them.
+ *
+ * @param a_params  one parameters object per lane, with the same names
+ * @param a_varying names of the parameters that differ between the lanes
+ * @param o_results the scalars of the first lane, receives the scalars of the others
+ */
+void casper::see::See::CalculateLanes (const std::vector<Json::Value>& a_params, const casper::StringSet& a_varying,
+                                       std::vector<Json::Value>& o_results)
+{
+    const size_t         count = a_params.size();
+    LaneTable            lanes(count);
+    std::vector<uint8_t> scalar;
+    Term                 value;
+
+    for ( auto member : a_varying ) {
+        LaneValues column;
+
+        column.Resize(count);
+        for ( size_t lane = 0; lane < count; ++lane ) {
+            value = Term();
+            ConvertParameter(member, a_params[lane][member], value);
+            SetLane(column, lane, value);
+        }
+        lanes.Add(slots_.Resolve(member), std::move(column));
+    }
+
+    for ( size_t idx = 0; idx < formulas_.size(); ++idx ) {
+        if ( false == dirty_[idx] ) {
+            continue;
+        }
+
+        Formula* const formula = formulas_[idx];
+        const AstNode* root    = formula->ast_.Root();
+        LaneValues     column;
+
+        column.Resize(count);
+        if ( AstNode::TAssign == root->type_ && formula->slot_ == root->slot_ && true == IsLaneExpression(root, lanes) ) {
+            scalar.assign(count, 0);
+            EvaluateLanes(root, lanes, column, scalar);
+        } else {
+            scalar.assign(count, 1);
+        }
+        for ( size_t lane = 0; lane < count; ++lane ) {
+            if ( 0 != scalar[lane] ) {
+                CalculateLane(formula, lane, lanes, value);
+                SetLane(column, lane, value);
+            }
+        }
+        lanes.Add(formula->slot_, std::move(column));
+    }
+
+    /*
+     * The other lanes only differ from the first one by the columns
+     */
+    for ( size_t lane = 1; lane < count; ++lane ) {
+        o_results[lane] = o_results[0];
+        for ( size_t col = 0; col < lanes.Size(); ++col ) {
+            GetLane(lanes.Column(col), lane, value);
+            SerializeScalar(slots_.Name(lanes.Slot(col)), value, o_results[lane]);
+        }
+    }
+
+    // ... the slots are left with the last lane, it's parameters are the reference of the next incremental run ...
+    for ( size_t col = 0; col < lanes.Size(); ++col ) {
+        GetLane(lanes.Column(col), count - 1, slots_[lanes.Slot(col)]);
+    }
+    previous_params_ = a_params[count - 1];
+    symtab_stale_    = true;
+}
+
+/**
+ * @brief Calculate one formula for one lane with the scalar evaluator
+ *
+ * The columns of the slots the formula reads are copied to the symbol table first.
+ *
+ * @param a_formula the formula to calculate
+ * @param a_lane    the lane
+ * @param a_lanes   the values of the lanes calculated so far
+ * @param o_result  receives the result of the formula
+ */
+void casper::see::See::CalculateLane (casper::see::Formula* a_formula, size_t a_lane, const casper::see::LaneTable& a_lanes,
+                                      casper::Term& o_result)
+{
+    const auto load = [this, a_lane, &a_lanes] (int32_t a_slot) {
+        if ( SlotTable::k_invalid_slot_ == a_slot ) {
+            return;
+        }
+        const int32_t alias = slots_.Alias(a_slot);
+        for ( int32_t slot : { a_slot, alias } ) {
+            const LaneValues* column = ( SlotTable::k_invalid_slot_ != slot ? a_lanes.Find(slot) : nullptr );
+            if ( nullptr != column ) {
+                GetLane(*column, a_lane, slots_[slot]);
+            }
+        }
+    };
+
+    for ( auto slot : a_formula->precedent_slots_ ) {
+        load(slot);
+    }
+    for ( auto node : a_formula->ast_.allocated_nodes_ ) {
+        if ( AstNode::TVariable == node->type_ || AstNode::TTableCellRef == node->type_ ) {
+            load(node->slot_);
+        }
+    }
+
+    // ... forget the previous result like an incremental run does ...
+    slots_.Unset(a_formula->slot_);
+    CalculateFormula(a_formula);
+
+    const Term* result = slots_.Lookup(a_formula->slot_);
+    if ( nullptr == result ) {
+        throw OSAL_EXCEPTION("Formula %s didn't set it's result", a_formula->name_.c_str());
+    }
+    o_result = *result;
+}
+
+/**
+ * @brief Find where the lanes read a slot from, the same lookup as SlotTable::Lookup
+ *
+ * @param a_slot   the slot
+ * @param a_lanes  the values of the lanes calculated so far
+ * @param o_column receives the column of the slot, NULL when all lanes have the same value
+ * @param o_value  receives the value shared by all lanes
+ *
+ * @return false when the slot is not set
+ */
+bool casper::see::See::LaneSource (int32_t a_slot, const casper::see::LaneTable& a_lanes,
+                                   const casper::see::LaneValues*& o_column, const casper::Term*& o_value) const
+{
+    o_column = a_lanes.Find(a_slot);
+    o_value  = nullptr;
+    if ( nullptr != o_column ) {
+        return true;
+    }
+    if ( true == slots_.IsSet(a_slot) ) {
+        o_value = slots_.Lookup(a_slot);
+        return true;
+    }
+    const int32_t alias = slots_.Alias(a_slot);
+    if ( SlotTable::k_invalid_slot_ == alias ) {
+        return false;
+    }
+    o_column = a_lanes.Find(alias);
+    if ( nullptr == o_column ) {
+        o_value = slots_.Lookup(alias);
+    }
+    return nullptr != o_column || nullptr != o_value;
+}
+
+/**
+ * @return true if #EvaluateLanes can evaluate a node, it's made of numeric operators over numbers and
+ *         booleans
+ */
+bool casper::see::See::IsLaneExpression (const casper::see::AstNode* a_node, const casper::see::LaneTable& a_lanes) const
+{
+    switch ( a_node->type_ ) {
+        case AstNode::TToken:
+            return LaneValues::IsPlain(a_node->value_.type_);
+
+        case AstNode::TVariable:
+        {
+            const LaneValues* column;
+            const Term*       value;
+            if ( SlotTable::k_invalid_slot_ == a_node->slot_ || false == LaneSource(a_node->slot_, a_lanes, column, value) ) {
+                return false;
+            }
+            return nullptr != column || LaneValues::IsPlain(value->type_);
+        }
+
+        case AstNode::TAssign:
+            if ( SlotTable::k_invalid_slot_ == a_node->slot_ ) {
+                return false;
+            }
+            break;
+
+        case AstNode::TExpression:
+        case AstNode::TAdd:
+        case AstNode::TSubtract:
+        case AstNode::TMultiply:
+        case AstNode::TDivide:
+        case AstNode::TPow:
+        case AstNode::TUnaryMinus:
+        case AstNode::TAbs:
+        case AstNode::TRound:
+        case AstNode::TRoundUp:
+        case AstNode::TRoundDown:
+        case AstNode::TMinList:
+        case AstNode::TMaxList:
+        case AstNode::TEqual:
+        case AstNode::TNotEqual:
+        case AstNode::TGreater:
+        case AstNode::TLess:
+        case AstNode::TGreaterOrEqual:
+        case AstNode::TLessOrEqual:
+        case AstNode::TIf:
+        case AstNode::TIfTrue:
+        case AstNode::TIfCondition:
+            break;
+
+        default:
+            return false;
+    }
+    for ( auto arg : a_node->args_ ) {
+        if ( false == IsLaneExpression(arg, a_lanes) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Evaluate a node for all lanes, the numeric kernel of the batch calculation
+ *
+ * Each operator is one loop over the lanes, with the same arithmetic as the Term operator used by #Evaluate.
+ * Both IF branches are evaluated, the lanes where a value would not be a plain number, an operand that is not
+ * or a division by zero, are flagged to be calculated again by #CalculateLane.
+ *
+ * @param a_node    node accepted by #IsLaneExpression
+ * @param a_lanes   the values of the lanes calculated so far
+ * @param o_values  receives the value of the node for each lane
+ * @param io_scalar lanes that must be calculated by #CalculateLane
+ */
+void casper::see::See::EvaluateLanes (const casper::see::AstNode* a_node, const casper::see::LaneTable& a_lanes,
+                                      casper::see::LaneValues& o_values, std::vector<uint8_t>& io_scalar)
+{
+    const std::vector<AstNode*>& args  = a_node->args_;
+    const size_t                 count = a_lanes.Lanes();
+    double*   const              n     = o_values.numbers_.data();
+    unsigned* const              t     = o_values.types_.data();
+    uint8_t*  const              redo  = io_scalar.data();
+
+    switch ( a_node->type_ ) {
+
+        case AstNode::TToken:
+            std::fill(o_values.numbers_.begin(), o_values.numbers_.end(), a_node->value_.number_);
+            std::fill(o_values.types_.begin(), o_values.types_.end(), a_node->value_.type_);
+            return;
+
+        case AstNode::TVariable:
+        {
+            const LaneValues* column;
+            const Term*       value;
+            LaneSource(a_node->slot_, a_lanes, column, value);
+            if ( nullptr == column ) {
+                std::fill(o_values.numbers_.begin(), o_values.numbers_.end(), value->number_);
+                std::fill(o_values.types_.begin(), o_values.types_.end(), value->type_);
+                return;
+            }
+            o_values.numbers_ = column->numbers_;
+            o_values.types_   = column->types_;
+            for ( auto it : column->terms_ ) {
+                redo[it.first] = 1;
+            }
+            return;
+        }
+
+        case AstNode::TAssign:
+        case AstNode::TExpression:
+            EvaluateLanes(args[0], a_lanes, o_values, io_scalar);
+            return;
+
+        case AstNode::TUnaryMinus:
+        case AstNode::TAbs:
+            EvaluateLanes(args[0], a_lanes, o_values, io_scalar);
+            if ( AstNode::TUnaryMinus == a_node->type_ ) {
+                for ( size_t l = 0; l < count; ++l ) {
+                    n[l] = -n[l];
+                    t[l] = Term::ENumber;
+                }
+            } else {
+                for ( size_t l = 0; l < count; ++l ) {
+                    n[l]     = fabs(n[l]);
+                    t[l]     = Term::ENumber;
+                    redo[l] |= isnan(n[l]);
+                }
+            }
+            return;
+
+        case AstNode::TIf:
+        case AstNode::TIfTrue:
+        case AstNode::TIfCondition:
+        {
+            LaneValues if_true, if_false;
+
+            EvaluateLanes(args[0], a_lanes, o_values, io_scalar);
+            if_true.Resize(count);
+            if_false.Resize(count);
+            if ( args.size() > 1 ) {
+                EvaluateLanes(args[1], a_lanes, if_true, io_scalar);
+            } else {
+                std::fill(if_true.numbers_.begin(), if_true.numbers_.end(), 1.0);
+                std::fill(if_true.types_.begin(), if_true.types_.end(), Term::ENumber);
+            }
+            if ( args.size() > 2 ) {
+                EvaluateLanes(args[2], a_lanes, if_false, io_scalar);
+            } else {
+                std::fill(if_false.types_.begin(), if_false.types_.end(), Term::ENumber);
+            }
+            for ( size_t l = 0; l < count; ++l ) {
+                const bool condition = ( n[l] != 0.0 );
+                n[l] = condition ? if_true.numbers_[l] : if_false.numbers_[l];
+                t[l] = condition ? if_true.types_[l]   : if_false.types_[l];
+            }
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    /*
+     * Binary operators, the result is computed over the left operand
+     */
+    LaneValues rhs;
+
+    rhs.Resize(count);
+    EvaluateLanes(args[0], a_lanes, o_values, io_scalar);
+    EvaluateLanes(args[1], a_lanes, rhs, io_scalar);
+
+    const double*   const b  = rhs.numbers_.data();
+    const unsigned* const tb = rhs.types_.data();
+
+    switch ( a_node->type_ ) {
+        case AstNode::TAdd:
+            for ( size_t l = 0; l < count; ++l ) { n[l] = n[l] + b[l]; t[l] |= tb[l]; }
+            break;
+        case AstNode::TSubtract:
+            for ( size_t l = 0; l < count; ++l ) { n[l] = n[l] - b[l]; t[l] |= tb[l]; }
+            break;
+        case AstNode::TMultiply:
+            for ( size_t l = 0; l < count; ++l ) { n[l] = n[l] * b[l]; t[l] |= tb[l]; }
+            break;
+        case AstNode::TDivide:
+            for ( size_t l = 0; l < count; ++l ) {
+                redo[l] |= ( 0.0 == b[l] );
+                n[l]     = n[l] / b[l];
+                t[l]    |= tb[l];
+            }
+            break;
+        case AstNode::TPow:
+            for ( size_t l = 0; l < count; ++l ) { n[l] = pow(n[l], b[l]); t[l] |= tb[l]; }
+            break;
+        case AstNode::TRound:
+            for ( size_t l = 0; l < count; ++l ) {
+                const double m = osal::utils::Pow10((int) b[l]);
+                n[l]  = round(n[l] * m) / m;
+                t[l] |= tb[l];
+            }
+            break;
+        case AstNode::TRoundUp:
+            for ( size_t l = 0; l < count; ++l ) {
+                const double m = osal::utils::Pow10((int) b[l]);
+                n[l]  = ( n[l] >= 0.0 ? ceil(n[l] * m) : floor(n[l] * m) ) / m;
+                t[l] |= tb[l];
+            }
+            break;
+        case AstNode::TRoundDown:
+            for ( size_t l = 0; l < count; ++l ) {
+                const double m = osal::utils::Pow10((int) b[l]);
+                n[l]  = ( n[l] >= 0.0 ? floor(n[l] * m) : ceil(n[l] * m) ) / m;
+                t[l] |= tb[l];
+            }
+            break;
+        case AstNode::TMinList:
+            for ( size_t l = 0; l < count; ++l ) { n[l] = MIN(n[l], b[l]); t[l] |= tb[l]; }
+            break;
+        case AstNode::TMaxList:
+            for ( size_t l = 0; l < count; ++l ) { n[l] = MAX(n[l], b[l]); t[l] |= tb[l]; }
+            break;
+        case AstNode::TEqual:
+            for ( size_t l = 0; l < count; ++l ) { n[l] = ( n[l] == b[l] ? 1.0 : 0.0 ); t[l] = Term::EBoolean; }
+            break;
+        case AstNode::TNotEqual:
+            for ( size_t l = 0; l < count; ++l ) { n[l] = ( n[l] == b[l] ? 0.0 : 1.0 ); t[l] = Term::EBoolean; }
+            break;
+        case AstNode::TGreater:
+            for ( size_t l = 0; l < count; ++l ) { n[l] = ( n[l] > b[l] ? 1.0 : 0.0 ); t[l] = Term::EBoolean; }
+            break;
+        case AstNode::TLess:
+            for ( size_t l = 0; l < count; ++l ) { n[l] = ( n[l] < b[l] ? 1.0 : 0.0 ); t[l] = Term::EBoolean; }
+            break;
+        case AstNode::TGreaterOrEqual:
+            for ( size_t l = 0; l < count; ++l ) { n[l] = ( n[l] >= b[l] ? 1.0 : 0.0 ); t[l] = Term::EBoolean; }
+            break;
+        case AstNode::TLessOrEqual:
+            for ( size_t l = 0; l < count; ++l ) { n[l] = ( n[l] <= b[l] ? 1.0 : 0.0 ); t[l] = Term::EBoolean; }
+            break;
+        default:
+            throw OSAL_EXCEPTION("Unexpected lane expression node type %d", (int) a_node->type_);
+    }
+}
+
+/**
+ * @brief Store the value of one lane
+ */
+void casper::see::See::SetLane (casper::see::LaneValues& o_values, size_t a_lane, const casper::Term& a_value)
+{
+    o_values.types_[a_lane] = a_value.type_;
+    if ( true == LaneValues::IsPlain(a_value.type_) ) {
+        o_values.numbers_[a_lane] = a_value.number_;
+        o_values.terms_.erase(a_lane);
+    } else {
+        o_values.numbers_[a_lane] = NAN;
+        o_values.terms_[a_lane]   = a_value;
+    }
+}
+
+/**
+ * @brief Read the value of one lane
+ */
+void casper::see::See::GetLane (const casper::see::LaneValues& a_values, size_t a_lane, casper::Term& o_value)
+{
+    const auto it = a_values.terms_.find(a_lane);
+    if ( a_values.terms_.end() != it ) {
+        o_value = it->second;
+        return;
+    }
+    o_value = Term();
+    o_value.number_ = a_values.numbers_[a_lane];
+    o_value.type_   = a_values.types_[a_lane];
+}
+
+#ifdef __APPLE__
+#pragma mark ... INCREMENTAL CALCULATION
+#endif
+
+/**
+ * @brief Index the formulas by the names they use, called once the formula list is final
+ *
+ * #formulas_ is sorted so the dependents of a formula always have an higher index. The formulas are also
+ * grouped by dependency level for the parallel calculation, a formula that looks up symbols by name, reads
+ * a cell that may be undefined or converts the cells it sums in place can't run concurrently with the others
+ * and is flagged to be calculated by the calling thread.
+ */
+void casper::see::See::BuildDependents ()
+{
+    std::vector<size_t> level(formulas_.size(), 0);
+    std::vector<bool>   defined(slots_.Size(), false);
+
+    for ( auto slot : reference_slots_ ) {
+        defined[slot] = true;
+    }
+    for ( auto formula : formulas_ ) {
+        if ( SlotTable::k_invalid_slot_ != formula->slot_ ) {
+            defined[formula->slot_] = true;
+        }
+    }
+
+    dependents_.assign(formulas_.size(), IndexList());
+    volatile_.assign(formulas_.size(), false);
+    serial_.assign(formulas_.size(), false);
+    levels_.clear();
+    readers_.clear();
+    formula_index_.clear();
+    lines_sum_ifs_.clear();
+
+    for ( size_t idx = 0; idx < formulas_.size(); ++idx ) {
+        formula_index_[formulas_[idx]->name_] = idx;
+        if ( 0 != formulas_[idx]->alias_.length() ) {
+            formula_index_[formulas_[idx]->alias_] = idx;
+        }
+        if ( Formula::ESumIfs == formulas_[idx]->GetKind() ) {
+            lines_sum_ifs_[static_cast<const casper::see::SumIfs*>(formulas_[idx])->ColumnsKey()] = formulas_[idx];
+        }
+    }
+
+    for ( size_t idx = 0; idx < formulas_.size(); ++idx ) {
+        const Formula* formula = formulas_[idx];
+
+        for ( StringSet::const_iterator it = formula->precedents_.begin(); it != formula->precedents_.end(); ++it ) {
+            readers_[*it].push_back(idx);
+            const auto fi_it = formula_index_.find(*it);
+            if ( formula_index_.end() != fi_it && fi_it->second != idx ) {
+                dependents_[fi_it->second].push_back(idx);
+            }
+        }
+
+        // ... OFFSET reads cells that are not known in advance ...
+        for ( auto node : formula->ast_.allocated_nodes_ ) {
+            if ( AstNode::TOffset == node->type_ || AstNode::TTableCellRefForOffset == node->type_ ) {
+                volatile_[idx] = true;
+                serial_[idx]   = true;
+                break;
+            }
+            if (    ( AstNode::TVariable == node->type_ || AstNode::TAssign == node->type_ || AstNode::TTableCellRef == node->type_ )
+                 && SlotTable::k_invalid_slot_ == node->slot_ ) {
+                serial_[idx] = true;
+            }
+            // ... reading an undefined cell defines it ...
+            if ( AstNode::TTableCellRef == node->type_ && SlotTable::k_invalid_slot_ != node->slot_ && false == defined[node->slot_] ) {
+                serial_[idx] = true;
+            }
+            if ( AstNode::TSumIf == node->type_ || AstNode::TSumIfs == node->type_ ) {
+                serial_[idx] = true;
+            }
+        }
+        if ( true == formula->IsSum() || false == formula->ast_.IsCompiled() ) {
+            serial_[idx] = true;
+        }
+    }
+
+    // ... one level above the deepest precedent, the dependents are only complete once all formulas were visited ...
+    for ( size_t idx = 0; idx < formulas_.size(); ++idx ) {
+        for ( auto dependent : dependents_[idx] ) {
+            level[dependent] = std::max(level[dependent], level[idx] + 1);
+        }
+        if ( levels_.size() <= level[idx] ) {
+            levels_.resize(level[idx] + 1);
+        }
+        levels_[level[idx]].push_back(idx);
+    }
+}
+
+/**
+ * @brief Select the formulas an incremental calculation must calculate
+ *
+ * @param a_changed names of the parameters that changed since the previous calculation
+ */
+void casper::see::See::MarkDirty (const casper::StringSet& a_changed)
+{
+    dirty_ = volatile_;
+
+    for ( StringSet::const_iterator it = a_changed.begin(); it != a_changed.end(); ++it ) {
+        MarkDirty(*it);
+        const auto alias_it = aliases_.find(*it);
+        if ( aliases_.end() != alias_it ) {
+            MarkDirty(alias_it->second);
+        }
+        const auto cell_it = name_to_cell_aliases_.find(*it);
+        if ( name_to_cell_aliases_.end() != cell_it ) {
+            MarkDirty(cell_it->second);
+        }
+    }
+
+    /*
+     * Propagate in topological order
+     */
+    for ( size_t idx = 0; idx < formulas_.size(); ++idx ) {
+        if ( true == dirty_[idx] ) {
+            for ( auto dependent : dependents_[idx] ) {
+                dirty_[dependent] = true;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Mark the formulas that use a name, or assign it, as dirty
+ */
+void casper::see::See::MarkDirty (const std::string& a_name)
+{
+    const auto readers_it = readers_.find(a_name);
+    if ( readers_.end() != readers_it ) {
+        for ( auto idx : readers_it->second ) {
+            dirty_[idx] = true;
+        }
+    }
+    const auto fi_it = formula_index_.find(a_name);
+    if ( formula_index_.end() != fi_it ) {
+        dirty_[fi_it->second] = true;
+    }
+}
+
+/**
+ * @return true if a parameter overrides a name used by the folded formulas, directly or as an alias
+ */
+bool casper::see::See::OverridesFolded (const std::string& a_name) const
+{
+    if ( 0 == folded_precedents_.size() ) {
+        return false;
+    }
+    const auto alias_it = aliases_.find(a_name);
+    const auto cell_it  = name_to_cell_aliases_.find(a_name);
+    return folded_precedents_.end() != folded_precedents_.find(a_name)
+        || ( aliases_.end() != alias_it && folded_precedents_.end() != folded_precedents_.find(alias_it->second) )
+        || ( name_to_cell_aliases_.end() != cell_it && folded_precedents_.end() != folded_precedents_.find(cell_it->second) );
+}
+
+/**
+ * @brief Select the folded formulas an incremental calculation must calculate
+ *
+ * The folded formulas are not part of the dependency graph, the ones that read a changed name, directly or
+ * through another selected folded formula, are selected in load order.
+ *
+ * @param io_changed names of the parameters that changed, receives the names of the selected formulas
+ */
+void casper::see::See::MarkFoldedDirty (casper::StringSet& io_changed)
+{
+    StringSet names;
+
+    for ( StringSet::const_iterator it = io_changed.begin(); it != io_changed.end(); ++it ) {
+        names.insert(*it);
+        const auto alias_it = aliases_.find(*it);
+        if ( aliases_.end() != alias_it ) {
+            names.insert(alias_it->second);
+        }
+        const auto cell_it = name_to_cell_aliases_.find(*it);
+        if ( name_to_cell_aliases_.end() != cell_it ) {
+            names.insert(cell_it->second);
+        }
+    }
+
+    folded_dirty_.assign(folded_formulas_.size(), false);
+    for ( size_t idx = 0; idx < folded_formulas_.size(); ++idx ) {
+        const Formula* formula = folded_formulas_[idx];
+        bool           dirty   = ( names.end() != names.find(formula->name_)
+                                   || ( 0 != formula->alias_.length() && names.end() != names.find(formula->alias_) ) );
+
+        for ( StringSet::const_iterator it = formula->precedents_.begin(); it != formula->precedents_.end() && false == dirty; ++it ) {
+            dirty = ( names.end() != names.find(*it) );
+        }
+        if ( false == dirty ) {
+            continue;
+        }
+        folded_dirty_[idx] = true;
+        names.insert(formula->name_);
+        io_changed.insert(formula->name_);
+        if ( 0 != formula->alias_.length() ) {
+            names.insert(formula->alias_);
+            io_changed.insert(formula->alias_);
+        }
+    }
+}
+
+#ifdef __APPLE__
+#pragma mark ... PARALLEL CALCULATION
+#endif
 
-    if ( 0 != log_file_name_.length() && nullptr == log_file_ ) {
-        log_file_ = fopen(log_file_name_.c_str(), "w");
-    }
+/**
+ * @brief Calculate the formulas level by level, the formulas of a level are shared by the worker threads
+ *
+ * Each worker evaluates with it's own #EvalContext, the symbol table is shared as formulas of the same level
+ * write distinct slots and only read the slots of the previous levels.
+ */
+void casper::see::See::CalculateLevels ()
+{
+    IndexList batch;
+    IndexList serial;
+
+    const WorkerPool::Job job = [this, &batch] (size_t a_worker, size_t a_index) {
+        See* const         owner   = tls_owner_;
+        EvalContext* const context = tls_context_;
+
+        tls_owner_   = this;
+        tls_context_ = &worker_contexts_[a_worker];
+        try {
+            CalculateFormula(formulas_[batch[a_index]]);
+        } catch (...) {
+            tls_owner_   = owner;
+            tls_context_ = context;
+            throw;
+        }
+        tls_owner_   = owner;
+        tls_context_ = context;
+    };
 
-    for ( unsigned i = 0; i < formulas_.size(); ++i ) {
+    for ( auto& context : worker_contexts_ ) {
+        context.skipped_expressions_ = 0;
+        context.ResetLookups();
+    }
 
-        // ... log formulas ...
-        if ( nullptr != log_file_ ) {
-            fprintf(log_file_, "--- %s[%s] : %s ---\n", formulas_[i]->name_.c_str(), formulas_[i]->alias_.c_str(), formulas_[i]->type_.c_str());
-            fprintf(log_file_, "%s\n", formulas_[i]->formula_.c_str());
-            for ( auto precedent : formulas_[i]->precedents_ ) {
-                const char* cell_ref;
-                const auto n_it = name_to_cell_aliases_.find(precedent.c_str());
-                std::string colname = "";
-
-                if ( name_to_cell_aliases_.end() != n_it ) {
-                    cell_ref = n_it->second.c_str();
-                } else {
-                    cell_ref = precedent.c_str();
+    /*
+     * The folded formulas come first, they only depend on each other
+     */
+    if ( true == calculate_folded_ ) {
+        for ( size_t idx = 0; idx < folded_formulas_.size(); ++idx ) {
+            if ( true == incremental_run_ ) {
+                if ( false == folded_dirty_[idx] ) {
+                    continue;
                 }
-                if ( Sum::ParseCellRef(cell_ref, &col, &row) ) {
-                    if ( row >= (int32_t) (lines_clones_offset_ -1) && row < (int32_t) (lines_clones_offset_ + lines_clones_count_) ) {
-                        const auto cnit = column_name_index_.find(col);
+                slots_.Unset(folded_formulas_[idx]->slot_);
+            }
+            CalculateFormula(folded_formulas_[idx]);
+            calculated_formulas_ += 1;
+        }
+    }
 
-                        if ( cnit != column_name_index_.end() ) {
-                            colname = "(@" + cnit->second + ")";
-                        }
-                     }
-                }
-                const auto l_it = symtab_.find(precedent.c_str());
-                if ( symtab_.end() != l_it ) {
-                    fprintf(log_file_, "\t%s%s=%s\n", precedent.c_str(), colname.c_str(), l_it->second.DebugString().c_str());
-                } else {
-                    fprintf(log_file_, "\t%s=%s\n", precedent.c_str(), "<wtf>");
+    for ( auto& level : levels_ ) {
+        batch.clear();
+        serial.clear();
+        for ( auto idx : level ) {
+            if ( true == incremental_run_ ) {
+                if ( false == dirty_[idx] ) {
+                    continue;
                 }
+                // ... forget the previous result, SUMIF, SUMIFS and VLOOKUP use it as a cache ...
+                slots_.Unset(formulas_[idx]->slot_);
             }
-            fflush(log_file_);
+            if ( true == serial_[idx] ) {
+                serial.push_back(idx);
+            } else {
+                batch.push_back(idx);
+            }
+            calculated_formulas_ += 1;
         }
-        // ... end of formulas logging ...
+        worker_pool_->Run(batch.size(), job);
+        for ( auto idx : serial ) {
+            CalculateFormula(formulas_[idx]);
+        }
+    }
 
-        if ( formulas_[i]->IsSum() ) {
-            Term sum;
+    for ( auto& context : worker_contexts_ ) {
+        main_context_.skipped_expressions_ += context.skipped_expressions_;
+    }
+    if ( 0 != formulas_.size() && true == slots_.IsSet(formulas_.back()->slot_) ) {
+        main_context_.result_ = slots_[formulas_.back()->slot_];
+    }
+}
 
-            sum.number_ = formulas_[i]->SumAllTerms(symtab_, log_file_);
-            sum.type_   = Term::ENumber;
+/**
+ * @brief Calculate one formula, the result is stored in it's slot
+ *
+ * @param a_formula the formula to calculate
+ */
+void casper::see::See::CalculateFormula (casper::see::Formula* a_formula)
+{
+    if ( a_formula->IsSum() ) {
+        SlotTable& slots = Slots();
+        Term       sum;
 
-            symtab_[formulas_[i]->name_] = sum;
-            result_ = sum;
+        sum.number_ = a_formula->SumAllTerms(slots, log_file_);
+        sum.type_   = Term::ENumber;
 
-        } else {
-            current_formula_ = formulas_[i];
-            Calculate(current_formula_->formula_.c_str(), current_formula_->formula_.size());
-        }
+        slots[a_formula->slot_] = sum;
+        Context().result_ = sum;
 
-        DEBUGTRACE("see-calc", "%-150.150s %s", formulas_[i]->formula_.c_str(), symtab_[formulas_[i]->name_.c_str()].ToString().c_str());
+    } else if ( Formula::EVlookup == a_formula->GetKind() ) {
+        Term rows;
 
-        if ( nullptr != log_file_ ) {
-            fprintf(log_file_, "%s=%s\n", formulas_[i]->name_.c_str(), result_.DebugString().c_str());
-            fflush(log_file_);
-        }
+        // ... the lookups build their index, this formula only orders them after the cells they read ...
+        rows = static_cast<double>(lines_clones_count_);
+        Slots()[a_formula->slot_] = rows;
 
+    } else {
+        Context().current_formula_ = a_formula;
+        if ( false == a_formula->ast_.IsCompiled() ) {
+            // ... the parser belongs to the model ...
+            if ( &main_context_ != &Context() ) {
+                throw OSAL_EXCEPTION("Formula %s was not compiled when the model was loaded", a_formula->name_.c_str());
+            }
+            Compile(a_formula->formula_.c_str(), a_formula->formula_.size(), a_formula->ast_);
+            ResolveSlots(a_formula);
+        }
+        Execute(a_formula->ast_);
     }
+}
 
-    if ( nullptr != log_file_ ) {
-        fflush(log_file_);
+/**
+ * @brief Rebuild #symtab_, the name based view of the calculation symbol table, if a calculation ran since
+ *        it was last built
+ */
+void casper::see::See::RefreshSymbolTable ()
+{
+    if ( false == symtab_stale_ ) {
+        return;
     }
-
-    tf.Stop();
-    printf("Calculation time %ld ms\n", tf.Ticks() / 1000);
+    symtab_.clear();
+    slots_.CopyTo(symtab_);
+    symtab_stale_ = false;
 }
 
 void casper::see::See::GetVariable (Term& a_result,  Term& a_varname, casper::see::location&)
 {
-    if ( check_dependencies_ ) {
+    if ( Context().check_dependencies_ ) {
         AddDependency(a_varname);
     } else {
-        SymbolTable::const_iterator it = symtab_.find(a_varname.text_);
+        /*
+         * Slow path by name, compiled formulas read the slot directly
+         */
+        const SlotTable& slots = Slots();
+        const int32_t    slot  = slots.Find(a_varname.text_);
+        const Term*      value = ( SlotTable::k_invalid_slot_ != slot ? slots.Lookup(slot) : nullptr );
 
-        if ( it != symtab_.end() ) {
-            a_result = it->second;
-        } else {
-            StringHash::const_iterator sit = aliases_.find(a_varname.text_);
-            if ( sit == aliases_.end() ) {
-                throw OSAL_EXCEPTION("Variable %s not found", a_varname.text_.c_str());
-            } else {
-                it = symtab_.find(sit->second);
-                if ( it == symtab_.end() ) {
-                    throw OSAL_EXCEPTION("Variable %s not found", a_varname.text_.c_str());
-                }
-                a_result = it->second;
-            }
+        if ( nullptr == value ) {
+            throw OSAL_EXCEPTION("Variable %s not found", a_varname.text_.c_str());
         }
-
+        a_result = *value;
     }
 }
 
 void casper::see::See::SetVariable (Term& a_varname, Term& a_value, casper::see::location&)
 {
-    if ( check_dependencies_ ) {
+    if ( Context().check_dependencies_ ) {
         AddAlias(a_varname);
     } else {
-        symtab_[a_varname.text_] = a_value;
+        Slots()[a_varname.text_] = a_value;
     }
 }
 
@@ -1306,7 +3919,7 @@ void casper::see::See::Sum (Term& a_result, Term& a_vector_ref)
     char sztmp[300];
     snprintf(sztmp, sizeof(sztmp), "SUM(LINES[%s])", a_vector_ref.aux_text_.c_str());
 
-    if ( check_dependencies_ ) {
+    if ( Context().check_dependencies_ ) {
         if ( a_vector_ref.text_ == "LINES" ) {
             SymbolTable::iterator sym_it;
             ColumnHash::iterator  it;
@@ -1340,7 +3953,7 @@ void casper::see::See::Sum (Term& a_result, Term& a_vector_ref)
         }
     } else {
         if ( a_vector_ref.text_ == "LINES" ) {
-            a_result = symtab_[sztmp];
+            a_result = Slots()[sztmp];
         } else {
             a_result = GetTableByName(a_vector_ref.text_.c_str())->SumColumn(a_vector_ref.aux_text_.c_str());
         }
@@ -1352,13 +3965,18 @@ void casper::see::See::Sum (Term& a_result, Term& a_cell_start, Term& a_cell_end
     char sztmp[300];
     snprintf(sztmp, sizeof(sztmp), "SUM(%s:%s)", a_cell_start.text_.c_str(), a_cell_end.text_.c_str());
 
-    if ( check_dependencies_ ) {
+    if ( Context().check_dependencies_ ) {
         /*
          * Insert a dependency into the formula being analysed, used the convetioned sum name
          */
         temp_formula_->precedents_.insert(sztmp);
 
-        // TODO avoid formula duplicates ?
+        /*
+         * Prevent duplicates
+         */
+        if ( symtab_.find(sztmp) != symtab_.end() ) {
+            return;
+        }
 
         /*
          * Create a SUM formula and add to the formula list
@@ -1367,8 +3985,9 @@ void casper::see::See::Sum (Term& a_result, Term& a_cell_start, Term& a_cell_end
         sum->name_    = sztmp;
         sum->formula_ = sztmp;
         formulas_.push_back(sum);
+        symtab_[sztmp] = Term();
     } else {
-        a_result = symtab_[sztmp];
+        a_result = Slots()[sztmp];
     }
 }
 
@@ -1379,15 +3998,6 @@ void casper::see::See::Sum (Term& a_result, Term& a_cell_start, Term& a_cell_end
 void casper::see::See::SumIf (Term& a_result, const casper::Term& a_range, const casper::Term& a_criteria,
                               const char* const a_formula, const size_t& a_formula_length)
 {
-#if 1
-    // ... not working yet ...
-    OSAL_UNUSED_PARAM(a_result);
-    OSAL_UNUSED_PARAM(a_range);
-    OSAL_UNUSED_PARAM(a_criteria);
-    OSAL_UNUSED_PARAM(a_formula);
-    OSAL_UNUSED_PARAM(a_formula_length);
-    throw OSAL_EXCEPTION_NA("SUMIF is no supported!");
-#else
     TableHash::iterator it;
     std::string         table_name;
     std::string         lookup_col;
@@ -1397,21 +4007,26 @@ void casper::see::See::SumIf (Term& a_result, const casper::Term& a_range, const
      */
     Sum::ParseTableColRef(a_range.text_.c_str(), &table_name, &lookup_col);
 
+    /*
+     * If the colums are empty grab the value decomposed by the parser
+     */
+    if ( lookup_col.size() == 0 ) {
+        lookup_col = a_range.aux_text_;
+    }
+
     if ( 0 == strcasecmp(table_name.c_str(), "lines") ) {
         SumIfOnLinesTable(a_result, lookup_col.c_str(), a_criteria,
                           a_formula, a_formula_length);
     } else {
-        if ( false == check_dependencies_ ) {
-            // TODO: GetTableByName(table_name.c_str())->SumIf(a_result, lookup_col.c_str(), sum_criterias_);
-            throw OSAL_EXCEPTION("SUMIF for table '%s' not implemented!", table_name.c_str());
+        if ( false == Context().check_dependencies_ ) {
+            GetTableByName(table_name.c_str())->SumIf(a_result, lookup_col.c_str(), a_criteria);
         } else {
             /*
              * During dependency analysis this is a no-operation
              */
         }
     }
-    sum_criterias_.clear();
-#endif
+    Context().sum_criterias_.clear();
 }
 
 void casper::see::See::SumIf (Term& a_result, const casper::Term& a_range, const casper::Term& a_criteria, const casper::Term& a_sum_range,
@@ -1442,8 +4057,8 @@ void casper::see::See::SumIf (Term& a_result, const casper::Term& a_range, const
         SumIfOnLinesTable(a_result, lookup_col.c_str(), a_criteria,
                           a_formula, a_formula_length);
     } else {
-        if ( false == check_dependencies_ ) {
-            // GetTableByName(table_name.c_str())->SumIfs(a_result, lookup_col.c_str(), sum_criterias_);
+        if ( false == Context().check_dependencies_ ) {
+            // GetTableByName(table_name.c_str())->SumIfs(a_result, lookup_col.c_str(), Context().sum_criterias_);
             throw OSAL_EXCEPTION("SUMIF for table '%s' not implemented!", table_name.c_str());
         } else {
             /*
@@ -1451,7 +4066,7 @@ void casper::see::See::SumIf (Term& a_result, const casper::Term& a_range, const
              */
         }
     }
-    sum_criterias_.clear();
+    Context().sum_criterias_.clear();
 }
 
 #ifdef __APPLE__
@@ -1477,17 +4092,17 @@ void casper::see::See::SumIfs (Term& a_result, Term& a_sum_range)
     }
 
     if ( "LINES" == table_name ) {
-        SumIfsOnLinesTable(a_result, lookup_col.c_str(), sum_criterias_);
+        SumIfsOnLinesTable(a_result, lookup_col.c_str(), Context().sum_criterias_);
     } else {
-        if ( false == check_dependencies_ ) {
-            GetTableByName(table_name.c_str())->SumIfs(a_result, lookup_col.c_str(), sum_criterias_);
+        if ( false == Context().check_dependencies_ ) {
+            GetTableByName(table_name.c_str())->SumIfs(a_result, lookup_col.c_str(), Context().sum_criterias_);
         } else {
             /*
              * During dependency analysis this is a no-operation
              */
         }
     }
-    sum_criterias_.clear();
+    Context().sum_criterias_.clear();
 }
 
 #ifdef __APPLE__
@@ -1497,7 +4112,8 @@ void casper::see::See::SumIfs (Term& a_result, Term& a_sum_range)
 void casper::see::See::SumIfOnLinesTable (Term& a_result,  const char* a_sum_column, const Term& a_criteria,
                                           const char* const a_formula, const size_t& a_formula_length)
 {
-    casper::see::Formula* formula = ( true == check_dependencies_ ? temp_formula_ : current_formula_ );
+    SlotTable&            slots   = Slots();
+    casper::see::Formula* formula = ( true == Context().check_dependencies_ ? temp_formula_ : Context().current_formula_ );
     if ( nullptr == formula ) {
         throw OSAL_EXCEPTION_NA("Unable to calculate SUMIF - formula is nullptr!");
     }
@@ -1505,7 +4121,7 @@ void casper::see::See::SumIfOnLinesTable (Term& a_result,  const char* a_sum_col
     const std::string tmp_formula = std::string(a_formula, a_formula_length);
     const std::string key         = tmp_formula;
 
-    if ( true == check_dependencies_ ) {
+    if ( true == Context().check_dependencies_ ) {
 
         /*
          * Insert a dependency into the formula being analysed, used the conventioned sum name
@@ -1527,6 +4143,7 @@ void casper::see::See::SumIfOnLinesTable (Term& a_result,  const char* a_sum_col
         sum->name_     = key;
         sum->formula_  = tmp_formula;
         formulas_.push_back(sum);
+        symtab_[key] = Term();
     } else {
         /*
          * Use the cached value if available, if not calculate with the current criterias.
@@ -1534,17 +4151,26 @@ void casper::see::See::SumIfOnLinesTable (Term& a_result,  const char* a_sum_col
         SymbolTable table ;
         table[a_criteria.text_] = a_criteria;
 
-        if ( symtab_.find(key) == symtab_.end() ) {
-            a_result = current_formula_->SumIfAllTerms(symtab_, table, log_file_);
-            symtab_[key] = a_result;
+        const int32_t slot = slots.Resolve(key);
+        if ( false == slots.IsSet(slot) ) {
+            // ... an incremental run calculates the formula that reads the sum without the one that cached it ...
+            Formula*   sum   = Context().current_formula_;
+            const auto fi_it = formula_index_.find(key);
+            if ( Formula::ESumIf != sum->GetKind() && formula_index_.end() != fi_it && Formula::ESumIf == formulas_[fi_it->second]->GetKind() ) {
+                sum = formulas_[fi_it->second];
+            }
+            a_result = sum->SumIfAllTerms(slots, table, log_file_);
+            slots[slot] = a_result;
+            Context().sum_cache_slots_.push_back(slot);
         } else {
-            a_result = symtab_[key];
+            a_result = slots[slot];
         }
     }
 }
 
 void casper::see::See::SumIfsOnLinesTable (Term& a_result, const char* a_sum_column, SymbolTable& a_criterias)
 {
+    SlotTable&           slots = Slots();
     ColumnHash::iterator index_it;
     char                 sztmp[300];
     int                  len;
@@ -1556,7 +4182,7 @@ void casper::see::See::SumIfsOnLinesTable (Term& a_result, const char* a_sum_col
     }
     len += snprintf(sztmp + len, sizeof(sztmp) - len, ")");
 
-    if ( true == check_dependencies_ ) {
+    if ( true == Context().check_dependencies_ ) {
         SymbolTable::iterator sym_it;
         Term dummy;
 
@@ -1580,15 +4206,26 @@ void casper::see::See::SumIfsOnLinesTable (Term& a_result, const char* a_sum_col
         sum->name_     = sztmp;
         sum->formula_  = sztmp;
         formulas_.push_back(sum);
+        symtab_[sztmp] = dummy;
     } else {
         /*
          * Use the cached value if available, if not calculate with the current criterias.
          */
-        if ( symtab_.find(sztmp) == symtab_.end() ) {
-            a_result = current_formula_->SumIfAllTerms(symtab_, a_criterias, log_file_);
-            symtab_[sztmp] = a_result;
+        const int32_t slot = slots.Resolve(sztmp);
+        if ( false == slots.IsSet(slot) ) {
+            // ... an incremental run calculates the formula that reads the sum without the one that cached it ...
+            Formula* sum = Context().current_formula_;
+            if ( Formula::ESumIfs != sum->GetKind() ) {
+                const auto sum_it = lines_sum_ifs_.find(casper::see::SumIfs::ColumnsKey(a_sum_column, a_criterias));
+                if ( lines_sum_ifs_.end() != sum_it ) {
+                    sum = sum_it->second;
+                }
+            }
+            a_result = sum->SumIfAllTerms(slots, a_criterias, log_file_);
+            slots[slot] = a_result;
+            Context().sum_cache_slots_.push_back(slot);
         } else {
-            a_result = symtab_[sztmp];
+            a_result = slots[slot];
         }
     }
 }
@@ -1605,10 +4242,12 @@ void casper::see::See::SumIfsOnLinesTable (Term& a_result, const char* a_sum_col
 
 void casper::see::See::Offset (casper::Term& o_result, const casper::Term& a_ref, const casper::Term& a_rows, const casper::Term& a_cols)
 {
+    SlotTable& slots = Slots();
+
     o_result.type_   = casper::Term::ERef;
     o_result.number_ = NAN;
 
-    casper::see::Formula* formula = ( true == check_dependencies_ ? temp_formula_ : current_formula_ );
+    casper::see::Formula* formula = ( true == Context().check_dependencies_ ? temp_formula_ : Context().current_formula_ );
     if ( nullptr == formula ) {
         throw OSAL_EXCEPTION_NA("Unable to calculate cell reference offset - formula is nullptr!");
     }
@@ -1639,28 +4278,46 @@ void casper::see::See::Offset (casper::Term& o_result, const casper::Term& a_ref
         return;
     }
 
+    const int target_row = static_cast<int>(row) + static_cast<int>(a_rows.number_);
+    const int target_col = static_cast<int>(col) + static_cast<int>(a_cols.number_);
+
+    /*
+     * Cells of the lines table are read from the grid
+     */
+    if ( false == Context().check_dependencies_ ) {
+        const LinesGrid::Cell* cell = lines_grid_.At(target_row, target_col);
+        if ( nullptr != cell && SlotTable::k_invalid_slot_ != cell->ref_slot_ ) {
+            if ( false == slots.IsSet(cell->ref_slot_) && nullptr != cell->value_ ) {
+                o_result = *cell->value_;
+            } else {
+                o_result = slots[cell->ref_slot_];
+            }
+            return;
+        }
+    }
+
     char cell_ref[20] = { 0 };
 
-    see::Sum::MakeRowColRef(cell_ref, static_cast<int>(row) + static_cast<int>(a_rows.number_), static_cast<int>(col) + static_cast<int>(a_cols.number_));
+    see::Sum::MakeRowColRef(cell_ref, target_row, target_col);
 
-    if ( true == check_dependencies_ ) {
+    if ( true == Context().check_dependencies_ ) {
         formula->precedents_.insert(cell_ref);
     } else {
         StringHash::iterator cell_ref_to_name_it = name_to_cell_aliases_.find(cell_ref);
         if ( name_to_cell_aliases_.end() != cell_ref_to_name_it ) {
-            const auto value_it = symtab_.find(cell_ref_to_name_it->first);
-            if ( symtab_.end() != value_it ) {
-                o_result = value_it->second;
+            const int32_t slot = slots.Find(cell_ref_to_name_it->first);
+            if ( SlotTable::k_invalid_slot_ != slot && true == slots.IsSet(slot) ) {
+                o_result = slots[slot];
             } else {
                 auto it_2 = line_values_.find(cell_ref);
                 if ( line_values_.end() != it_2 ) {
                     o_result = it_2->second;
                 } else {
-                    o_result = symtab_[cell_ref];
+                    o_result = slots[cell_ref];
                 }
             }
         } else {
-            o_result = symtab_[cell_ref];
+            o_result = slots[cell_ref];
         }
     }
 }
@@ -1679,7 +4336,7 @@ void casper::see::See::Lookup (Term& a_result, Term& a_value, Term& a_lookup_vec
     /*
      * During dependency analysis this is a no-operation
      */
-    if ( true == check_dependencies_ ) {
+    if ( true == Context().check_dependencies_ ) {
         return;
     }
 
@@ -1709,9 +4366,6 @@ void casper::see::See::Lookup (Term& a_result, Term& a_value, Term& a_lookup_vec
 void casper::see::See::Vlookup (Term& a_result,  Term& a_value, Term& a_lookup_vector, Term& a_col_index, bool a_range_lookup,
                                 const char* const a_formula, const size_t& a_formula_length)
 {
-    OSAL_UNUSED_PARAM(a_formula);
-    OSAL_UNUSED_PARAM(a_formula_length);
-
     TableHash::iterator it;
     std::string         table_name;
     std::string         lookup_col;
@@ -1729,19 +4383,14 @@ void casper::see::See::Vlookup (Term& a_result,  Term& a_value, Term& a_lookup_v
         lookup_col = a_lookup_vector.aux_text_;
     }
 
-    if ( 0 == strcmp(table_name.c_str(), "lines") ) {
-#if 1
-        // ... not working yet ...
-        throw OSAL_EXCEPTION("VLOOKUP on '%s' table is no supported!", table_name.c_str());
-#else
+    if ( 0 == strcasecmp(table_name.c_str(), "lines") ) {
         LinesVlookup(a_result, a_value, lookup_col.c_str(), a_col_index, a_range_lookup,
                      a_formula, a_formula_length);
-#endif
     } else {
         /*
          * During dependency analysis this is a no-operation
          */
-        if ( true == check_dependencies_ ) {
+        if ( true == Context().check_dependencies_ ) {
             return;
         }
         GetTableByName(table_name.c_str())->Vlookup(a_result, a_value, lookup_col.c_str(), a_col_index, a_range_lookup);
@@ -1753,12 +4402,42 @@ void casper::see::See::Vlookup (Term& a_result,  Term& a_value, Term& a_lookup_v
 #endif
 
 void casper::see::See::GetLinesTableValue (Term& a_result, Term& a_column_name)
+{
+    const char* symbol_name;
+    char        cellref[20];
+
+    if ( false == Context().check_dependencies_ ) {
+        int32_t row, col;
+
+        LinesTableCell(a_column_name, row, col);
+        const LinesGrid::Cell* cell = lines_grid_.At(row, col);
+        if ( nullptr != cell && SlotTable::k_invalid_slot_ != cell->slot_ ) {
+            a_result = Slots()[cell->slot_];
+            return;
+        }
+    }
+
+    symbol_name = LinesTableSymbolName(a_column_name, cellref);
+
+    if ( Context().check_dependencies_ ) {
+        temp_formula_->precedents_.insert(symbol_name);
+    } else {
+        a_result = Slots()[symbol_name];
+    }
+}
+
+/**
+ * @brief Cell of a column of the row of the expression being evaluated
+ *
+ * @param a_column_name name of the LINES table column
+ * @param o_row         excel row of the expression
+ * @param o_col         excel column of @a a_column_name
+ */
+void casper::see::See::LinesTableCell (const Term& a_column_name, int32_t& o_row, int32_t& o_col)
 {
     ColumnHash::iterator cit;
     StringHash::iterator it;
-    const char*          symbol_name;
-    char                 cellref[20];
-    int32_t              col, row;
+    int32_t              col;
 
     cit = columns_.find(a_column_name.text_);
     if ( cit == columns_.end() ) {
@@ -1768,34 +4447,44 @@ void casper::see::See::GetLinesTableValue (Term& a_result, Term& a_column_name)
     /*
      * we need to figure out this expression row, 1st let's see if the expression is a cell reference
      */
-    if ( Sum::ParseCellRef(expression_name_.c_str(), &col, &row) == false ) {
+    if ( Sum::ParseCellRef(Context().expression_name_.c_str(), &col, &o_row) == false ) {
         /*
          * From the expression name try to grab the reference name
          */
-        it = name_to_cell_aliases_.find(expression_name_);
-        if ( it == name_to_cell_aliases_.end() || Sum::ParseCellRef(it->second.c_str(), &col, &row) == false ) {
-            throw OSAL_EXCEPTION("Unable to find the row to which expression '%s' belongs", expression_name_.c_str());
+        it = name_to_cell_aliases_.find(Context().expression_name_);
+        if ( it == name_to_cell_aliases_.end() || Sum::ParseCellRef(it->second.c_str(), &col, &o_row) == false ) {
+            throw OSAL_EXCEPTION("Unable to find the row to which expression '%s' belongs", Context().expression_name_.c_str());
         }
     }
+    o_col = cit->second.col_;
+}
+
+/**
+ * @brief Name of the symbol that holds a column of the row of the expression being evaluated
+ *
+ * @param a_column_name name of the LINES table column
+ * @param o_cellref     buffer for the cell reference
+ *
+ * @return the symbol name, either the cell reference or it's alias
+ */
+const char* casper::see::See::LinesTableSymbolName (const Term& a_column_name, char o_cellref[20])
+{
+    StringHash::iterator it;
+    int32_t              col, row;
+
+    LinesTableCell(a_column_name, row, col);
 
     /*
      * Now that we know the row of the lines table combine the row with the column numeric value
      * this will give is the cell reference, either it or the aliased value must give us the symboltable key
      */
-    Sum::MakeRowColRef(cellref, row, cit->second.col_);
+    Sum::MakeRowColRef(o_cellref, row, col);
 
-    it = aliases_.find(cellref);
+    it = aliases_.find(o_cellref);
     if ( it != aliases_.end() ) {
-        symbol_name = it->second.c_str();
-    } else {
-        symbol_name = cellref;
-    }
-
-    if ( check_dependencies_ ) {
-        temp_formula_->precedents_.insert(symbol_name);
-    } else {
-        a_result = symtab_[symbol_name];
+        return it->second.c_str();
     }
+    return o_cellref;
 }
 
 #ifdef __APPLE__
@@ -1915,47 +4604,66 @@ int casper::see::See::GetLineColumnType (const char* const a_ref, const char* co
 
 int casper::see::See::RewindScalarIterator ()
 {
+    RefreshSymbolTable();
     scalar_it_ = symtab_.begin();
     return row_count_;
 }
 
 bool casper::see::See::GetNextScalar (Json::Value& o_scalars)
+{
+    while ( scalar_it_ != symtab_.end() ) {
+        if ( true == SerializeScalar(scalar_it_->first, scalar_it_->second, o_scalars) ) {
+            ++scalar_it_;
+            break;
+        }
+        ++scalar_it_;
+    }
+    return scalar_it_ != symtab_.end();
+}
+
+/**
+ * @brief Serialize one symbol if it's a scalar, i.e. a cell above the lines table header
+ *
+ * @param a_name    symbol name
+ * @param a_value   symbol value
+ * @param o_scalars object that receives the scalar
+ *
+ * @return true if the symbol is a scalar
+ */
+bool casper::see::See::SerializeScalar (const std::string& a_name, const casper::Term& a_value, Json::Value& o_scalars)
 {
     const char* cellref;
     int         row, col;
     bool        is_nullable;
     std::string excel_type;
 
-    while ( scalar_it_ != symtab_.end() ) {
-        StringHash::iterator cell_it = name_to_cell_aliases_.find(scalar_it_->first.c_str());
-        if ( cell_it != name_to_cell_aliases_.end() ) {
-            cellref = cell_it->second.c_str();
-        } else {
-            cellref = scalar_it_->first.c_str();
-        }
-        if ( Sum::ParseCellRef(cellref, &col, &row) == true && row < table_header_row_ ) {
-            Json::Value scalar;
+    StringHash::iterator cell_it = name_to_cell_aliases_.find(a_name.c_str());
+    if ( cell_it != name_to_cell_aliases_.end() ) {
+        cellref = cell_it->second.c_str();
+    } else {
+        cellref = a_name.c_str();
+    }
+    if ( Sum::ParseCellRef(cellref, &col, &row) == false || row >= table_header_row_ ) {
+        return false;
+    }
 
-            auto type_it = scalars_types_map_.find(cellref);
-            if ( type_it == scalars_types_map_.end() ) {
-                throw OSAL_EXCEPTION("scalar %s type info not found", scalar_it_->first.c_str());
-            }
+    Json::Value scalar;
 
-            if ( scalar_it_->second.HasError() && not (scalar_it_->second.IsNull() && type_it->second.nullable_) ) {
-                throw OSAL_EXCEPTION("EXCEL_ERROR @scalar %s = %s", scalar_it_->first.c_str(), scalar_it_->second.ErrorMsg());
-            }
+    auto type_it = scalars_types_map_.find(cellref);
+    if ( type_it == scalars_types_map_.end() ) {
+        throw OSAL_EXCEPTION("scalar %s type info not found", a_name.c_str());
+    }
 
-            GetParamType(cellref, nullptr, is_nullable, excel_type);
+    if ( a_value.HasError() && not (a_value.IsNull() && type_it->second.nullable_) ) {
+        throw OSAL_EXCEPTION("EXCEL_ERROR @scalar %s = %s", a_name.c_str(), a_value.ErrorMsg());
+    }
 
-            SerializeTermToJSONValue(scalar_it_->second, type_it->second.term_, excel_type, scalar);
+    GetParamType(cellref, nullptr, is_nullable, excel_type);
 
-            o_scalars[(char*) scalar_it_->first.c_str()] = scalar;
-            ++scalar_it_;
-            break;
-        }
-        ++scalar_it_;
-    }
-    return scalar_it_ != symtab_.end();
+    SerializeTermToJSONValue(a_value, type_it->second.term_, excel_type, scalar);
+
+    o_scalars[(char*) a_name.c_str()] = scalar;
+    return true;
 }
 
 
@@ -1974,6 +4682,24 @@ void casper::see::See::SerializeScalarsToJSONObject (Json::Value& o_object)
     }
 }
 
+/**
+ * @brief Serialize the 'scalars' calculated with an evaluation context to a JSON object.
+ *
+ * @param a_context context passed to #CalculateAll
+ * @param o_object
+ */
+void casper::see::See::SerializeScalarsToJSONObject (const casper::see::EvalContext& a_context, Json::Value& o_object)
+{
+    SymbolTable symtab;
+
+    a_context.slots_->CopyTo(symtab);
+    o_object = Json::Value(Json::ValueType::objectValue);
+
+    for ( auto it = symtab.begin(); it != symtab.end(); ++it ) {
+        SerializeScalar(it->first, it->second, o_object);
+    }
+}
+
 /**
  * @brief Helper to sort output codes
  *
@@ -2146,8 +4872,8 @@ void casper::see::See::GetLine (int a_idx, Json::Value& o_row)
 /**
  * @brief Helper to grap an "excel cell" from the data model
  *
- * This is a bit hairy because we have aliases and the values are spread
- * between two diferent hashes (symbol table and line constants)
+ * The value calculated for the cell reference or it's alias, when neither is set the literal loaded with
+ * the lines table.
  *
  * @param a_row The row index starts at one
  * @param a_col The column index starts at one
@@ -2156,37 +4882,17 @@ void casper::see::See::GetLine (int a_idx, Json::Value& o_row)
  */
 const casper::Term* casper::see::See::GetCell (int a_row, int a_col)
 {
-    StringHash::iterator  ali_it;
-    SymbolTable::iterator sym_it;
-    char                  cell_reference[20];
-
-    Sum::MakeRowColRef(cell_reference, a_row, a_col);
-
-    /*
-     * 1st Look for a symbol with name of the cell ref
-     */
-    sym_it = symtab_.find(cell_reference);
-    if ( sym_it == symtab_.end() ) {
-        /*
-         * 2nd look for alias (a name that is equivalent to the cellref)
-         */
-        ali_it = aliases_.find(cell_reference);
-        if ( ali_it != aliases_.end() ) {
-            sym_it = symtab_.find(ali_it->second);
-        }
+    const LinesGrid::Cell* cell = lines_grid_.At(a_row, a_col);
+    if ( nullptr == cell ) {
+        return NULL;
     }
-    if ( sym_it != symtab_.end() ) {
-        return &sym_it->second;
-    } else {
-        /*
-         * 3rd shot, the value could be an immutable value loaded from the lines table
-         */
-        sym_it = line_values_.find(cell_reference);
-        if ( sym_it != line_values_.end() ) {
-            return &sym_it->second;
+    if ( SlotTable::k_invalid_slot_ != cell->ref_slot_ ) {
+        const Term* value = slots_.Lookup(cell->ref_slot_);
+        if ( nullptr != value ) {
+            return value;
         }
     }
-    return NULL;
+    return cell->value_;
 }
 
 /**
@@ -2302,6 +5008,8 @@ int casper::see::See::DataRowsCount () const
 
 const casper::Term* casper::see::See::GetParameter (const char* a_param_name)
 {
+    RefreshSymbolTable();
+
     SymbolTable::iterator it = symtab_.find(a_param_name);
 
     if ( it == symtab_.end() ) {
@@ -2335,18 +5043,36 @@ const casper::Term* casper::see::See::GetField (const char* a_field_name)
 #pragma mark ... LINES VLOOKUP
 #endif
 
+/**
+ * @brief VLOOKUP on the cloned lines of the LINES table
+ *
+ * The dependency analysis makes the formula depend on a #Vlookup formula per search and result column,
+ * that one depends on the cells of both columns. During the calculation the search column is copied to
+ * a #Table of the evaluation context by the first lookup that reads it, the exact and range lookups then
+ * use the indexes of that table. Like on the auxiliary tables the column index counts the LINES columns
+ * from the left, 1 being the first one.
+ */
 void casper::see::See::LinesVlookup (Term& a_result, const casper::Term& a_value, const char* const a_lookup_col, const casper::Term& a_result_index, bool a_range_lookup,
                                      const char* const a_formula, const size_t& a_formula_length)
 {
-    const std::string formula = std::string(a_formula, a_formula_length);
-    const std::string key     = formula;
+    OSAL_UNUSED_PARAM(a_formula);
+    OSAL_UNUSED_PARAM(a_formula_length);
+
+    if ( true == Context().check_dependencies_ ) {
 
-    if ( true == check_dependencies_ ) {
+        if ( 0 == ( a_result_index.type_ & Term::ENumber ) ) {
+            throw OSAL_EXCEPTION("VLOOKUP on the LINES table requires a constant column index, got '%s'", a_result_index.DebugString().c_str());
+        }
+
+        const int result_index = static_cast<int>(a_result_index.ToNumber());
+        char      key[300];
+
+        snprintf(key, sizeof(key), "VLOOKUP(LINES!%s;%d)", a_lookup_col, result_index);
 
         /*
-         * Insert a dependency into the formula being analysed, used the conventioned sum name
+         * Insert a dependency into the formula being analysed, used the conventioned lookup name
          */
-        temp_formula_->precedents_.insert(formula);
+        temp_formula_->precedents_.insert(key);
 
         /*
          * Prevent duplicates
@@ -2358,21 +5084,142 @@ void casper::see::See::LinesVlookup (Term& a_result, const casper::Term& a_value
         /*
          * Create a VLOOKUP formula and add to the formula list
          */
-        casper::see::Vlookup* vlookup = new casper::see::Vlookup(*this, a_lookup_col, static_cast<int>(a_result_index.ToNumber()));
+        casper::see::Vlookup* vlookup = new casper::see::Vlookup(*this, a_lookup_col, result_index);
         vlookup->name_     = key;
-        vlookup->formula_  = formula;
+        vlookup->formula_  = key;
         formulas_.push_back(vlookup);
+        symtab_[key] = Term();
+
     } else {
-        /*
-         * Use the cached value if available, if not calculate with the current criterias.
-         */
-        if ( symtab_.find(key) != symtab_.end() ) {
-            a_result = symtab_[key];
-        } else {
-            a_result = current_formula_->VLOOKUP(a_value, a_lookup_col, a_result_index, a_range_lookup);
-            symtab_[key] = a_result;
+
+        const ColumnInfo* search_column;
+        const ColumnInfo* result_column;
+
+        LinesVlookupColumns(a_lookup_col, 0, search_column, result_column);
+        LinesVlookup(a_result, a_value, *search_column, a_result_index, a_range_lookup);
+    }
+}
+
+/**
+ * @brief VLOOKUP on the LINES table with a search column resolved when the formula was compiled
+ *
+ * @param a_result        the lookup result, NaN when no row matches
+ * @param a_value         value to search
+ * @param a_search_column the search column
+ * @param a_result_index  result column, the LINES table columns are counted from the left, 1 being the first one
+ * @param a_range_lookup  true for a range lookup
+ */
+void casper::see::See::LinesVlookup (Term& a_result, const casper::Term& a_value, const casper::see::ColumnInfo& a_search_column,
+                                     const casper::Term& a_result_index, bool a_range_lookup)
+{
+    if ( 0 == ( a_result_index.type_ & Term::ENumber ) ) {
+        throw OSAL_EXCEPTION("'%s' is not valid index a number", a_result_index.DebugString().c_str());
+    }
+
+    const int result_index = static_cast<int>(a_result_index.ToNumber());
+
+    a_result.type_   = Term::ENan;
+    a_result.number_ = NAN;
+    if ( result_index < 1 || result_index > static_cast<int>(lines_columns_.size()) || 0 == lines_clones_count_ ) {
+        return;
+    }
+
+    const int row = LinesSearchIndex(Context(), a_search_column).LookupRow(a_value, a_range_lookup);
+    if ( -1 != row ) {
+        a_result = LinesCellValue(static_cast<int>(lines_clones_offset_) + row, lines_columns_[result_index - 1]->col_);
+    }
+}
+
+/**
+ * @brief Columns of a LINES table VLOOKUP
+ *
+ * @param a_search_column_name name of the search column, empty for the first column
+ * @param a_result_index       1 for the first column of the LINES table
+ * @param o_search_column      the search column
+ * @param o_result_column      the result column, NULL when the index is out of range
+ */
+void casper::see::See::LinesVlookupColumns (const char* const a_search_column_name, int a_result_index,
+                                            const casper::see::ColumnInfo*& o_search_column, const casper::see::ColumnInfo*& o_result_column) const
+{
+    o_search_column = nullptr;
+    if ( 0 == a_search_column_name[0] ) {
+        if ( 0 != lines_columns_.size() ) {
+            o_search_column = lines_columns_[0];
+        }
+    } else {
+        for ( auto column : lines_columns_ ) {
+            if ( 0 == strcasecmp(column->name_.c_str(), a_search_column_name) ) {
+                o_search_column = column;
+                break;
+            }
+        }
+    }
+    if ( nullptr == o_search_column ) {
+        throw OSAL_EXCEPTION("Column named '%s' is not a valid lookup column", a_search_column_name);
+    }
+
+    o_result_column = nullptr;
+    if ( a_result_index >= 1 && a_result_index <= static_cast<int>(lines_columns_.size()) ) {
+        o_result_column = lines_columns_[a_result_index - 1];
+    }
+}
+
+/**
+ * @brief Order the LINES table columns from the left, called once the #columns_ are loaded
+ */
+void casper::see::See::IndexLinesColumns ()
+{
+    lines_columns_.clear();
+    for ( ColumnHash::const_iterator it = columns_.begin(); it != columns_.end(); ++it ) {
+        lines_columns_.push_back(&it->second);
+    }
+    std::sort(lines_columns_.begin(), lines_columns_.end(), [] (const ColumnInfo* a_lhs, const ColumnInfo* a_rhs) {
+        return a_lhs->col_ < a_rhs->col_;
+    });
+}
+
+/**
+ * @brief Index of the search column values of the cloned lines in the running calculation
+ *
+ * The values are copied the first time the calculation searches the column, the #Vlookup formulas make
+ * sure the cells were already calculated. They are calculation results, the index keeps them as terms
+ * in the evaluation context so nothing is added to the StringPool.
+ *
+ * @param a_context the evaluation context of the calculation
+ * @param a_column  the LINES table search column
+ */
+const casper::see::LinesIndex& casper::see::See::LinesSearchIndex (casper::see::EvalContext& a_context, const casper::see::ColumnInfo& a_column)
+{
+    const auto it = a_context.lines_index_.find(a_column.col_);
+    if ( a_context.lines_index_.end() != it ) {
+        return it->second;
+    }
+
+    LinesIndex& index = a_context.lines_index_[a_column.col_];
+    const int   first = static_cast<int>(lines_clones_offset_);
+
+    for ( int row = first; row < first + static_cast<int>(lines_clones_count_); ++row ) {
+        index.Append(LinesCellValue(row, a_column.col_));
+    }
+    index.Build();
+    return index;
+}
+
+/**
+ * @brief Value of a LINES table cell in the running calculation
+ *
+ * @return the calculated value, the literal loaded with the lines table when the cell was not set
+ */
+const casper::Term& casper::see::See::LinesCellValue (int a_row, int a_col)
+{
+    const LinesGrid::Cell* cell = lines_grid_.At(a_row, a_col);
+    if ( nullptr != cell && SlotTable::k_invalid_slot_ != cell->ref_slot_ ) {
+        const Term* value = Slots().Lookup(cell->ref_slot_);
+        if ( nullptr != value ) {
+            return *value;
         }
     }
+    return lines_grid_.Literal(a_row, a_col);
 }
 
 #ifdef __APPLE__
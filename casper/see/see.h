@@ -23,16 +23,28 @@
 #define NRS_CASPER_CASPER_SEE_SEE_H
 
 #include "casper/see/parser.hh"
+#include "casper/see/ast.h"
+#include "casper/see/slot_table.h"
+#include "casper/see/eval_context.h"
+#include "casper/see/lane_table.h"
+#include "casper/see/lookup_cache.h"
+#include "casper/see/lines_grid.h"
+#include "casper/see/cell_index.h"
+#include "casper/see/worker_pool.h"
 #include "casper/see/see_scanner.h"
 #include "casper/see/formula.h"
 #include "casper/term.h"
 #include "casper/abstract_data_source.h"
 #include "json/json.h"
 #include "osal/exception.h"
+#include <atomic>
 #include <map>
+#include <memory>
 #include <vector>
 #include <set>
 #include <deque>
+#include <exception>
+#include <mutex>
 #include <tuple>
 
 namespace casper
@@ -41,6 +53,7 @@ namespace casper
     {
         class Formula;
         class Table;
+        struct BoundTable;
 
         typedef std::vector<std::string>              StringList;
 
@@ -63,11 +76,45 @@ namespace casper
             }
         };
 
+        /**
+         * @brief Leading tokens of a value expression, "name = literal", scanned once by the loader
+         *
+         * A new ValueScan matches the empty expression, which is not an assignment.
+         */
+        struct ValueScan
+        {
+            std::string expression_;  //!< The scanned expression
+            bool        assignment_;  //!< The expression starts with a name and '='
+            Term        name_;        //!< The name
+            int         token_;       //!< First token after the '=', 0 when there's none
+            Term        value_;       //!< Term of #token_
+            Term        literal_;     //!< Term after the '=' skipping a leading '-'
+
+            ValueScan ()
+            {
+                assignment_ = false;
+                token_      = 0;
+            }
+        };
+
+        typedef std::map<std::string, ValueScan>      ValueScanHash;
+
+        /**
+         * @brief Expression tree of a formula compiled ahead of it's loading, or the error of it's compilation
+         */
+        struct CompiledFormula
+        {
+            Ast                ast_;    //!< The compiled expression
+            std::exception_ptr error_;  //!< Exception thrown by the compilation, rethrown when the formula is loaded
+        };
+
         typedef std::vector<Formula*>                 FormulaList;
         typedef std::map<std::string, Table*>         TableHash;
         typedef std::map<std::string, ColumnInfo>     ColumnHash;
         typedef std::map<int, std::string>            ColumnNameIndex;
         typedef std::map<std::string, Term*>          TermPtrHash;
+        typedef std::vector<size_t>                   IndexList;
+        typedef std::map<std::string, IndexList>      IndexListHash;
 
         struct SlaveCloneInfo
         {
@@ -115,6 +162,15 @@ namespace casper
 
         /**
          * @brief Simple expression engine that evaluates excel models
+         *
+         * Thread safety: loading, configuration and #CalculateAll(const Json::Value&) use the state of the
+         * instance and must not run concurrently with any other call. Once the model is loaded any number of
+         * threads can call #CalculateAll(const Json::Value&, EvalContext&) and
+         * #SerializeScalarsToJSONObject(const EvalContext&, Json::Value&) at the same time, each with it's own
+         * context prepared by #InitContext. The formulas, tables and the symbol names are shared, each context
+         * only holds the values of one calculation. Tables are loaded on first use under a lock, they must not
+         * be loaded or unloaded explicitly while contexts are calculating, and the contexts must be initialized
+         * again after the model is reloaded.
          */
         class See : public AbstractDataSource
         {
@@ -129,25 +185,46 @@ namespace casper
             int                   row_count_;                   //!< Number of rows in table
             int                   table_header_row_;            //!< Excel row number of lines table header row, base is 1!!
 
+        protected: // Types
+
+            /**
+             * @brief Scanner and parser owned by one worker of #CompileInParallel
+             */
+            struct Compiler
+            {
+                Scanner scanner_;  //!< Term tokenizer/Scanner
+                Ast     ast_;      //!< Expression tree being built by the parser
+                Parser  parser_;   //!< Term gramar parser
+
+                Compiler () : parser_(scanner_, ast_) {}
+            };
+
         protected: // Data
 
-            bool                  check_dependencies_;          //!< true during the load phase, false during calculations
             SymbolTable           symtab_;                      //!< Symbol table a dictionary of Term nodes
+            bool                  symtab_stale_;                //!< #symtab_ doesn't hold the last calculation yet, see #RefreshSymbolTable
             Scanner               scanner_;                     //!< Term tokenizer/Scanner
+            Ast                   ast_;                         //!< Expression tree being built by the parser
             Parser                parser_;                      //!< Term gramar parser
             FormulaList           formulas_;                    //!< Array with pointers to all formulas
+            FormulaList           folded_formulas_;             //!< Formulas evaluated at load time, their values live in #reference_symtab_
+            StringSet             folded_precedents_;           //!< Names read or written by the folded formulas
+            bool                  calculate_folded_;            //!< A parameter overrides a folded name, evaluate #folded_formulas_ too
+            bool                  constant_folding_;            //!< Fold the formulas that don't depend on the parameters when loading
             SymbolTable           reference_symtab_;            //!< Holds the constant terms created by the loading process
+            SlotTable             slots_;                       //!< Symbol table used by the calculations, #symtab_ is it's name based view
+            std::vector<int32_t>  reference_slots_;             //!< Slots of the #reference_symtab_ entries in the same order
             SymbolTable           line_values_;                 //!< Keeps literals of the lines table
+            LinesGrid             lines_grid_;                  //!< Slots and literals of the lines table cells by row and column
+            CellIndex             cell_index_;                  //!< Defined cells by column and row, only while the sums dependencies are expanded
             StringSet             precedents_;                  //!< List of independent terms used by the formulas
             StringHash            aliases_;                     //!< Maps the cells to name mappings
             ColumnNameIndex       column_name_index_;           //!< Holds the names of the columns indexed by col number
             Formula*              temp_formula_;                //!< Temp holder for formula being loaded in dependency analysis
-            Formula*              current_formula_;             //!< Formula being calculated in calculation phase
             StringHash            name_to_cell_aliases_;        //!< Maps the formulas names to cells refs
             TableHash             tables_;                      //!< Holds the engine lookup tables
             ColumnHash            columns_;                     //!< Holds the definition of lines table columns
-            SymbolTable           sum_criterias_;               //!< List of criterias for SUMIFS (we only handle one at a time)
-            std::string           expression_name_;             //!< The name of the current left hand side variable being evaluated
+            std::vector<const ColumnInfo*> lines_columns_;      //!< The #columns_ from the left, VLOOKUP column indexes count them
             std::string           json_data_path_;              //!< Path to the folder with static JSON data
             std::string           json_tables_path_;            //!< Path to the folder with static JSON data
             SymbolTable::iterator scalar_it_;                   //!< Iterator to retrieve scalar results
@@ -157,7 +234,6 @@ namespace casper
             const char*           condition_col_name_;          //!< Name of the condition column (default "CONDICAO")
             bool                  has_template_lines_;          //!< The lines table contains template lines
             bool                  serialize_empty_str_as_null_; //!< Export empty strings as null
-            Json::Value           untouched_model_;             //!<
 
             size_t                lines_templates_start_idx_;   //!<
             size_t                lines_templates_end_idx_;     //!<
@@ -174,7 +250,34 @@ namespace casper
             std::map<std::string, TypeMapEntry> lines_columns_types_map_;
 
             bool                               track_lookups_;
+            bool                               short_circuit_;       //!< Only evaluate the IF / IFERROR branch taken
             Json::Value                        track_filter_params_;
+            bool                               incremental_;         //!< Only recalculate the formulas affected by changed parameters
+            bool                               incremental_ready_;   //!< The slots hold the results calculated for #previous_params_
+            uint64_t                           incremental_generation_; //!< #tables_generation_ the #previous_params_ results were calculated with
+            bool                               incremental_run_;     //!< The running #CalculateAll only calculates the #dirty_ formulas
+            Json::Value                        previous_params_;     //!< Parameters of the last successful #CalculateAll
+            std::vector<IndexList>             dependents_;          //!< For each formula the indexes of the formulas that use it's result
+            IndexListHash                      readers_;             //!< For each name the indexes of the formulas that use it
+            std::map<std::string, size_t>      formula_index_;       //!< Maps formula names and aliases to their index
+            std::map<std::string, Formula*>    lines_sum_ifs_;       //!< LINES SUMIFS formulas by sum and criteria columns, see SumIfs::ColumnsKey
+            std::vector<bool>                  volatile_;            //!< Formulas calculated on every run (OFFSET)
+            std::vector<bool>                  dirty_;               //!< Formulas to calculate on an incremental run
+            std::vector<bool>                  folded_dirty_;        //!< Folded formulas to calculate on an incremental run
+            size_t                             calculated_formulas_; //!< Formulas calculated by the last #CalculateAll
+            EvalContext                        main_context_;        //!< Evaluation state of the calling thread
+            std::vector<EvalContext>           worker_contexts_;     //!< Evaluation state of each #worker_pool_ worker
+            WorkerPool*                        worker_pool_;         //!< Threads for the parallel calculation, NULL to calculate serially
+            std::vector<IndexList>             levels_;              //!< Formula indexes by dependency level, a level only depends on the previous ones
+            std::vector<bool>                  serial_;              //!< Formulas that must be calculated by the calling thread
+            std::mutex                         tables_mutex_;        //!< Serializes the lazy table loading during parallel calculations
+            std::atomic<uint64_t>              tables_generation_;   //!< Changes when a table is loaded or unloaded, invalidates the resolved #TableBinding
+            LookupCache                        lookup_cache_;        //!< LOOKUP and VLOOKUP results of bound tables shared by the calculations
+            std::string                        model_cache_file_;    //!< Binary cache of the loaded model, empty to always load from JSON
+            uint64_t                           model_cache_hash_;    //!< Hash of the model being loaded, 0 when the cache is not written
+
+            static thread_local See*           tls_owner_;           //!< See being calculated by the current worker thread
+            static thread_local EvalContext*   tls_context_;         //!< Evaluation state of the current worker thread
 
             struct lt_tables_comparator {
                 bool operator() (const std::string& a_lhs, const std::string& a_rhs) const {
@@ -190,8 +293,6 @@ namespace casper
 
         public:
 
-            Term                  result_;               //!< Final result of expression calculation
-
         protected: // Methods
 
             void        AddDependency            (Term& a_varname);
@@ -200,17 +301,62 @@ namespace casper
             void        LoadModel                (Json::Value& a_model, StringMultiHash& a_clone_map,
                                                   const std::function<void(Json::Value& a_scalars)> a_patch_scalars = nullptr,
                                                   const std::function<void(Json::Value& a_lines, size_t& o_number_of_added_lines)> a_clone_lines = nullptr);
-            void        LoadFormula              (const char* a_expression, const char* a_alias);
+            void        LoadFormula              (const char* a_expression, const char* a_alias, CompiledFormula* a_compiled = nullptr);
+            void        CompileInParallel        (const std::vector<const char*>& a_expressions, std::vector<CompiledFormula>& o_compiled);
+            const ValueScan& ScanValue           (const std::string& a_expression, ValueScan& io_scan);
             void        LoadModelFromFile        (const char* a_filename, StringMultiHash& a_clone_map,
                                                   const std::function<void(Json::Value& a_scalars)> a_patch_scalars = nullptr,
                                                   const std::function<void(Json::Value& a_lines, size_t& o_number_of_added_lines)> a_clone_lines = nullptr);
             void        CalculateSumDependencies ();
             void        SortDependencies         ();
+            void        CompileFormulas          ();
+            void        Compile                  (const char* a_expression, size_t a_len, Ast& o_ast);
+            void        Parse                    (Scanner& a_scanner, Parser& a_parser, Ast& a_ast, const char* a_expression, size_t a_len, Ast& o_ast);
+            void        BindTables               (Ast& a_ast);
+            std::shared_ptr<const BoundTable> Bind (const AstNode* a_node);
+            void        CachedLookup             (Term& o_result, const BoundTable& a_table, LookupCache::Kind a_kind,
+                                                  Term& a_value, Term* a_col_index);
+            void        Execute                  (Ast& a_ast);
+            void        Evaluate                 (const AstNode* a_node, Term& o_result);
+            void        ResolveSlots             ();
+            void        ResolveSlots             (Formula* a_formula);
+            void        BuildLinesGrid           ();
+            void        LinesTableCell           (const Term& a_column_name, int32_t& o_row, int32_t& o_col);
+            const char* LinesTableSymbolName     (const Term& a_column_name, char o_cellref[20]);
+            void        RefreshSymbolTable       ();
+            void        CalculateFormula         (Formula* a_formula);
+            void        CalculateLevels          ();
+            EvalContext& Context                 ();
+            SlotTable&  Slots                    ();
+            void        SetParameter             (const std::string& a_member, const Json::Value& a_value, SlotTable& o_slots);
+            void        ConvertParameter         (const std::string& a_member, const Json::Value& a_value, Term& o_term);
+            bool        SerializeScalar          (const std::string& a_name, const Term& a_value, Json::Value& o_scalars);
+            void        FoldConstantFormulas     (const StringSet& a_constants);
+            bool        IsFoldable               (const Formula* a_formula, const StringSet& a_constants) const;
+            void        BuildDependents          ();
+            void        MarkDirty                (const StringSet& a_changed);
+            void        MarkDirty                (const std::string& a_name);
+            void        MarkFoldedDirty          (StringSet& io_changed);
+            bool        OverridesFolded          (const std::string& a_name) const;
+            void        CalculateLanes           (const std::vector<Json::Value>& a_params, const StringSet& a_varying,
+                                                  std::vector<Json::Value>& o_results);
+            void        CalculateLane            (Formula* a_formula, size_t a_lane, const LaneTable& a_lanes, Term& o_result);
+            bool        LaneSource               (int32_t a_slot, const LaneTable& a_lanes, const LaneValues*& o_column,
+                                                  const Term*& o_value) const;
+            bool        IsLaneExpression         (const AstNode* a_node, const LaneTable& a_lanes) const;
+            void        EvaluateLanes            (const AstNode* a_node, const LaneTable& a_lanes, LaneValues& o_values,
+                                                  std::vector<uint8_t>& io_scalar);
+            static void SetLane                  (LaneValues& o_values, size_t a_lane, const Term& a_value);
+            static void GetLane                  (const LaneValues& a_values, size_t a_lane, Term& o_value);
+            void        FinishLoading            (const StringSet& a_constants);
+            void        SaveModelCache           (const StringSet& a_constants);
+            bool        LoadModelCache           (uint64_t a_hash);
             bool        CloneLinesTableLines     (StringMultiHash& a_clone_map, Json::Value& a_lines_formulas, Json::Value& a_lines_value);
             const Term* GetCell                  (int a_row, int a_col);
 
             Table* GetTableByName                (const char* a_table_name);
             virtual Table* LoadTable             (const char* a_table_name, Table* a_partially_loaded_table);
+            void   LoadPartialTables             ();
 
             /*
              * Functions overridden in specializtion classes
@@ -259,6 +405,7 @@ namespace casper
             void SetJsonDataPath         (const char* a_json_data_path);
             void SetHashasTemplateLines  (bool a_has_template);
             void SetLogFile              (const char* const a_file);
+            void SetModelCacheFile       (const char* const a_file);
             void EnableLogging           ();
             void DisableLogging          ();
             virtual void LoadModel       (StringMultiHash& a_clone_map,
@@ -268,6 +415,9 @@ namespace casper
             void UnloadTable     (const std::string& a_table);
             void CalculateAll    (const Json::Value& a_params);
             void CalculateAll    ();
+            void InitContext     (EvalContext& o_context);
+            void CalculateAll    (const Json::Value& a_params, EvalContext& a_context);
+            void CalculateBatch  (const std::vector<Json::Value>& a_params, std::vector<Json::Value>& o_results);
 
             /*
              * Access to relevant information
@@ -292,12 +442,22 @@ namespace casper
             bool  GetNextScalar                (Json::Value& o_scalar);
             void  GetLine                      (int a_idx, Json::Value& o_row);
             void  SerializeScalarsToJSONObject (Json::Value& a_object);
+            void  SerializeScalarsToJSONObject (const EvalContext& a_context, Json::Value& o_object);
             Term& GetExpressionResult          ();
             int   RewindPaySlipRowIterator     ();
             bool  GetNextLine                  (Json::Value& o_row);
             void  SerializeTermToJSONValue     (const Term& a_term, const int a_type, const std::string& a_excel_type,
                                                 Json::Value& o_value);
             void  SetSerializeEmptyStrAsNull   (bool a_bool);
+            void  SetShortCircuit              (bool a_enabled);
+            size_t SkippedExpressionsCount     () const;
+            size_t FoldedFormulasCount         () const;
+            void  SetConstantFolding           (bool a_enabled);
+            void  SetIncremental               (bool a_enabled);
+            size_t CalculatedFormulasCount     () const;
+            void  SetCalculationThreads        (size_t a_count);
+            void  SetLookupCacheSize           (size_t a_entries);
+            void  GetLookupCacheStats          (uint64_t& o_hits, uint64_t& o_misses) const;
 
             const TableHash& Tables () const;
             void  SetTrackLookups   (const Json::Value& a_lt_tables, const Json::Value& a_params);
@@ -336,6 +496,13 @@ namespace casper
 
             void LinesVlookup (Term& a_result, const casper::Term& a_value, const char* const a_lookup_col, const casper::Term& a_result_index, bool a_range_lookup,
                                const char* const a_formula, const size_t& a_formula_length);
+            void LinesVlookup (Term& a_result, const casper::Term& a_value, const ColumnInfo& a_search_column, const casper::Term& a_result_index,
+                               bool a_range_lookup);
+            void LinesVlookupColumns (const char* const a_search_column_name, int a_result_index,
+                                      const ColumnInfo*& o_search_column, const ColumnInfo*& o_result_column) const;
+            void IndexLinesColumns   ();
+            const LinesIndex& LinesSearchIndex (EvalContext& a_context, const ColumnInfo& a_column);
+            const Term& LinesCellValue (int a_row, int a_col);
 
             void LoadTypes           (const Json::Value& a_object, std::map<std::string, TypeMapEntry>& o_types);
             void LoadValues          (const Json::Value& a_object, Json::Value& o_values, std::map<std::string, TypeMapEntry>* o_types);
@@ -360,6 +527,7 @@ namespace casper
         }
         inline SymbolTable See::getSymtab()
         {
+            RefreshSymbolTable();
             return symtab_;
         }
         inline StringSet See::getPrecedents()
@@ -390,9 +558,23 @@ namespace casper
             log_file_name_ = nullptr != a_file ? a_file : "";
         }
 
+        /**
+         * @brief Set the binary cache of the loaded model
+         *
+         * #LoadModelFromFile reads the cache instead of the JSON model when it was written by the same
+         * version of the engine for the same model file and clone map, otherwise the cache is rebuilt. Loads
+         * that patch the scalars or clone lines with callbacks don't use the cache.
+         *
+         * @param a_file cache file name, NULL or empty to disable the cache
+         */
+        inline void See::SetModelCacheFile (const char* const a_file)
+        {
+            model_cache_file_ = nullptr != a_file ? a_file : "";
+        }
+
         inline Term& See::GetExpressionResult ()
         {
-            return result_;
+            return main_context_.result_;
         }
 
         inline void See::SetHashasTemplateLines (bool a_has_template)
@@ -405,6 +587,80 @@ namespace casper
             serialize_empty_str_as_null_ = a_bool;
         }
 
+        /**
+         * @brief Enable or disable the short-circuit evaluation of IF, IFERROR, AND and OR
+         *
+         * When enabled (default) the branches that are not taken are not evaluated, like in Excel an error
+         * raised by a skipped branch has no effect on the result.
+         */
+        inline void See::SetShortCircuit (bool a_enabled)
+        {
+            short_circuit_ = a_enabled;
+        }
+
+        /**
+         * @return Number of sub-expressions skipped by the short-circuit evaluation during the last #CalculateAll
+         */
+        inline size_t See::SkippedExpressionsCount () const
+        {
+            return main_context_.skipped_expressions_;
+        }
+
+        /**
+         * @return Number of formulas that don't depend on the parameters and were evaluated when the model was loaded
+         */
+        inline size_t See::FoldedFormulasCount () const
+        {
+            return folded_formulas_.size();
+        }
+
+        /**
+         * @brief Enable or disable the constant folding of the models loaded afterwards
+         *
+         * Folding is enabled by default, disabling it calculates every formula on each #CalculateAll.
+         */
+        inline void See::SetConstantFolding (bool a_enabled)
+        {
+            constant_folding_ = a_enabled;
+        }
+
+        /**
+         * @brief Enable or disable the incremental calculation
+         *
+         * When enabled #CalculateAll compares the parameters with the ones of the previous call and only
+         * calculates the formulas that depend on the parameters that changed, all other results are kept.
+         */
+        inline void See::SetIncremental (bool a_enabled)
+        {
+            incremental_       = a_enabled;
+            incremental_ready_ = false;
+        }
+
+        /**
+         * @return Number of formulas calculated by the last #CalculateAll
+         */
+        inline size_t See::CalculatedFormulasCount () const
+        {
+            return calculated_formulas_;
+        }
+
+        /**
+         * @return Evaluation state of the calling thread
+         */
+        inline EvalContext& See::Context ()
+        {
+            return ( this == tls_owner_ ) ? *tls_context_ : main_context_;
+        }
+
+        /**
+         * @return Symbol table of the calculation running on the calling thread
+         */
+        inline SlotTable& See::Slots ()
+        {
+            EvalContext& context = Context();
+            return ( nullptr != context.slots_ ) ? *context.slots_ : slots_;
+        }
+
         inline const TableHash& See::Tables () const
         {
             return tables_;
@@ -426,6 +682,25 @@ namespace casper
             return track_lookups_;
         }
 
+        /**
+         * @brief Set the number of LOOKUP and VLOOKUP results kept between calculations
+         *
+         * @param a_entries maximum number of results, 0 only keeps the results of the running calculation
+         */
+        inline void See::SetLookupCacheSize (size_t a_entries)
+        {
+            lookup_cache_.SetCapacity(a_entries);
+        }
+
+        /**
+         * @brief Number of LOOKUP and VLOOKUP of bound tables answered from the cache and searched in the table
+         */
+        inline void See::GetLookupCacheStats (uint64_t& o_hits, uint64_t& o_misses) const
+        {
+            o_hits   = lookup_cache_.Hits();
+            o_misses = lookup_cache_.Misses();
+        }
+
     } // namespace see
 } // namespace casper
 
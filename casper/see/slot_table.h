@@ -0,0 +1,283 @@
+/**
+ * @file slot_table.h declaration of the slot indexed symbol table used during calculations
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#ifndef NRS_CASPER_CASPER_SEE_SLOT_TABLE_H
+#define NRS_CASPER_CASPER_SEE_SLOT_TABLE_H
+
+#include "casper/term.h"
+
+#include <algorithm> // std::fill
+#include <memory>    // std::shared_ptr
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace casper
+{
+    namespace see
+    {
+        /**
+         * @brief Symbol table indexed by dense integer slots
+         *
+         * Names are resolved to slots once, after the dependency analysis, the calculation then reads and writes
+         * the values by slot. A slot is either set or undefined, this mimics the presence of a key in a
+         * #SymbolTable, all values are undefined in one go by #Invalidate which just bumps the generation.
+         *
+         * The names, slots and aliases are kept in an index that is shared by the tables created by #Fork, it's
+         * copied before a table that shares it resolves a new name. Forked tables can be used by different threads.
+         */
+        class SlotTable
+        {
+        public: // Constants
+
+            static const int32_t k_invalid_slot_ = -1;
+
+        protected: // Data types
+
+            struct Index
+            {
+                std::vector<int32_t>                     aliases_;  //!< Slot that holds the value when this one is not set
+                std::vector<std::string>                 names_;    //!< Slot names, for the name based view and logging
+                std::unordered_map<std::string, int32_t> slots_;    //!< Maps names to slots
+            };
+
+        protected: // Data
+
+            std::shared_ptr<Index>                   index_;        //!< Names and aliases of the slots
+            std::vector<Term>                        values_;       //!< Slot values
+            std::vector<uint32_t>                    generations_;  //!< A slot is set when it's generation matches #generation_
+            uint32_t                                 generation_;   //!< Current generation
+
+        public: // Constructor(s) / Destructor
+
+            SlotTable ();
+            virtual ~SlotTable ();
+
+        public: // Method(s) / Function(s)
+
+            int32_t            Find       (const std::string& a_name) const;
+            int32_t            Resolve    (const std::string& a_name);
+            void               SetAlias   (int32_t a_slot, int32_t a_target);
+            int32_t            Alias      (int32_t a_slot) const;
+            const Term*        Lookup     (int32_t a_slot) const;
+            bool               IsSet      (int32_t a_slot) const;
+            void               Unset      (int32_t a_slot);
+            const std::string& Name       (int32_t a_slot) const;
+            size_t             Size       () const;
+            void               Invalidate ();
+            void               Clear      ();
+            void               CopyTo     (SymbolTable& o_symtab) const;
+            void               Fork       (const SlotTable& a_table);
+
+            Term& operator [] (int32_t a_slot);
+            Term& operator [] (const std::string& a_name);
+
+        protected: // Method(s) / Function(s)
+
+            void               Own        ();
+
+        };
+
+        /**
+         * @brief Constructor
+         */
+        inline SlotTable::SlotTable ()
+            : index_(std::make_shared<Index>())
+        {
+            generation_ = 1;
+        }
+
+        /**
+         * @brief Destructor
+         */
+        inline SlotTable::~SlotTable ()
+        {
+            /* empty */
+        }
+
+        /**
+         * @return the slot of a name, or #k_invalid_slot_ if the name was never resolved
+         */
+        inline int32_t SlotTable::Find (const std::string& a_name) const
+        {
+            const auto it = index_->slots_.find(a_name);
+            if ( index_->slots_.end() == it ) {
+                return k_invalid_slot_;
+            }
+            return it->second;
+        }
+
+        /**
+         * @return the slot of a name, a new undefined slot is created when needed
+         */
+        inline int32_t SlotTable::Resolve (const std::string& a_name)
+        {
+            const auto it = index_->slots_.find(a_name);
+            if ( index_->slots_.end() != it ) {
+                return it->second;
+            }
+
+            Own();
+            const int32_t slot = static_cast<int32_t>(values_.size());
+            values_.push_back(Term());
+            generations_.push_back(0);
+            index_->aliases_.push_back(k_invalid_slot_);
+            index_->names_.push_back(a_name);
+            index_->slots_[a_name] = slot;
+            return slot;
+        }
+
+        /**
+         * @brief Make @a a_slot fallback to the value of @a a_target when it's not set
+         */
+        inline void SlotTable::SetAlias (int32_t a_slot, int32_t a_target)
+        {
+            Own();
+            index_->aliases_[a_slot] = a_target;
+        }
+
+        /**
+         * @return the slot @a a_slot falls back to, #k_invalid_slot_ when it has no alias
+         */
+        inline int32_t SlotTable::Alias (int32_t a_slot) const
+        {
+            return index_->aliases_[a_slot];
+        }
+
+        /**
+         * @brief Read a value following the alias when the slot is not set
+         *
+         * @return the value or NULL if neither the slot or it's alias are set
+         */
+        inline const Term* SlotTable::Lookup (int32_t a_slot) const
+        {
+            if ( generation_ == generations_[a_slot] ) {
+                return &values_[a_slot];
+            }
+            const int32_t alias = index_->aliases_[a_slot];
+            if ( k_invalid_slot_ != alias && generation_ == generations_[alias] ) {
+                return &values_[alias];
+            }
+            return nullptr;
+        }
+
+        inline bool SlotTable::IsSet (int32_t a_slot) const
+        {
+            return generation_ == generations_[a_slot];
+        }
+
+        /**
+         * @brief Undefine one value
+         */
+        inline void SlotTable::Unset (int32_t a_slot)
+        {
+            generations_[a_slot] = 0;
+        }
+
+        inline const std::string& SlotTable::Name (int32_t a_slot) const
+        {
+            return index_->names_[a_slot];
+        }
+
+        inline size_t SlotTable::Size () const
+        {
+            return values_.size();
+        }
+
+        /**
+         * @brief Undefine all values, the slots remain valid
+         */
+        inline void SlotTable::Invalidate ()
+        {
+            if ( 0 == ++generation_ ) {
+                std::fill(generations_.begin(), generations_.end(), 0);
+                generation_ = 1;
+            }
+        }
+
+        /**
+         * @brief Forget all slots
+         */
+        inline void SlotTable::Clear ()
+        {
+            index_ = std::make_shared<Index>();
+            values_.clear();
+            generations_.clear();
+            generation_ = 1;
+        }
+
+        /**
+         * @brief Copy the values that are set to a name based symbol table
+         */
+        inline void SlotTable::CopyTo (SymbolTable& o_symtab) const
+        {
+            for ( size_t slot = 0; slot < values_.size(); ++slot ) {
+                if ( generation_ == generations_[slot] ) {
+                    o_symtab[index_->names_[slot]] = values_[slot];
+                }
+            }
+        }
+
+        /**
+         * @brief Share the slots of another table, all values are undefined
+         */
+        inline void SlotTable::Fork (const SlotTable& a_table)
+        {
+            index_ = a_table.index_;
+            values_.assign(a_table.values_.size(), Term());
+            generations_.assign(a_table.values_.size(), 0);
+            generation_ = 1;
+        }
+
+        /**
+         * @brief Access a slot value, like std::map::operator[] an undefined slot is set to an empty term
+         */
+        inline Term& SlotTable::operator [] (int32_t a_slot)
+        {
+            if ( generation_ != generations_[a_slot] ) {
+                values_[a_slot]      = Term();
+                generations_[a_slot] = generation_;
+            }
+            return values_[a_slot];
+        }
+
+        /**
+         * @brief Name based access, resolves the name first
+         */
+        inline Term& SlotTable::operator [] (const std::string& a_name)
+        {
+            return (*this)[Resolve(a_name)];
+        }
+
+        /**
+         * @brief Copy the index before changing it when other tables share it
+         */
+        inline void SlotTable::Own ()
+        {
+            if ( 1 != index_.use_count() ) {
+                index_ = std::make_shared<Index>(*index_);
+            }
+        }
+
+    } // namespace see
+} // namespace casper
+
+#endif // NRS_CASPER_CASPER_SEE_SLOT_TABLE_H
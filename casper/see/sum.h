@@ -51,9 +51,11 @@ namespace casper
         protected: // Methods
 
             virtual void   CalculateDependencies (See& a_see);
-            virtual double SumAllTerms           (SymbolTable& a_sym_tab, FILE* a_logfile);
+            virtual double SumAllTerms           (SlotTable& a_slots, FILE* a_logfile);
             virtual bool   IsSum                 () const;
             virtual bool   IsSumIfs              () const;
+            virtual Kind   GetKind               () const;
+            virtual void   Save                  (ModelCacheWriter& a_writer) const;
                     void   ExpandCellRefs        (See& a_aliases);
 
         public: // Static methods
@@ -66,6 +68,7 @@ namespace casper
 
                      Sum (const char* a_start_cellref, const char* a_end_cellref);
                      Sum (int a_row, int a_col, int a_row_count);
+                     Sum (ModelCacheReader& a_reader);
             virtual ~Sum ();
 
         };
@@ -78,6 +81,10 @@ namespace casper
         {
             return false;
         }
+        inline Formula::Kind Sum::GetKind () const
+        {
+            return ESum;
+        }
 
     } // namespace see
 } // namespace casper
@@ -48,6 +48,34 @@ casper::see::Sum::Sum (const char* a_start_cellref, const char* a_end_cellref)
     end_col_       = -1;
 }
 
+/**
+ * @brief Constructor, reads a sum written by #Save to the model cache
+ */
+casper::see::Sum::Sum (ModelCacheReader& a_reader)
+{
+    start_cellref_ = a_reader.ReadString();
+    end_cellref_   = a_reader.ReadString();
+    start_row_     = a_reader.ReadInt32();
+    start_col_     = a_reader.ReadInt32();
+    end_row_       = a_reader.ReadInt32();
+    end_col_       = a_reader.ReadInt32();
+    Restore(a_reader);
+}
+
+/**
+ * @brief Write the sum to the model cache
+ */
+void casper::see::Sum::Save (ModelCacheWriter& a_writer) const
+{
+    a_writer.Write(start_cellref_);
+    a_writer.Write(end_cellref_);
+    a_writer.Write(start_row_);
+    a_writer.Write(start_col_);
+    a_writer.Write(end_row_);
+    a_writer.Write(end_col_);
+    Formula::Save(a_writer);
+}
+
 void casper::see::Sum::ExpandCellRefs (See& a_see)
 {
     if ( ParseCellRef(start_cellref_.c_str(), &start_col_, &start_row_) == false ) {
@@ -95,11 +123,13 @@ casper::see::Sum::~Sum ()
     /* Empty */
 }
 
+/**
+ * @brief Depend on the defined cells of the range, by their cell reference and by the name they are aliased to
+ */
 void casper::see::Sum::CalculateDependencies (See& a_see)
 {
-    StringHash::iterator  ait;
-    SymbolTable::iterator sit;
-    char cell_ref[20];
+    const CellIndex::Cell* cells;
+    size_t                 count;
 
     precedents_.clear();
     if ( -1 == start_row_ ) {
@@ -107,17 +137,13 @@ void casper::see::Sum::CalculateDependencies (See& a_see)
     }
 
     for ( int32_t c = start_col_; c <= end_col_; ++c ) {
-        for ( int32_t r = start_row_; r <= end_row_; ++r ) {
-            MakeRowColRef(cell_ref, r, c);
-
-            sit = a_see.symtab_.find(cell_ref);
-            if ( sit != a_see.symtab_.end() ) {
-                precedents_.insert(sit->first);
+        count = a_see.cell_index_.Range(c, start_row_, end_row_, cells);
+        for ( size_t i = 0; i < count; ++i ) {
+            if ( nullptr != cells[i].symbol_ ) {
+                precedents_.insert(*cells[i].symbol_);
             }
-
-            ait = a_see.aliases_.find(cell_ref);
-            if ( ait != a_see.aliases_.end() ) {
-                precedents_.insert(ait->second);
+            if ( nullptr != cells[i].alias_ ) {
+                precedents_.insert(*cells[i].alias_);
             }
         }
     }
@@ -226,17 +252,19 @@ void casper::see::Sum::ParseTableColRef (const char* a_value, std::string* o_tab
     OSAL_UNUSED_PARAM(cell_table_col_ref_en_main);
 }
 
-double casper::see::Sum::SumAllTerms (SymbolTable& a_symtab, FILE* a_logfile)
+double casper::see::Sum::SumAllTerms (SlotTable& a_slots, FILE* a_logfile)
 {
     double sum;
 
     sum = 0;
-    for ( StringSet::iterator it = precedents_.begin(); it != precedents_.end(); ++it ) {
-        DEBUGTRACE("see-calc-sum", " += %-30.30s ....... %g", it->c_str(), a_symtab[*it].number_);
+    for ( size_t i = 0; i < precedent_slots_.size(); ++i ) {
+        Term& term = a_slots[precedent_slots_[i]];
+
+        DEBUGTRACE("see-calc-sum", " += %-30.30s ....... %g", a_slots.Name(precedent_slots_[i]).c_str(), term.number_);
         if ( a_logfile != NULL ) {
-            fprintf(a_logfile, " += %-30.30s ....... %g\n", it->c_str(), a_symtab[*it].number_);
+            fprintf(a_logfile, " += %-30.30s ....... %g\n", a_slots.Name(precedent_slots_[i]).c_str(), term.number_);
         }
-        sum += a_symtab[*it].ConvertToNumber();
+        sum += term.ConvertToNumber();
     }
     return sum;
 }
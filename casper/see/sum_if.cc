@@ -32,6 +32,30 @@ casper::see::SumIf::SumIf (const char* const a_sum_col, const char* const a_rang
     range_col_ = a_range_col;
 }
 
+/**
+ * @brief Constructor, reads a conditional sum written by #Save to the model cache
+ */
+casper::see::SumIf::SumIf (ModelCacheReader& a_reader)
+{
+    sum_col_   = a_reader.ReadString();
+    a_reader.Read(sum_rows_);
+    range_col_ = a_reader.ReadString();
+    a_reader.Read(range_cells_);
+    Restore(a_reader);
+}
+
+/**
+ * @brief Write the conditional sum to the model cache
+ */
+void casper::see::SumIf::Save (ModelCacheWriter& a_writer) const
+{
+    a_writer.Write(sum_col_);
+    a_writer.Write(sum_rows_);
+    a_writer.Write(range_col_);
+    a_writer.Write(range_cells_);
+    Formula::Save(a_writer);
+}
+
 /**
  * @brief Destructor
  */
@@ -40,70 +64,99 @@ casper::see::SumIf::~SumIf ()
     /* empty */
 }
 
+/**
+ * @brief Make the formula depend on the defined sum cells and on the range column term
+ *
+ * A row is kept when only one of the two is defined, the range cell of the row is kept with it.
+ */
 void casper::see::SumIf::CalculateDependencies (See& a_see)
 {
-    std::vector<std::string> dummy_vec;
-    StringHash::iterator     ait;
-    SymbolTable::iterator    sit;
-    char                     cell_ref[20];
-    int                      c, start_row, end_row;
-    size_t                   row_cnt;
-    
+    const std::string*     range_name = nullptr;
+    const CellIndex::Cell* cells;
+    size_t                 count;
+    size_t                 next;
+    char                   cell_ref[20];
+    int                    start_row, end_row;
+
     precedents_.clear();
+    sum_rows_.clear();
+    range_cells_.clear();
     start_row = a_see.columns_.begin()->second.row_ + 1;
     end_row   = start_row + a_see.row_count_;
-    row_cnt   = 0;
-    sum_rows_.push_back(dummy_vec);
+
+    const auto range_it = a_see.columns_.find(range_col_);
+    const auto sum_it   = a_see.columns_.find(sum_col_);
+    if ( range_it == a_see.columns_.end() || sum_it == a_see.columns_.end() ) {
+        throw OSAL_EXCEPTION("Column '%s' does not exist in the model's LINES table", ( range_it == a_see.columns_.end() ? range_col_ : sum_col_ ).c_str());
+    }
+
+    const StringHash::const_iterator ait = a_see.aliases_.find(range_col_);
+    if ( ait != a_see.aliases_.end() ) {
+        range_name = &ait->second;
+    } else {
+        const SymbolTable::const_iterator sit = a_see.symtab_.find(range_col_);
+        if ( sit != a_see.symtab_.end() ) {
+            range_name = &sit->first;
+        }
+    }
+    if ( nullptr != range_name && start_row <= end_row ) {
+        precedents_.insert(*range_name);
+    }
 
     /*
-     * Make the formula depend on all sum range and criteria cols terms that are defined
+     * Without the range term only the rows that define the sum cell are kept, with it only the others
      */
+    count = a_see.cell_index_.Range(sum_it->second.col_, start_row, end_row, cells);
+    next  = 0;
     for ( int32_t r = start_row; r <= end_row; ++r ) {
+        const std::string* sum_name = nullptr;
 
-        cell_ref[0] = '\0';
-        
-        c = a_see.columns_.find(range_col_)->second.col_;
-        Sum::MakeRowColRef(cell_ref, r, c);
-        range_cells_.push_back(cell_ref);
-        
-        c = a_see.columns_.find(sum_col_)->second.col_;
-        Sum::MakeRowColRef(cell_ref, r, c);
-
-        const std::vector<std::string> columns = { cell_ref, range_col_.c_str() };
-        for ( auto column : columns ) {
-            ait = a_see.aliases_.find(column);
-            if ( ait != a_see.aliases_.end() ) {
-                precedents_.insert(ait->second);
-                sum_rows_[row_cnt].push_back(ait->second);
-            } else {
-                sit = a_see.symtab_.find(column);
-                if ( sit != a_see.symtab_.end() ) {
-                    precedents_.insert(sit->first);
-                    sum_rows_[row_cnt].push_back(sit->first);
-                }
+        if ( next < count && cells[next].row_ == r ) {
+            sum_name = ( nullptr != cells[next].alias_ ? cells[next].alias_ : cells[next].symbol_ );
+            ++next;
+        } else if ( nullptr == range_name ) {
+            // ... skip to the next defined sum cell ...
+            if ( next == count ) {
+                break;
             }
+            r = cells[next].row_ - 1;
+            continue;
         }
 
-        if ( sum_rows_[row_cnt].size() == 1 ) {
-            sum_rows_.push_back(dummy_vec);
-            ++row_cnt;
-        } else {
-            sum_rows_[row_cnt].clear();
-            range_cells_.pop_back();
+        if ( nullptr != sum_name ) {
+            precedents_.insert(*sum_name);
+        }
+        if ( ( nullptr != sum_name ) == ( nullptr != range_name ) ) {
+            continue;
         }
-        
-    }
 
-    /*
-     * Trim the last row if it's not complete
-     */
-    if ( sum_rows_[row_cnt].size() != 1 ) {
-        sum_rows_.pop_back();
+        Sum::MakeRowColRef(cell_ref, r, range_it->second.col_);
+        range_cells_.push_back(cell_ref);
+        sum_rows_.push_back(std::vector<std::string>(1, nullptr != sum_name ? *sum_name : *range_name));
     }
 }
 
 
-double casper::see::SumIf::SumIfAllTerms (SymbolTable& a_symtab, SymbolTable& a_criterias, FILE* a_logfile)
+/**
+ * @brief Resolve the range and sum cells to symbol table slots
+ */
+void casper::see::SumIf::ResolveSlots (SlotTable& a_slots)
+{
+    Formula::ResolveSlots(a_slots);
+    range_cell_slots_.clear();
+    for ( size_t row = 0; row < range_cells_.size(); ++row ) {
+        range_cell_slots_.push_back(a_slots.Resolve(range_cells_[row]));
+    }
+    sum_row_slots_.resize(sum_rows_.size());
+    for ( size_t row = 0; row < sum_rows_.size(); ++row ) {
+        sum_row_slots_[row].clear();
+        for ( size_t col = 0; col < sum_rows_[row].size(); ++col ) {
+            sum_row_slots_[row].push_back(a_slots.Resolve(sum_rows_[row][col]));
+        }
+    }
+}
+
+double casper::see::SumIf::SumIfAllTerms (SlotTable& a_slots, SymbolTable& a_criterias, FILE* a_logfile)
 {
     casper::Term criteria = a_criterias.begin()->second;
     casper::Term result   = casper::Term(casper::Term::EUndefined);
@@ -115,8 +168,8 @@ double casper::see::SumIf::SumIfAllTerms (SymbolTable& a_symtab, SymbolTable& a_
     
     for ( size_t row = 0; row < sum_rows_.size(); ++row ) {
         
-        casper::Term  range_col_value = a_symtab[range_cells_[row]];
-        casper::Term& cell_value      = a_symtab[sum_rows_[row][col]];
+        casper::Term  range_col_value = a_slots[range_cell_slots_[row]];
+        casper::Term& cell_value      = a_slots[sum_row_slots_[row][col]];
         
         result = false;
         
@@ -158,7 +211,7 @@ double casper::see::SumIf::SumIfAllTerms (SymbolTable& a_symtab, SymbolTable& a_
         if ( true == result.GetBoolean() ) {
             sum += cell_value.ToNumber();
             if ( a_logfile != NULL ) {
-                fprintf(a_logfile, " += %-30.30s ....... %g\n", sum_rows_[row][col].c_str(), a_symtab[sum_rows_[row][col]].ToNumber());
+                fprintf(a_logfile, " += %-30.30s ....... %g\n", sum_rows_[row][col].c_str(), a_slots[sum_row_slots_[row][col]].ToNumber());
             }
         }
     }
@@ -42,15 +42,26 @@ namespace casper
             std::vector<std::vector<std::string> > sum_rows_;
             std::string                            range_col_;
             std::vector<std::string>               range_cells_;
+            std::vector<std::vector<int32_t> >     sum_row_slots_;    //!< Slots of #sum_rows_
+            std::vector<int32_t>                   range_cell_slots_; //!< Slots of #range_cells_
             
         public: // Methods
 
                             SumIf                (const char* const a_sum_col, const char* const a_range_col);
+                            SumIf                (ModelCacheReader& a_reader);
             virtual        ~SumIf                ();
             virtual void   CalculateDependencies (See& a_see);
-            virtual double SumIfAllTerms         (SymbolTable& a_symtab, SymbolTable& a_criterias, FILE* a_logfile);
+            virtual void   ResolveSlots          (SlotTable& a_slots);
+            virtual double SumIfAllTerms         (SlotTable& a_slots, SymbolTable& a_criterias, FILE* a_logfile);
+            virtual Kind   GetKind               () const;
+            virtual void   Save                  (ModelCacheWriter& a_writer) const;
         };
 
+        inline Formula::Kind SumIf::GetKind () const
+        {
+            return ESumIf;
+        }
+
     } // namespace see
 } // namespace casper
 
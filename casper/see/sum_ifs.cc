@@ -37,6 +37,28 @@ casper::see::SumIfs::SumIfs (const char* a_sum_col, SymbolTable& a_criterias)
     sum_col_ = a_sum_col;
 }
 
+/**
+ * @brief Constructor, reads a conditional sum written by #Save to the model cache
+ */
+casper::see::SumIfs::SumIfs (ModelCacheReader& a_reader)
+{
+    sum_col_ = a_reader.ReadString();
+    a_reader.Read(col_names_);
+    a_reader.Read(sum_rows_);
+    Restore(a_reader);
+}
+
+/**
+ * @brief Write the conditional sum to the model cache
+ */
+void casper::see::SumIfs::Save (ModelCacheWriter& a_writer) const
+{
+    a_writer.Write(sum_col_);
+    a_writer.Write(col_names_);
+    a_writer.Write(sum_rows_);
+    Formula::Save(a_writer);
+}
+
 /**
  * @brief Destructor
  */
@@ -45,74 +67,77 @@ casper::see::SumIfs::~SumIfs ()
     /* empty */
 }
 
+/**
+ * @brief Make the formula depend on the rows that define the sum cell and all the criteria cells
+ *
+ * A cell is known by the name it's aliased to, by it's cell reference or by the literal of the lines table.
+ */
 void casper::see::SumIfs::CalculateDependencies (See& a_see)
 {
-    std::vector<std::string> dummy_vec;
-    StringSet                tmp_prec;
-    StringHash::iterator     ait;
-    SymbolTable::iterator    sit;
-    char                     cell_ref[20];
-    int                      c, start_row, end_row;
-    size_t                   row_cnt;
-    
+    std::vector<int32_t>     cols;
+    std::vector<std::string> names;
+    const CellIndex::Cell*   cells;
+    size_t                   count;
+    int                      start_row, end_row;
+
     precedents_.clear();
+    sum_rows_.clear();
     start_row = a_see.columns_.begin()->second.row_ + 1;
     end_row   = start_row + a_see.row_count_;
-    row_cnt   = 0;
-    sum_rows_.push_back(dummy_vec);
+
+    for ( int i = -1; i < (int) col_names_.size(); ++i ) {
+        const std::string& name = ( -1 == i ? sum_col_ : col_names_[i] );
+        const auto         it   = a_see.columns_.find(name);
+        if ( it == a_see.columns_.end() ) {
+            throw OSAL_EXCEPTION("Column '%s' does not exist in the model's LINES table", name.c_str());
+        }
+        cols.push_back(it->second.col_);
+    }
 
     /*
-     * Make the formula depend on all sum range and criteria cols terms that are defined
+     * Only the rows that define the sum cell can be complete
      */
-    for ( int32_t r = start_row; r <= end_row; ++r ) {
-        
-        for ( int i = -1; i < (int) col_names_.size(); ++i ) {
-        
-            if ( -1 == i ) {
-                c = a_see.columns_.find(sum_col_)->second.col_;
-            } else {
-                c = a_see.columns_.find(col_names_[i])->second.col_;
-            }
-    
-            Sum::MakeRowColRef(cell_ref, r, c);
+    count = a_see.cell_index_.Range(cols[0], start_row, end_row, cells);
+    for ( size_t row = 0; row < count; ++row ) {
 
-            ait = a_see.aliases_.find(cell_ref);
-            if ( ait != a_see.aliases_.end() ) {
-                tmp_prec.insert(ait->second);
-                sum_rows_[row_cnt].push_back(ait->second);
+        names.clear();
+        for ( size_t i = 0; i < cols.size(); ++i ) {
+            const CellIndex::Cell* cell = ( 0 == i ? &cells[row] : a_see.cell_index_.Find(cols[i], cells[row].row_) );
+            if ( nullptr == cell ) {
+                break;
+            }
+            if ( nullptr != cell->alias_ ) {
+                names.push_back(*cell->alias_);
+            } else if ( nullptr != cell->symbol_ ) {
+                names.push_back(*cell->symbol_);
             } else {
-                sit = a_see.symtab_.find(cell_ref);
-                if ( sit != a_see.symtab_.end() ) {
-                    tmp_prec.insert(sit->first);
-                    sum_rows_[row_cnt].push_back(sit->first);
-                } else {
-                    sit = a_see.line_values_.find(cell_ref);
-                    if ( sit != a_see.line_values_.end() ) {
-                        tmp_prec.insert(sit->first);
-                        sum_rows_[row_cnt].push_back(sit->first);
-                    }
-                }
+                names.push_back(*cell->line_value_);
             }
         }
-        if ( sum_rows_[row_cnt].size() == col_names_.size() + 1 ) {
-            sum_rows_.push_back(dummy_vec);
-            precedents_.insert(tmp_prec.begin(), tmp_prec.end());
-            ++row_cnt;
-        } else {
-            sum_rows_[row_cnt].clear();
+        if ( names.size() == cols.size() ) {
+            precedents_.insert(names.begin(), names.end());
+            sum_rows_.push_back(names);
         }
     }
+}
 
-    /*
-     * Trim the last row if it's not complete
-     */
-    if ( sum_rows_[row_cnt].size() != col_names_.size() + 1 ) {
-        sum_rows_.pop_back();
+
+/**
+ * @brief Resolve the cells of each row to symbol table slots
+ */
+void casper::see::SumIfs::ResolveSlots (SlotTable& a_slots)
+{
+    Formula::ResolveSlots(a_slots);
+    sum_row_slots_.resize(sum_rows_.size());
+    for ( size_t row = 0; row < sum_rows_.size(); ++row ) {
+        sum_row_slots_[row].clear();
+        for ( size_t col = 0; col < sum_rows_[row].size(); ++col ) {
+            sum_row_slots_[row].push_back(a_slots.Resolve(sum_rows_[row][col]));
+        }
     }
 }
 
-
-double casper::see::SumIfs::SumIfAllTerms (SymbolTable& a_symtab, SymbolTable& a_criterias, FILE* a_logfile)
+double casper::see::SumIfs::SumIfAllTerms (SlotTable& a_slots, SymbolTable& a_criterias, FILE* a_logfile)
 {
     int    matches, col;
     double sum;
@@ -124,7 +149,7 @@ double casper::see::SumIfs::SumIfAllTerms (SymbolTable& a_symtab, SymbolTable& a
 
         col = 1;
         for ( SymbolTable::iterator it = a_criterias.begin(); it != a_criterias.end(); ++it ) {
-            comparator.Equal(a_symtab[sum_rows_[row][col]], it->second);
+            comparator.Equal(a_slots[sum_row_slots_[row][col]], it->second);
             if ( comparator.number_ == 1.0 ) {
                 ++matches;
             }
@@ -132,9 +157,9 @@ double casper::see::SumIfs::SumIfAllTerms (SymbolTable& a_symtab, SymbolTable& a
         }
         if ( matches == (int) a_criterias.size() ) {
             if ( a_logfile != NULL ) {
-                fprintf(a_logfile, " += %-30.30s ....... %g\n", sum_rows_[row][0].c_str(), a_symtab[sum_rows_[row][0]].ToNumber());
+                fprintf(a_logfile, " += %-30.30s ....... %g\n", sum_rows_[row][0].c_str(), a_slots[sum_row_slots_[row][0]].ToNumber());
             }
-            sum += a_symtab[sum_rows_[row][0]].ToNumber();
+            sum += a_slots[sum_row_slots_[row][0]].ToNumber();
         }
     }
     return sum;
@@ -41,15 +41,23 @@ namespace casper
             std::string                            sum_col_;
             std::vector<std::string>               col_names_;
             std::vector<std::vector<std::string> > sum_rows_;
+            std::vector<std::vector<int32_t> >     sum_row_slots_;  //!< Slots of #sum_rows_
 
         public: // Methods
 
                            SumIfs                (const char* a_sum_col, SymbolTable& a_criterias);
+                           SumIfs                (ModelCacheReader& a_reader);
             virtual        ~SumIfs               ();
             virtual void   CalculateDependencies (See& a_see);
-            virtual double SumIfAllTerms         (SymbolTable& a_symtab, SymbolTable& a_criterias, FILE* a_logfile);
+            virtual void   ResolveSlots          (SlotTable& a_slots);
+            virtual double SumIfAllTerms         (SlotTable& a_slots, SymbolTable& a_criterias, FILE* a_logfile);
             virtual bool   IsSum                 () const;
             virtual bool   IsSumIfs              () const;
+            virtual Kind   GetKind               () const;
+            virtual void   Save                  (ModelCacheWriter& a_writer) const;
+            std::string    ColumnsKey            () const;
+
+            static std::string ColumnsKey        (const char* a_sum_col, const SymbolTable& a_criterias);
         };
 
         inline bool SumIfs::IsSum () const
@@ -60,6 +68,36 @@ namespace casper
         {
             return true;
         }
+        inline Formula::Kind SumIfs::GetKind () const
+        {
+            return ESumIfs;
+        }
+
+        /**
+         * @return Key of the sum and criteria columns, any SUMIFS over the same columns has the same rows
+         */
+        inline std::string SumIfs::ColumnsKey () const
+        {
+            std::string key = sum_col_;
+            for ( auto col : col_names_ ) {
+                key += ',';
+                key += col;
+            }
+            return key;
+        }
+
+        /**
+         * @return Key of the columns of a SUMIFS, see #ColumnsKey()
+         */
+        inline std::string SumIfs::ColumnsKey (const char* a_sum_col, const SymbolTable& a_criterias)
+        {
+            std::string key = a_sum_col;
+            for ( auto criteria : a_criterias ) {
+                key += ',';
+                key += criteria.first;
+            }
+            return key;
+        }
 
     } // namespace see
 } // namespace casper
@@ -23,7 +23,8 @@
 #include "casper/see/table.h"
 #include "osal/utils/tmp_json_parser.h"
 
-#include <algorithm> // std::find_if
+#include <algorithm> // std::find_if, std::lower_bound, std::sort, std::upper_bound
+#include <cmath>     // std::isnan
 #include <regex>     // std::regex
 #include <sstream>
 
@@ -42,6 +43,7 @@ casper::see::Table::Table (const char* a_name, bool a_is_partial)
     partially_loaded_ = a_is_partial;
     use_exact_match_  = a_is_partial;
     track_lookups_    = false;
+    version_          = 0;
 }
 
 /**
@@ -57,6 +59,7 @@ void casper::see::Table::Clear ()
     colname_to_index_.clear();
     columns_.clear();
     tracked_lookups_.Clear();
+    version_++;
 }
 
 casper::see::Table::Column& casper::see::Table::AddColumn (const char* a_name)
@@ -72,6 +75,73 @@ casper::see::Table::Column& casper::see::Table::AddColumn (const char* a_name)
     return columns_[index];
 }
 
+/**
+ * @brief Append a row, a value that doesn't fit the typed array moves the column to mixed values
+ */
+void casper::see::Table::Column::Append (const casper::see::Value& a_value)
+{
+    const unsigned type = a_value.GetType();
+
+    if ( EEmpty == storage_ ) {
+        storage_ = ( casper::Term::ENumber == type ? ENumbers : casper::Term::EText == type ? ETexts : EValues );
+    }
+
+    if ( ENumbers == storage_ && casper::Term::ENumber == type ) {
+        numbers_.push_back(a_value.GetNumber());
+        return;
+    }
+    if ( ETexts == storage_ && casper::Term::EText == type ) {
+        texts_.push_back(a_value.TextHandle());
+        return;
+    }
+    if ( EValues != storage_ ) {
+        std::vector<Value> values;
+
+        values.reserve(Size() + 1);
+        for ( size_t row = 0; row < Size(); ++row ) {
+            values.push_back(At(row));
+        }
+        values_.swap(values);
+        numbers_ = std::vector<double>();
+        texts_   = std::vector<uint32_t>();
+        storage_ = EValues;
+    }
+    values_.push_back(a_value);
+}
+
+/**
+ * @brief Reserve room for @a a_rows rows of values of type @a a_type
+ */
+void casper::see::Table::Column::Reserve (size_t a_rows, unsigned a_type)
+{
+    if ( EEmpty == storage_ ) {
+        storage_ = ( casper::Term::ENumber == a_type ? ENumbers : casper::Term::EText == a_type ? ETexts : EValues );
+    }
+    switch (storage_) {
+        case ENumbers:
+            if ( casper::Term::ENumber == a_type ) {
+                numbers_.reserve(a_rows);
+            }
+            break;
+        case ETexts:
+            if ( casper::Term::EText == a_type ) {
+                texts_.reserve(a_rows);
+            }
+            break;
+        default:
+            values_.reserve(a_rows);
+            break;
+    }
+}
+
+/**
+ * @return bytes held by the arrays of the column
+ */
+size_t casper::see::Table::Column::Bytes () const
+{
+    return numbers_.capacity() * sizeof(double) + texts_.capacity() * sizeof(uint32_t) + values_.capacity() * sizeof(Value);
+}
+
 /**
  * @brief Load the table from the parsed JSON data model
  *
@@ -82,9 +152,8 @@ casper::see::Table::Column& casper::see::Table::AddColumn (const char* a_name)
 void casper::see::Table::Load (Json::Value& a_value, const char* a_name)
 {
     int  rows = -1;
-    int  col_index = 0;
 
-    name_ = a_name;
+    BeginLoad(a_name);
 
     if ( a_value.isArray() == false ) {
         throw OSAL_EXCEPTION_NA("the table top object must be an array");
@@ -96,115 +165,370 @@ void casper::see::Table::Load (Json::Value& a_value, const char* a_name)
         }
 
         // Add or reuse the existing column and keep ref pointer to it
-        const char* col_name = (*it)["name"].asCString();
-        Column* col;
-        if ( partially_loaded_ == false ) {
-            col = &AddColumn(col_name);
-        } else {
-            std::map<std::string, int>::iterator column_it = colname_to_index_.find(col_name);
-            if ( column_it == colname_to_index_.end()) {
-                throw OSAL_EXCEPTION("Appending column %s that does not exist", col_name);
-            } else {
-                col = &columns_[column_it->second];
-            }
-        }
+        Column& col = LoadColumn((*it)["name"].asCString());
 
         // Fill or append the data vectors
         bool numeric = (*it)["type"] == "number";
+        col.Reserve(col.Size() + (*it)["data"].size(), numeric ? Term::ENumber : Term::EText);
         for ( Json::Value::iterator dit = (*it)["data"].begin(); dit != (*it)["data"].end(); ++dit ) {
-            casper::Term value = casper::Term();
             if ( numeric ) {
-                value = (*dit).asDouble();
+                col.Append(Value((*dit).asDouble()));
             } else {
-                value = (*dit).asString();
+                col.Append(Value((*dit).asString()));
             }
-            col->values_.push_back(value);
         }
+        EndColumn(col, rows);
+    }
+    EndLoad();
+}
 
-        // Make sure all the colums have the same size
-        if ( -1 == rows ) {
-            rows = (int)(col->values_.size());
-        } else {
-            if ( rows != (int)(col->values_.size()) ) {
-                throw OSAL_EXCEPTION("column '%s' height of %d is diferent from %d, all rows must have the same height",
-                                     col_name, (int)(col->values_.size()), rows);
-            }
+/**
+ * @brief Start loading the table, the columns follow with #LoadColumn and #EndColumn
+ *
+ * @param a_name name of the table
+ */
+void casper::see::Table::BeginLoad (const char* a_name)
+{
+    name_ = a_name;
+    version_++;
+}
+
+/**
+ * @brief Add, or on a partial load reuse, the column whose rows are about to be appended
+ *
+ * @param a_name column name
+ * @return the column, valid until the next column is added
+ */
+casper::see::Table::Column& casper::see::Table::LoadColumn (const char* a_name)
+{
+    Column* col = EnsureColumn(a_name);
+
+    col->range_index_.reset();
+    col->match_index_.reset();
+    col->sum_index_.reset();
+    return *col;
+}
+
+/**
+ * @brief Make sure all the colums have the same size
+ *
+ * @param a_column the column just loaded
+ * @param io_rows  height of the previous columns, -1 before the first one
+ */
+void casper::see::Table::EndColumn (const Column& a_column, int& io_rows)
+{
+    if ( -1 == io_rows ) {
+        io_rows = (int)(a_column.Size());
+    } else {
+        if ( io_rows != (int)(a_column.Size()) ) {
+            throw OSAL_EXCEPTION("column '%s' height of %d is diferent from %d, all rows must have the same height",
+                                 a_column.name_.c_str(), (int)(a_column.Size()), io_rows);
         }
-        col_index++;
     }
+}
+
+/**
+ * @brief Finish loading the table
+ */
+void casper::see::Table::EndLoad ()
+{
     partially_loaded_ = false;
 }
 
 double casper::see::Table::SumColumn (const char* a_sum_column)
 {
     std::map<std::string, int>::iterator sum_index_it;
-    int                                  col_index;
-    double                               sum;
-    double                               value;
-
-    sum = 0.0;
 
     sum_index_it = colname_to_index_.find(a_sum_column);
     if ( sum_index_it == colname_to_index_.end() ) {
         throw OSAL_EXCEPTION("table '%s' does not have '%s' column", name_.c_str(), a_sum_column);
     }
-    col_index = sum_index_it->second;
+    return SumColumn(sum_index_it->second);
+}
+
+/**
+ * @brief Sum a column resolved with #GetColumnIndex
+ */
+double casper::see::Table::SumColumn (int a_sum_index)
+{
+    return SumRows(columns_[a_sum_index], nullptr);
+}
+
+void casper::see::Table::SumIfs (Term& a_result, const char* a_sum_column, SymbolTable& a_criterias)
+{
+    std::map<std::string, int>::iterator index_it;
+
+    index_it = colname_to_index_.find(a_sum_column);
+    if ( index_it == colname_to_index_.end() ) {
+        throw OSAL_EXCEPTION("table '%s' does not have '%s' column", name_.c_str(), a_sum_column);
+    }
+    SumIfs(a_result, index_it->second, a_criterias);
+}
+
+/**
+ * @brief Sum the rows of a column resolved with #GetColumnIndex that match all the criteria
+ *
+ * Each criteria is applied by #SelectRows to the whole column before the next one, the matching rows are
+ * then added in row order by #SumRows, so the result is the same as a row by row scan.
+ */
+void casper::see::Table::SumIfs (Term& a_result, int a_sum_index, SymbolTable& a_criterias)
+{
+    std::map<std::string, int>::iterator index_it;
+    std::vector<const Column*>           criteria_columns;
+
+    const Column& sum_column = columns_[a_sum_index];
+    const size_t  rows       = sum_column.Size();
 
-    int rows = (int)(columns_[col_index].values_.size());
+    if ( 0 == rows ) {
+        a_result = 0.0;
+        return;
+    }
 
-    for ( int row = 0; row < rows; ++row ) {
-        if ( casper::Term::ENumber == columns_[col_index].values_[row].type_ ) {
-            sum += columns_[col_index].values_[row].GetNumber();
-        } else if ( false == std::isnan( ( value = columns_[col_index].values_[row].ToNumber() ) ) ) {
-            sum += value;
+    criteria_columns.reserve(a_criterias.size());
+    for ( SymbolTable::iterator criteria_it = a_criterias.begin(); criteria_it != a_criterias.end(); ++criteria_it ) {
+        index_it = colname_to_index_.find(criteria_it->first);
+        if ( index_it == colname_to_index_.end() ) {
+            throw OSAL_EXCEPTION("table '%s' does not have '%s' column", name_.c_str(), criteria_it->first.c_str());
         }
+        criteria_columns.push_back(&columns_[index_it->second]);
     }
 
-    return sum;
+    // ... one criteria at a time, over the whole column ...
+    std::vector<uint8_t> selection(rows, 1);
+    size_t               column = 0;
+    for ( SymbolTable::iterator criteria_it = a_criterias.begin(); criteria_it != a_criterias.end(); ++criteria_it, ++column ) {
+        SelectRows(criteria_it->second, *criteria_columns[column], selection);
+    }
+    a_result = SumRows(sum_column, &selection);
 }
 
-void casper::see::Table::SumIfs (Term& a_result, const char* a_sum_column, SymbolTable& a_criterias)
+void casper::see::Table::SumIf (Term& a_result, const char* a_sum_column, const Term& a_criteria)
 {
     std::map<std::string, int>::iterator index_it;
-    int                                  sum_col_index;
-    int                                  criteria_col_index;
-    double                               sum;
-    double                               value;
-
-    sum = 0.0;
 
     index_it = colname_to_index_.find(a_sum_column);
     if ( index_it == colname_to_index_.end() ) {
         throw OSAL_EXCEPTION("table '%s' does not have '%s' column", name_.c_str(), a_sum_column);
     }
-    sum_col_index = index_it->second;
+    SumIf(a_result, index_it->second, a_criteria);
+}
 
-    int rows = (int)(columns_[sum_col_index].values_.size());
+/**
+ * @brief Sum the rows of a column resolved with #GetColumnIndex that compare to the criteria
+ *
+ * The operator is the criteria's aux_condition_, one of <, <=, >, >=, =, <> (or !=), empty is =. The
+ * ordering operators compare number rows to the criteria as numbers, text rows never match them, the
+ * matching rows are found by a binary search in the #SumIndex. = and <> select the rows like SUMIFS does
+ * with #Equal. Either way the rows are added in row order, so the result is exactly the row by row sum.
+ */
+void casper::see::Table::SumIf (Term& a_result, int a_sum_index, const Term& a_criteria)
+{
+    const Column&     column = columns_[a_sum_index];
+    const char* const op     = a_criteria.aux_condition_.c_str();
+    const size_t      rows   = column.Size();
+
+    enum { ELess, ELessOrEqual, EGreater, EGreaterOrEqual, EEqual, ENotEqual } comparison;
+
+    if ( 0 == op[0] || 0 == strcmp(op, "=") ) {
+        comparison = EEqual;
+    } else if ( 0 == strcmp(op, "<>") || 0 == strcmp(op, "!=") ) {
+        comparison = ENotEqual;
+    } else if ( 0 == strcmp(op, "<") ) {
+        comparison = ELess;
+    } else if ( 0 == strcmp(op, "<=") ) {
+        comparison = ELessOrEqual;
+    } else if ( 0 == strcmp(op, ">") ) {
+        comparison = EGreater;
+    } else if ( 0 == strcmp(op, ">=") ) {
+        comparison = EGreaterOrEqual;
+    } else {
+        throw OSAL_EXCEPTION("invalid SUMIF criteria operator '%s'", op);
+    }
 
-    for ( int row = 0; row < rows; ++row ) {
-        bool match = true;
-        for (SymbolTable::iterator criteria_it = a_criterias.begin(); criteria_it != a_criterias.end(); ++criteria_it ) {
+    if ( 0 == rows ) {
+        a_result = 0.0;
+        return;
+    }
 
-            index_it = colname_to_index_.find(criteria_it->first);
-            if ( index_it == colname_to_index_.end() ) {
-                throw OSAL_EXCEPTION("table '%s' does not have '%s' column", name_.c_str(), criteria_it->first.c_str());
+    // ... = and <> select the rows in one pass like SUMIFS ...
+    if ( EEqual == comparison || ENotEqual == comparison ) {
+        std::vector<uint8_t> selection(rows, 1);
+        SelectRows(a_criteria, column, selection);
+        if ( ENotEqual == comparison ) {
+            for ( size_t row = 0; row < rows; ++row ) {
+                selection[row] ^= 1;
             }
-            criteria_col_index = index_it->second;
+        }
+        a_result = SumRows(column, &selection);
+        return;
+    }
+
+    double key;
+    switch (a_criteria.type_) {
+        case casper::Term::ENumber:
+            key = a_criteria.GetNumber();
+            break;
+        case casper::Term::EText:
+        case casper::Term::EBoolean:
+            key = a_criteria.ToNumber();
+            break;
+        default:
+            key = NAN;
+            break;
+    }
+    if ( true == std::isnan(key) ) {
+        // ... nothing is ordered against NaN ...
+        a_result = 0.0;
+        return;
+    }
+
+    const std::shared_ptr<const SumIndex> index = GetSumIndex(a_sum_index);
+    const size_t                          count = index->numbers_.size();
+    const size_t                          lower = std::lower_bound(index->numbers_.begin(), index->numbers_.end(), key) - index->numbers_.begin();
+    const size_t                          upper = std::upper_bound(index->numbers_.begin() + lower, index->numbers_.end(), key) - index->numbers_.begin();
+    size_t                                first, last;
 
-            if ( false == Equal(columns_[criteria_col_index].values_[row], criteria_it->second) ) {
-                match = false;
+    switch (comparison) {
+        case ELess:
+            first = 0;
+            last  = lower;
+            break;
+        case ELessOrEqual:
+            first = 0;
+            last  = upper;
+            break;
+        case EGreater:
+            first = upper;
+            last  = count;
+            break;
+        default: // EGreaterOrEqual
+            first = lower;
+            last  = count;
+            break;
+    }
+
+    if ( first == last ) {
+        a_result = 0.0;
+        return;
+    }
+
+    // ... a few rows are put back in row order and added, many are selected and added by the column scan ...
+    if ( ( last - first ) * 8 < rows ) {
+        std::vector<uint32_t> matches(index->rows_.begin() + first, index->rows_.begin() + last);
+        double                sum = 0.0;
+
+        std::sort(matches.begin(), matches.end());
+        for ( const uint32_t row : matches ) {
+            sum += column.ToNumber(row);
+        }
+        a_result = sum;
+    } else {
+        std::vector<uint8_t> selection(rows, 0);
+        for ( size_t idx = first; idx < last; ++idx ) {
+            selection[index->rows_[idx]] = 1;
+        }
+        a_result = SumRows(column, &selection);
+    }
+}
+
+/**
+ * @brief Clear the selected rows that are not #Equal to the criteria
+ *
+ * Number columns and text columns searched by text compare the raw arrays without branches so that the
+ * compiler can vectorize the loops, the other combinations compare the selected rows one by one.
+ *
+ * @param a_criteria     value the rows must be equal to
+ * @param a_column       column to compare
+ * @param io_selection   one byte per row, non zero when the row is selected
+ */
+void casper::see::Table::SelectRows (const casper::Term& a_criteria, const Column& a_column, std::vector<uint8_t>& io_selection)
+{
+    const size_t rows      = io_selection.size();
+    uint8_t*     selection = io_selection.data();
+
+    if ( Column::ENumbers == a_column.storage_ ) {
+        double key;
+        switch (a_criteria.type_) {
+            case casper::Term::ENumber:
+                key = a_criteria.GetNumber();
                 break;
-            }
+            case casper::Term::EText:
+            case casper::Term::EBoolean:
+                key = a_criteria.ToNumber();
+                break;
+            default:
+                std::fill(io_selection.begin(), io_selection.end(), 0);
+                return;
+        }
+        const double* numbers = a_column.numbers_.data();
+        for ( size_t row = 0; row < rows; ++row ) {
+            selection[row] &= static_cast<uint8_t>(numbers[row] == key);
+        }
+        return;
+    }
+
+    if ( Column::ETexts == a_column.storage_ && casper::Term::EText == a_criteria.type_ ) {
+        uint32_t handle;
+        if ( false == StringPool::Find(a_criteria.text_, handle) ) {
+            // ... a text that was never loaded can't be in the column ...
+            std::fill(io_selection.begin(), io_selection.end(), 0);
+            return;
+        }
+        const uint32_t* texts = a_column.texts_.data();
+        for ( size_t row = 0; row < rows; ++row ) {
+            selection[row] &= static_cast<uint8_t>(texts[row] == handle);
+        }
+        return;
+    }
+
+    for ( size_t row = 0; row < rows; ++row ) {
+        if ( 0 != selection[row] && false == Equal(a_criteria, a_column.At(row)) ) {
+            selection[row] = 0;
         }
-        if ( true == match ) {
-            if ( casper::Term::ENumber == columns_[sum_col_index].values_[row].GetType() ) {
-                sum += columns_[sum_col_index].values_[row].GetNumber();
-            } else if ( false == std::isnan( ( value = columns_[sum_col_index].values_[row].ToNumber() ) ) ) {
-                sum += value;
+    }
+}
+
+/**
+ * @brief Sum the rows of a column, numbers as they are and other types when they convert to a number
+ *
+ * The rows are added in order, like a row by row sum would, so the result is the same to the last bit.
+ *
+ * @param a_column    column to sum
+ * @param a_selection one byte per row, non zero when the row is added, nullptr to add all the rows
+ */
+double casper::see::Table::SumRows (const Column& a_column, const std::vector<uint8_t>* a_selection)
+{
+    const size_t rows = a_column.Size();
+    double       sum  = 0.0;
+
+    if ( Column::ENumbers == a_column.storage_ ) {
+        const double* numbers = a_column.numbers_.data();
+        if ( nullptr == a_selection ) {
+            for ( size_t row = 0; row < rows; ++row ) {
+                sum += numbers[row];
+            }
+        } else {
+            const uint8_t* selection = a_selection->data();
+            for ( size_t row = 0; row < rows; ++row ) {
+                sum += ( 0 != selection[row] ? numbers[row] : 0.0 );
             }
         }
+        return sum;
     }
-    a_result = sum;
+
+    for ( size_t row = 0; row < rows; ++row ) {
+        if ( nullptr != a_selection && 0 == (*a_selection)[row] ) {
+            continue;
+        }
+        const Value value = a_column.At(row);
+        double      number;
+        if ( casper::Term::ENumber == value.GetType() ) {
+            sum += value.GetNumber();
+        } else if ( false == std::isnan( ( number = value.ToNumber() ) ) ) {
+            sum += number;
+        }
+    }
+    return sum;
 }
 
 void casper::see::Table::Lookup (Term& a_result, Term& a_value, const char* a_search_col, const char* a_result_col)
@@ -212,7 +536,6 @@ void casper::see::Table::Lookup (Term& a_result, Term& a_value, const char* a_se
     std::map<std::string, int>::iterator it;
     int                                  search_index;
     int                                  result_index;
-    unsigned                             row;
 
     if ( a_search_col[0] == 0 ) {
         search_index = 0;
@@ -229,41 +552,41 @@ void casper::see::Table::Lookup (Term& a_result, Term& a_value, const char* a_se
     }
     result_index = it->second;
 
+    Lookup(a_result, a_value, search_index, result_index);
+}
+
+/**
+ * @brief LOOKUP on columns resolved with #GetColumnIndex
+ *
+ * @return false when no row matched, only the type and number of @a a_result are set then
+ */
+bool casper::see::Table::Lookup (Term& a_result, Term& a_value, int a_search_index, int a_result_index)
+{
+    unsigned row;
+
     if ( use_exact_match_ ) {
         Term result_idx;
 
-        result_idx = (double) result_index + 1;
-        return Vlookup(a_result, a_value, a_search_col, result_idx, false);
+        result_idx = (double) a_result_index + 1;
+        return Vlookup(a_result, a_value, a_search_index, result_idx, false);
     }
 
-    for ( row = 0; row < columns_[search_index].values_.size(); ++row ) {
-        if ( true == Lower(a_value, columns_[search_index].values_[row]) ) {
-            if ( row != 0 ) {
-                --row;
-            }
-            break;
-        }
-    }
-
-    if ( row > columns_[search_index].values_.size() || 0 == columns_[search_index].values_.size() ) {
-        throw OSAL_EXCEPTION("'%s' is not a valid vlookup - no rows for search_index %d!", a_result_col, search_index);
+    if ( 0 == columns_[a_search_index].Size() ) {
+        throw OSAL_EXCEPTION("'%s' is not a valid vlookup - no rows for search_index %d!", columns_[a_result_index].name_.c_str(), a_search_index);
     }
 
-    if ( row == columns_[search_index].values_.size() ){
-        --row;
-    }
-    a_result = columns_[result_index].values_[row];
+    row = RangeRow(a_value, a_search_index);
+    columns_[a_result_index].Get(row, a_result);
     if ( true == track_lookups_ ) {
         TrackLookup(row);
     }
+    return true;
 }
 
 void casper::see::Table::Vlookup (Term& a_result, Term& a_value, const char* a_lookup_col, Term& a_result_index, bool a_range_lookup)
 {
     std::map<std::string, int>::iterator it;
     int                                  search_index;
-    int                                  result_index;
-    unsigned                             row;
 
     if ( a_lookup_col[0] == 0 ) {
         search_index = 0;
@@ -274,6 +597,18 @@ void casper::see::Table::Vlookup (Term& a_result, Term& a_value, const char* a_l
         }
         search_index = it->second;
     }
+    Vlookup(a_result, a_value, search_index, a_result_index, a_range_lookup);
+}
+
+/**
+ * @brief VLOOKUP on a search column resolved with #GetColumnIndex
+ *
+ * @return false when no row matched, only the type and number of @a a_result are set then
+ */
+bool casper::see::Table::Vlookup (Term& a_result, Term& a_value, int a_search_index, Term& a_result_index, bool a_range_lookup)
+{
+    int      result_index;
+    unsigned row;
 
     if ( ! (a_result_index.type_ & Term::ENumber) ) {
         throw OSAL_EXCEPTION("'%s' is not valid index a number", a_result_index.ToString().c_str());
@@ -282,47 +617,307 @@ void casper::see::Table::Vlookup (Term& a_result, Term& a_value, const char* a_l
     if ( result_index < 1 || result_index > (int) columns_.size() ) {
         a_result.type_   = Term::ENan;
         a_result.number_ = NAN;
-        return;
+        return false;
     }
     result_index -= 1;
 
     if ( a_range_lookup == false ) {
 
-        for ( row = 0; row < columns_[search_index].values_.size(); ++row ) {
-            if ( true == Equal(a_value, columns_[search_index].values_[row]) ) {
-                a_result = columns_[result_index].values_[row];
-                if ( true == track_lookups_ ) {
-                    TrackLookup(row);
-                }
-                return;
+        const int match = MatchRow(a_value, a_search_index);
+        if ( -1 != match ) {
+            columns_[result_index].Get(match, a_result);
+            if ( true == track_lookups_ ) {
+                TrackLookup(match);
             }
+            return true;
         }
 
         a_result.type_   = Term::ENan;
         a_result.number_ = NAN;
 
-        return;
+        return false;
+
+    } else {
+
+        if ( 0 == columns_[a_search_index].Size() ) {
+            a_result.type_   = Term::ENan;
+            a_result.number_ = NAN;
+            return false;
+        }
+        row = RangeRow(a_value, a_search_index);
+        columns_[result_index].Get(row, a_result);
+
+    }
+    if ( true == track_lookups_ ) {
+        TrackLookup(row);
+    }
+    return true;
+}
+
+/**
+ * @brief Find the row of a range lookup, the row before the first one greater than the value
+ *
+ * The first row is returned when it's already greater and the last row when none is greater, the binary search
+ * on the #RangeIndex gives the same row as scanning the column with #Lower.
+ *
+ * @param a_value        value to look for
+ * @param a_search_index index of a column with at least one row
+ */
+unsigned casper::see::Table::RangeRow (const casper::Term& a_value, int a_search_index)
+{
+    const size_t rows = columns_[a_search_index].Size();
+    size_t       first_greater;
 
+    if ( casper::Term::ENumber == a_value.type_ ) {
+        const std::shared_ptr<const RangeIndex> index = GetRangeIndex(a_search_index);
+        if ( 0 == index->numbers_.size() ) {
+            first_greater = rows;
+        } else {
+            first_greater = std::upper_bound(index->numbers_.begin(), index->numbers_.end(), a_value.number_) - index->numbers_.begin();
+        }
+    } else if ( casper::Term::EText == a_value.type_ ) {
+        const std::shared_ptr<const RangeIndex> index = GetRangeIndex(a_search_index);
+        if ( 0 == index->texts_.size() ) {
+            first_greater = rows;
+        } else {
+            const char* text = a_value.text_.c_str();
+            first_greater = std::upper_bound(index->texts_.begin(), index->texts_.end(), text,
+                                             [] (const char* a_text, uint32_t a_handle) {
+                                                 return strcmp(a_text, StringPool::Get(a_handle).c_str()) < 0;
+                                             }) - index->texts_.begin();
+        }
     } else {
+        // ... other types are never lower ...
+        first_greater = rows;
+    }
+
+    if ( 0 == first_greater ) {
+        return 0;
+    }
+    return static_cast<unsigned>(first_greater - 1);
+}
+
+/**
+ * @brief Return the range index of a column, building it on first use
+ *
+ * Lookups run concurrently on the shared tables, so the index is published with an atomic store and the build
+ * is done by one thread only.
+ */
+std::shared_ptr<const casper::see::Table::RangeIndex> casper::see::Table::GetRangeIndex (int a_column_index)
+{
+    Column& column = columns_[a_column_index];
 
-        for ( row = 0; row < columns_[search_index].values_.size(); ++row ) {
-            if ( true == Lower(a_value, columns_[search_index].values_[row]) ) {
-                if ( row != 0 ) {
-                    --row;
+    std::shared_ptr<const RangeIndex> index = std::atomic_load(&column.range_index_);
+    if ( nullptr != index ) {
+        return index;
+    }
+
+    std::lock_guard<std::mutex> lock(index_mutex_);
+
+    index = std::atomic_load(&column.range_index_);
+    if ( nullptr != index ) {
+        return index;
+    }
+
+    std::shared_ptr<RangeIndex> build = std::make_shared<RangeIndex>();
+    const size_t                rows  = column.Size();
+    bool                        has_numbers = false;
+    bool                        has_texts   = false;
+
+    for ( size_t row = 0; row < rows; ++row ) {
+        has_numbers |= ( casper::Term::ENumber == column.At(row).GetType() && false == std::isnan(column.At(row).GetNumber()) );
+        has_texts   |= ( casper::Term::EText   == column.At(row).GetType() );
+    }
+
+    if ( true == has_numbers ) {
+        double maximum = -INFINITY;
+
+        build->numbers_.resize(rows);
+        for ( size_t row = 0; row < rows; ++row ) {
+            const Value value = column.At(row);
+            if ( casper::Term::ENumber == value.GetType() && value.GetNumber() > maximum ) {
+                maximum = value.GetNumber();
+            }
+            build->numbers_[row] = maximum;
+        }
+    }
+    if ( true == has_texts ) {
+        uint32_t maximum = 0; // ... the empty string, nothing is lower ...
+
+        build->texts_.resize(rows);
+        for ( size_t row = 0; row < rows; ++row ) {
+            const Value value = column.At(row);
+            if ( casper::Term::EText == value.GetType() && strcmp(value.GetText().c_str(), StringPool::Get(maximum).c_str()) > 0 ) {
+                maximum = value.TextHandle();
+            }
+            build->texts_[row] = maximum;
+        }
+    }
+
+    index = build;
+    std::atomic_store(&column.range_index_, index);
+    return index;
+}
+
+/**
+ * @brief Find the row of an exact lookup, the first one that is #Equal to the value
+ *
+ * @param a_value        value to look for
+ * @param a_search_index index of the search column
+ *
+ * @return the row or -1 when no row matches
+ */
+int casper::see::Table::MatchRow (const casper::Term& a_value, int a_search_index)
+{
+    const Column& column = columns_[a_search_index];
+    uint32_t      best   = UINT32_MAX;
+
+    // ... #Equal never matches other types ...
+    if ( casper::Term::ENumber != a_value.type_ && casper::Term::EText != a_value.type_ && casper::Term::EBoolean != a_value.type_ ) {
+        return -1;
+    }
+
+    const std::shared_ptr<const MatchIndex> index = GetMatchIndex(a_search_index);
+
+    auto first_row = [&best] (const std::unordered_map<double, uint32_t>& a_map, double a_key) {
+        if ( false == std::isnan(a_key) ) {
+            const auto it = a_map.find(a_key);
+            if ( a_map.end() != it && it->second < best ) {
+                best = it->second;
+            }
+        }
+    };
+
+    switch (a_value.type_) {
+
+        case casper::Term::ENumber:
+            first_row(index->numbers_, a_value.GetNumber());
+            first_row(index->converted_, a_value.GetNumber());
+            break;
+
+        case casper::Term::EText:
+        {
+            const auto range = index->texts_.equal_range(std::hash<std::string>()(a_value.text_));
+            for ( auto it = range.first; it != range.second; ++it ) {
+                if ( it->second < best && 0 == strcmp(a_value.text_.c_str(), column.At(it->second).GetText().c_str()) ) {
+                    best = it->second;
                 }
-                break;
             }
+            first_row(index->numbers_, a_value.ToNumber());
+            break;
         }
 
-        if ( row == columns_[search_index].values_.size() ) {
-            --row;
+        default: // EBoolean
+            first_row(index->numbers_, a_value.ToNumber());
+            break;
+    }
+
+    return ( UINT32_MAX == best ? -1 : static_cast<int>(best) );
+}
+
+/**
+ * @brief Return the match index of a column, building it on first use
+ *
+ * Same publication scheme as #GetRangeIndex.
+ */
+std::shared_ptr<const casper::see::Table::MatchIndex> casper::see::Table::GetMatchIndex (int a_column_index)
+{
+    Column& column = columns_[a_column_index];
+
+    std::shared_ptr<const MatchIndex> index = std::atomic_load(&column.match_index_);
+    if ( nullptr != index ) {
+        return index;
+    }
+
+    std::lock_guard<std::mutex> lock(index_mutex_);
+
+    index = std::atomic_load(&column.match_index_);
+    if ( nullptr != index ) {
+        return index;
+    }
+
+    std::shared_ptr<MatchIndex>            build = std::make_shared<MatchIndex>();
+    std::unordered_map<uint32_t, uint32_t> first_text_row;
+    const uint32_t                         rows  = static_cast<uint32_t>(column.Size());
+    double                                 number;
+
+    for ( uint32_t row = 0; row < rows; ++row ) {
+        const Value value = column.At(row);
+        switch (value.GetType()) {
+
+            case casper::Term::ENumber:
+                if ( false == std::isnan(value.GetNumber()) ) {
+                    build->numbers_.insert(std::make_pair(value.GetNumber(), row));
+                }
+                break;
+
+            case casper::Term::EText:
+                if ( true == first_text_row.insert(std::make_pair(value.TextHandle(), row)).second ) {
+                    build->texts_.insert(std::make_pair(std::hash<std::string>()(value.GetText()), row));
+                }
+                // fall through
+            case casper::Term::EBoolean:
+                if ( false == std::isnan( ( number = value.ToNumber() ) ) ) {
+                    build->converted_.insert(std::make_pair(number, row));
+                }
+                break;
+
+            default:
+                break;
         }
-        a_result = columns_[result_index].values_[row];
+    }
+
+    index = build;
+    std::atomic_store(&column.match_index_, index);
+    return index;
+}
+
+/**
+ * @brief Return the SUMIF index of a column, building it on first use
+ *
+ * Same publication scheme as #GetRangeIndex.
+ */
+std::shared_ptr<const casper::see::Table::SumIndex> casper::see::Table::GetSumIndex (int a_column_index)
+{
+    Column& column = columns_[a_column_index];
 
+    std::shared_ptr<const SumIndex> index = std::atomic_load(&column.sum_index_);
+    if ( nullptr != index ) {
+        return index;
     }
-    if ( true == track_lookups_ ) {
-        TrackLookup(row);
+
+    std::lock_guard<std::mutex> lock(index_mutex_);
+
+    index = std::atomic_load(&column.sum_index_);
+    if ( nullptr != index ) {
+        return index;
+    }
+
+    std::shared_ptr<SumIndex>                  build = std::make_shared<SumIndex>();
+    std::vector<std::pair<double, uint32_t> > entries;
+    const size_t                               rows  = column.Size();
+
+    if ( Column::ENumbers == column.storage_ ) {
+        entries.reserve(rows);
+    }
+    for ( size_t row = 0; row < rows; ++row ) {
+        const Value value = column.At(row);
+        if ( casper::Term::ENumber == value.GetType() && false == std::isnan(value.GetNumber()) ) {
+            entries.push_back(std::make_pair(value.GetNumber(), static_cast<uint32_t>(row)));
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+
+    build->numbers_.reserve(entries.size());
+    build->rows_.reserve(entries.size());
+    for ( const auto& entry : entries ) {
+        build->numbers_.push_back(entry.first);
+        build->rows_.push_back(entry.second);
     }
+
+    index = build;
+    std::atomic_store(&column.sum_index_, index);
+    return index;
 }
 
 void casper::see::Table::PrepareTracking (const Json::Value& a_filter, const Json::Value& a_params)
@@ -333,7 +928,7 @@ void casper::see::Table::PrepareTracking (const Json::Value& a_filter, const Jso
         if ( 0 == columns_.size() ) {
             return;
         }
-        const size_t number_of_rows = columns_[0].values_.size();
+        const size_t number_of_rows = columns_[0].Size();
         if ( 0 == number_of_rows ) {
             TrackLookup(-1);
         } else {
@@ -372,19 +967,38 @@ void casper::see::Table::PrepareTracking (const Json::Value& a_filter, const Jso
 
         const size_t column_idx = static_cast<size_t>(column_it->second);
 
-        const size_t number_of_rows = columns_[column_idx].values_.size();
+        const size_t number_of_rows = columns_[column_idx].Size();
         if ( 0 == number_of_rows ) {
             TrackLookup(-1);
         } else {
             const std::string regexp = casper::see::Table::BuildQuery (column_value_regex.asString(), a_params);
-            const std::regex filter_expr(regexp, std::regex_constants::ECMAScript);
+            if ( regexp != tracking_expr_ ) {
+                tracking_regex_ = std::regex(regexp, std::regex_constants::ECMAScript);
+                tracking_expr_  = regexp;
+            }
+
+            // ... equal texts share a pool handle, each distinct text is matched once ...
+            const Column&                      column = columns_[column_idx];
+            std::unordered_map<uint32_t, bool> matched_texts;
+            Term                               term;
             for ( size_t row_idx = 0 ; row_idx < number_of_rows ; ++row_idx ) {
-                const std::string value = columns_[column_idx].values_[row_idx].AsString();
-                auto tmp_begin = std::sregex_iterator(value.begin(), value.end(), filter_expr);
-                if ( tmp_begin == std::sregex_iterator() ) {
-                    continue;
+                bool matched;
+                if ( Column::ETexts == column.storage_ ) {
+                    const auto it = matched_texts.find(column.texts_[row_idx]);
+                    if ( matched_texts.end() != it ) {
+                        matched = it->second;
+                    } else {
+                        const std::string& value = StringPool::Get(column.texts_[row_idx]);
+                        matched = std::regex_search(value, tracking_regex_);
+                        matched_texts[column.texts_[row_idx]] = matched;
+                    }
+                } else {
+                    column.Get(row_idx, term);
+                    matched = std::regex_search(term.AsString(), tracking_regex_);
+                }
+                if ( true == matched ) {
+                    TrackLookup(static_cast<int>(row_idx));
                 }
-                TrackLookup(static_cast<int>(row_idx));
             }
         }
     }
@@ -392,50 +1006,64 @@ void casper::see::Table::PrepareTracking (const Json::Value& a_filter, const Jso
 
 void casper::see::Table::TrackLookup (int a_row)
 {
-    Json::Value* json_array = tracked_lookups_.JSONObject(a_row);
-    if ( nullptr != json_array ) {
+    tracked_lookups_.Track(a_row);
+}
 
+/**
+ * @brief Columns of a tracked row as a JSON array of name, type and data objects
+ *
+ * @param a_row   row index, -1 for the column names of an empty table
+ * @param o_array receives one object per column
+ */
+void casper::see::Table::TrackedRowToJSON (int a_row, Json::Value& o_array) const
+{
+    o_array = Json::Value(Json::ValueType::arrayValue);
+    for ( size_t column_index = 0 ; column_index < columns_.size(); ++column_index ) {
+        const Column& column      = columns_[column_index];
+        Json::Value&  json_object = o_array.append(Json::Value(Json::ValueType::objectValue));
+        json_object["name"] = column.name_;
         if ( -1 == a_row ) {
-            for ( size_t column_index = 0 ; column_index < columns_.size(); ++column_index ) {
-                const auto column = columns_[column_index];
-                Json::Value json_object = Json::Value(Json::ValueType::objectValue);
-                json_object["name"] = column.name_;
-                json_object["type"] = Json::nullValue;
-                json_array->append(json_object);
-            }
-        } else {
-            for ( size_t column_index = 0 ; column_index < columns_.size(); ++column_index ) {
-                const auto column = columns_[column_index];
-                Json::Value json_object = Json::Value(Json::ValueType::objectValue);
-                json_object["name"] = column.name_;
-                switch(column.values_[a_row].type_) {
-                    case casper::Term::ENumber:
-                        json_object["type"] = "number";
-                        json_object["data"] = column.values_[a_row].ToNumber();
-                        break;
-                    case casper::Term::EText:
-                        json_object["type"] = "text";
-                        json_object["data"] = column.values_[a_row].AsString();
-                        break;
-                    case casper::Term::EDate:
-                    case casper::Term::EExcelDate:
-                        json_object["type"] = "date";
-                        json_object["data"] = "\"" + column.values_[a_row].AsString() + "\"";
-                        break;
-                    case casper::Term::EBoolean:
-                        json_object["type"] = "boolean";
-                        json_object["data"] = column.values_[a_row].ToBoolean();
-                        break;
-                    case casper::Term::EUndefined:
-                    default:
-                        break;
-                }
-                json_array->append(json_object);
-            }
+            json_object["type"] = Json::nullValue;
+            continue;
+        }
+        Term value;
+        column.Get(a_row, value);
+        switch(value.type_) {
+            case casper::Term::ENumber:
+                json_object["type"] = "number";
+                json_object["data"] = value.ToNumber();
+                break;
+            case casper::Term::EText:
+                json_object["type"] = "text";
+                json_object["data"] = value.AsString();
+                break;
+            case casper::Term::EDate:
+            case casper::Term::EExcelDate:
+                json_object["type"] = "date";
+                json_object["data"] = "\"" + value.AsString() + "\"";
+                break;
+            case casper::Term::EBoolean:
+                json_object["type"] = "boolean";
+                json_object["data"] = value.ToBoolean();
+                break;
+            case casper::Term::EUndefined:
+            default:
+                break;
         }
     }
 }
 
+/**
+ * @brief Tracked rows, in the order of their first lookup, see #TrackedRowToJSON
+ */
+void casper::see::Table::TrackedLookupsToJSON (Json::Value& o_array) const
+{
+    o_array = Json::Value(Json::ValueType::arrayValue);
+    for ( auto row : tracked_lookups_.Order() ) {
+        TrackedRowToJSON(row, o_array.append(Json::Value(Json::ValueType::arrayValue)));
+    }
+}
+
 bool casper::see::Table::Equal (const casper::Term& a_first, const casper::Term& a_second)
 {
     if ( a_first.type_ != a_second.type_ ) {
@@ -513,6 +1141,62 @@ bool casper::see::Table::Lower (const casper::Term& a_first, const casper::Term&
     }
 }
 
+/**
+ * @brief Same as #Equal for terms, @a a_second is a table value
+ */
+bool casper::see::Table::Equal (const casper::Term& a_first, const casper::see::Value& a_second)
+{
+    const unsigned second_type = a_second.GetType();
+
+    if ( a_first.type_ != second_type ) {
+
+        // .. boolean and number exceptions ...
+        if ( casper::Term::ENumber == a_first.type_ && ( casper::Term::EBoolean == second_type || casper::Term::EText == second_type ) ) {
+            return a_first.GetNumber() == a_second.ToNumber();
+        }
+
+        if ( ( casper::Term::EBoolean == a_first.type_ || casper::Term::EText == a_first.type_ ) && casper::Term::ENumber == second_type ) {
+            return a_first.ToNumber() == a_second.GetNumber();
+        }
+
+        return false;
+    }
+
+    switch (a_first.type_) {
+
+        case casper::Term::ENumber:
+            return a_first.number_ == a_second.GetNumber();
+
+        case casper::Term::EText:
+            return strcmp(a_first.text_.c_str(), a_second.GetText().c_str()) == 0;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Same as #Lower for terms, @a a_second is a table value
+ */
+bool casper::see::Table::Lower (const casper::Term& a_first, const casper::see::Value& a_second)
+{
+    if ( a_first.type_ != a_second.GetType() ) {
+        return false;
+    }
+
+    switch (a_first.type_) {
+
+        case casper::Term::ENumber:
+            return a_first.number_ < a_second.GetNumber();
+
+        case casper::Term::EText:
+            return strcmp(a_first.text_.c_str(), a_second.GetText().c_str()) < 0;
+
+        default:
+            return false;
+    }
+}
+
 /**
  * @brief
  *
@@ -23,9 +23,14 @@
 #define NRS_CASPER_CASPER_SEE_TABLE_H
 
 #include "see.h"
+#include "casper/see/value.h"
 #include "json/json.h"
+#include <memory>
+#include <mutex>
+#include <regex>
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace casper
@@ -42,62 +47,137 @@ namespace casper
         {
         public: // Data type
             
+            /**
+             * @brief Running maximum of a column, answers range lookups with a binary search
+             *
+             * The first row greater than a value is also the first row where the running maximum is greater than
+             * it, and the running maximum never decreases. Numbers and texts are kept apart because #Lower never
+             * matches values of different types, NaN rows are skipped because nothing is lower than them.
+             */
+            struct RangeIndex
+            {
+                std::vector<double>   numbers_;  //!< Maximum number up to each row, empty if the column has no numbers
+                std::vector<uint32_t> texts_;    //!< #StringPool handle of the maximum text up to each row, empty if the column has no texts
+            };
+
+            /**
+             * @brief First row of each key of a column, answers exact lookups like a scan with #Equal would
+             *
+             * Numbers match number rows by value and boolean or text rows by their numeric conversion, texts match
+             * text rows by content and number rows by their own numeric conversion, booleans match number rows only.
+             * Texts are keyed by the hash of their content so that lookups don't need to intern the searched text.
+             */
+            struct MatchIndex
+            {
+                std::unordered_map<double, uint32_t>      numbers_;    //!< Number rows by value
+                std::unordered_map<double, uint32_t>      converted_;  //!< Boolean and text rows by numeric conversion
+                std::unordered_multimap<size_t, uint32_t> texts_;      //!< First row of each distinct text by hash of the text
+            };
+
+            /**
+             * @brief Number rows of a column in ascending order, answers SUMIF comparisons
+             *
+             * The rows below, or above, a value are a prefix, or suffix, of #numbers_ found by a binary search,
+             * #rows_ tells which rows they are so that they can be added in row order. NaN rows are left out,
+             * they never compare.
+             */
+            struct SumIndex
+            {
+                std::vector<double>   numbers_;  //!< Number rows sorted in ascending order
+                std::vector<uint32_t> rows_;     //!< Row of each of the #numbers_
+            };
+
+            /**
+             * @brief Column stored by type, numbers and texts in their own arrays
+             *
+             * A column that only holds numbers keeps them in #numbers_, one that only holds texts keeps their
+             * #StringPool handles in #texts_. The first value of another type moves the column to #values_.
+             */
             struct Column
             {
-                std::string       name_;
-                std::vector<Term> values_;
+                enum Storage
+                {
+                    EEmpty,
+                    ENumbers,
+                    ETexts,
+                    EValues
+                };
+
+                std::string                       name_;
+                Storage                           storage_;      //!< Which of the arrays holds the rows
+                std::vector<double>               numbers_;      //!< Rows of a number column
+                std::vector<uint32_t>             texts_;        //!< Rows of a text column
+                std::vector<Value>                values_;       //!< Rows of a column with mixed types
+                std::shared_ptr<const RangeIndex> range_index_;  //!< Built on the first range lookup, reset when rows are added
+                std::shared_ptr<const MatchIndex> match_index_;  //!< Built on the first exact lookup, reset when rows are added
+                std::shared_ptr<const SumIndex>   sum_index_;    //!< Built on the first SUMIF, reset when rows are added
+
+                Column ();
+
+                size_t Size    () const;
+                Value  At      (size_t a_row) const;
+                void   Get     (size_t a_row, Term& o_term) const;
+                double ToNumber (size_t a_row) const;
+                void   Append  (const Value& a_value);
+                void   Reserve (size_t a_rows, unsigned a_type);
+                size_t Bytes   () const;
             };
             
+            /**
+             * @brief Rows returned by the lookups of a tracked table, in the order of their first lookup
+             *
+             * Tracking a row only sets a bit, the JSON is built by #TrackedRowToJSON when it's requested.
+             */
             class TrackedLookups
             {
                 
             public:
                 
-                typedef std::map<int, Json::Value*> AccessMap;
-                typedef std::vector<int>            AccessOrder;
+                typedef std::vector<int> AccessOrder;
                 
             private: // Data
                 
-                AccessMap   access_map_;
-                AccessOrder access_order_;
+                std::vector<bool> tracked_;       //!< One bit per row, set when the row is in #access_order_
+                bool              empty_;         //!< Row -1 is in #access_order_
+                AccessOrder       access_order_;  //!< Tracked rows, -1 when the table had no rows
                 
             public: // Constructor(s) / Destructor
                 
-                virtual ~TrackedLookups ()
+                TrackedLookups ()
                 {
-                    Clear();
+                    empty_ = false;
                 }
                 
             public: // Method(s) / Function(s)
                 
                 inline void Clear ()
                 {
-                    for ( auto m_it : access_map_ ) {
-                        delete m_it.second;
-                    }
-                    access_map_.clear();
+                    tracked_.clear();
+                    empty_ = false;
                     access_order_.clear();
                 }
                 
-                inline Json::Value* JSONObject (int a_row_index)
+                /**
+                 * @return true if the row was not tracked before
+                 */
+                inline bool Track (int a_row_index)
                 {
-                    // ... row already tracked?
-                    for ( size_t idx = 0 ; idx < access_order_.size() ; ++idx ) {
-                        if ( access_order_[idx] == a_row_index ) {
-                            // ... yes ...
-                            return nullptr;
+                    if ( -1 == a_row_index ) {
+                        if ( true == empty_ ) {
+                            return false;
                         }
+                        empty_ = true;
+                    } else {
+                        const size_t row = static_cast<size_t>(a_row_index);
+                        if ( row >= tracked_.size() ) {
+                            tracked_.resize(row + 1, false);
+                        } else if ( true == tracked_[row] ) {
+                            return false;
+                        }
+                        tracked_[row] = true;
                     }
-                    
-                    // ... no... track it now ...
-                    
-                    Json::Value* object = new Json::Value(Json::ValueType::arrayValue);
-                    
-                    access_map_[a_row_index] = object;
-                    
                     access_order_.push_back(a_row_index);
-                    
-                    return object;
+                    return true;
                 }
                 
                 inline const AccessOrder& Order () const
@@ -105,11 +185,6 @@ namespace casper
                     return access_order_;
                 }
                 
-                inline const AccessMap& Map() const
-                {
-                    return access_map_;
-                }
-                
             };
 
         protected: // Attributes
@@ -121,6 +196,10 @@ namespace casper
             bool                          use_exact_match_;
             bool                          track_lookups_;
             TrackedLookups                tracked_lookups_;
+            std::mutex                    index_mutex_;     //!< Serializes the lazy index builds of concurrent lookups
+            uint64_t                      version_;         //!< Changes when rows are added or removed
+            std::string                   tracking_expr_;   //!< Source of #tracking_regex_
+            std::regex                    tracking_regex_;  //!< Compiled column_value_regex of the tracking filter
             
         public: // Methods
 
@@ -132,12 +211,19 @@ namespace casper
              */
             const char* GetName            ();
             void        Load               (Json::Value& a_value, const char* a_name);
+            void        BeginLoad          (const char* a_name);
+            Column&     LoadColumn         (const char* a_name);
+            void        EndColumn          (const Column& a_column, int& io_rows);
+            void        EndLoad            ();
             Column&     AddColumn          (const char* a_name);
             int         GetColumnIndex     (const char* a_colname) const;
             void        Clear              ();
             void        SetPartiallyLoaded (bool a_loaded);
             bool        IsPartialyLoaded   () const;
             int         GetRowCount        () const;
+            size_t      GetCellCount       () const;
+            size_t      GetBytes           () const;
+            uint64_t    GetVersion         () const;
             
             Column*     EnsureColumn     (const char* a_name);
             void        SetColumnValue   (const char* const a_name, const Term& a_value);
@@ -145,29 +231,73 @@ namespace casper
             bool        IsTrackingLookups () const;
             void        SetTrackLookups   (const Json::Value& a_filter, const Json::Value& a_params);
             const       TrackedLookups&   GetTrackedLookups () const;
+            void        TrackedRowToJSON     (int a_row, Json::Value& o_array) const;
+            void        TrackedLookupsToJSON (Json::Value& o_array) const;
             const std::vector<Table::Column>& GetColumns () const;
             
             /*
              * Lookup operations
              */
             void        Lookup    (Term& a_result, Term& a_value, const char* a_search_col, const char* a_result_col);
+            bool        Lookup    (Term& a_result, Term& a_value, int a_search_index, int a_result_index);
             void        Vlookup   (Term& a_result, Term& a_value, const char* a_lookup_col, Term& a_col_index, bool a_range_lookup);
+            bool        Vlookup   (Term& a_result, Term& a_value, int a_search_index, Term& a_col_index, bool a_range_lookup);
+            void        SumIf     (Term& a_result, const char* a_sum_column, const Term& a_criteria);
+            void        SumIf     (Term& a_result, int a_sum_index, const Term& a_criteria);
             void        SumIfs    (Term& a_result, const char* a_sum_column, SymbolTable& a_criteria);
+            void        SumIfs    (Term& a_result, int a_sum_index, SymbolTable& a_criteria);
             double      SumColumn (const char* a_sum_column);
+            double      SumColumn (int a_sum_index);
             
         protected:
             
             void       TrackLookup     (int a_row);
             void       PrepareTracking (const Json::Value& a_filter, const Json::Value& a_params);
+            unsigned   RangeRow        (const Term& a_value, int a_search_index);
+            int        MatchRow        (const Term& a_value, int a_search_index);
+            
+            static void   SelectRows (const Term& a_criteria, const Column& a_column, std::vector<uint8_t>& io_selection);
+            static double SumRows    (const Column& a_column, const std::vector<uint8_t>* a_selection);
+            
+            std::shared_ptr<const RangeIndex> GetRangeIndex (int a_column_index);
+            std::shared_ptr<const MatchIndex> GetMatchIndex (int a_column_index);
+            std::shared_ptr<const SumIndex>   GetSumIndex   (int a_column_index);
             
         public: //
             
             static bool        Equal      (const casper::Term& a_first, const casper::Term& a_second);
             static bool        Lower      (const casper::Term& a_first, const casper::Term& a_second);
+            static bool        Equal      (const casper::Term& a_first, const Value& a_second);
+            static bool        Lower      (const casper::Term& a_first, const Value& a_second);
             static std::string BuildQuery (const std::string& a_query, const Json::Value& a_params);
             
         };
 
+        /**
+         * @brief Table and column indexes a #TableBinding resolved to
+         */
+        struct BoundTable
+        {
+            Table*   table_;       //!< The loaded table
+            int      search_col_;  //!< Search column of LOOKUP and VLOOKUP, summed column of SUM, SUMIF and SUMIFS
+            int      result_col_;  //!< Result column of LOOKUP, -1 for the other functions
+            uint64_t generation_;  //!< Tables generation of the See when it was resolved
+        };
+
+        /**
+         * @brief Table and column names of a LOOKUP, VLOOKUP, SUM, SUMIF or SUMIFS, parsed once when the formula is compiled
+         *
+         * The names are resolved on the first call and again after a table is loaded or unloaded, see See::Bind.
+         */
+        struct TableBinding
+        {
+            std::string                       table_name_;  //!< Table name
+            std::string                       search_col_;  //!< Search or summed column name, empty for the first column
+            std::string                       result_col_;  //!< Result column name of LOOKUP
+            std::shared_ptr<const BoundTable> bound_;       //!< Last resolution, shared by concurrent calculations
+            int                               lines_col_;   //!< VLOOKUP on the LINES table: position of the search column in See::lines_columns_, -1 otherwise
+        };
+
         inline const char* Table::GetName ()
         {
             return name_.c_str();
@@ -205,10 +335,42 @@ namespace casper
             if ( columns_.size() == 0 ) {
                 return 0;
             } else {
-                return (int) (columns_[0].values_.size());
+                return (int) (columns_[0].Size());
             }
         }
         
+        /**
+         * @return number of values held by the table
+         */
+        inline size_t Table::GetCellCount () const
+        {
+            size_t count = 0;
+            for ( auto it = columns_.begin(); it != columns_.end(); ++it ) {
+                count += it->Size();
+            }
+            return count;
+        }
+
+        /**
+         * @return bytes held by the column arrays, the strings are in the #StringPool
+         */
+        inline size_t Table::GetBytes () const
+        {
+            size_t bytes = 0;
+            for ( auto it = columns_.begin(); it != columns_.end(); ++it ) {
+                bytes += it->Bytes();
+            }
+            return bytes;
+        }
+
+        /**
+         * @return a number that changes whenever the rows of the table change
+         */
+        inline uint64_t Table::GetVersion () const
+        {
+            return version_;
+        }
+
         inline Table::Column* Table::EnsureColumn (const char* a_name)
         {
             if ( partially_loaded_ == false ) {
@@ -225,7 +387,13 @@ namespace casper
         
         inline void Table::SetColumnValue (const char* const a_name, const Term& a_value)
         {
-            EnsureColumn(a_name)->values_.push_back(a_value);
+            Column* column = EnsureColumn(a_name);
+
+            column->Append(Value(a_value));
+            column->range_index_.reset();
+            column->match_index_.reset();
+            column->sum_index_.reset();
+            version_++;
         }
         
         inline bool Table::IsTrackingLookups () const
@@ -244,6 +412,46 @@ namespace casper
         {
             return tracked_lookups_;
         }
+
+        inline Table::Column::Column ()
+        {
+            storage_ = EEmpty;
+        }
+
+        inline size_t Table::Column::Size () const
+        {
+            switch (storage_) {
+                case ENumbers: return numbers_.size();
+                case ETexts:   return texts_.size();
+                case EValues:  return values_.size();
+                default:       return 0;
+            }
+        }
+
+        inline Value Table::Column::At (size_t a_row) const
+        {
+            switch (storage_) {
+                case ENumbers: return Value(numbers_[a_row]);
+                case ETexts:   return Value::Text(texts_[a_row]);
+                default:       return values_[a_row];
+            }
+        }
+
+        inline void Table::Column::Get (size_t a_row, Term& o_term) const
+        {
+            At(a_row).Get(o_term);
+        }
+
+        /**
+         * @return the row converted to a number like Term::ToNumber does
+         */
+        inline double Table::Column::ToNumber (size_t a_row) const
+        {
+            if ( ENumbers == storage_ ) {
+                return numbers_[a_row];
+            }
+            return At(a_row).ToNumber();
+        }
     
     } // namespace see
 } // namespace casper
@@ -0,0 +1,675 @@
+/**
+ * @file table_parser.cc Implementation of the streaming Table loader
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/table_parser.h"
+#include "osal/exception.h"
+#include "json/json.h"
+
+#include <errno.h>
+#include <stdlib.h>
+
+/**
+ * @brief Constructor
+ *
+ * @param a_table table that receives the columns, a partially loaded table only takes existing columns
+ * @param a_name  name of the table
+ */
+casper::see::TableParser::TableParser (Table& a_table, const char* a_name)
+    : osal::utils::JsonParserBase(0), table_(a_table), table_name_(a_name)
+{
+    stack_size_ = 16;
+    stack_      = (int*) malloc(sizeof(int) * stack_size_);
+    if ( NULL == stack_ ) {
+        throw OSAL_EXCEPTION_NA("out of memory");
+    }
+    top_        = 0;
+    cs_         = EValue;
+    is_key_     = false;
+    first_      = false;
+    offset_     = 0;
+    rows_       = -1;
+    in_data_    = false;
+    has_name_   = false;
+    has_type_   = false;
+    has_data_   = false;
+    numeric_    = false;
+    column_     = NULL;
+}
+
+/**
+ * @brief Destructor
+ */
+casper::see::TableParser::~TableParser ()
+{
+    /* empty */
+}
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark ::: INCREMENTAL PARSER :::
+#pragma mark -
+#endif
+
+/**
+ * @brief Prepare the parser for a new file
+ */
+bool casper::see::TableParser::InitParse ()
+{
+    osal::utils::JsonParserBase::InitParse();
+    top_      = 0;
+    cs_       = EValue;
+    first_    = false;
+    offset_   = 0;
+    rows_     = -1;
+    in_data_  = false;
+    column_   = NULL;
+    success_  = true;
+    table_.BeginLoad(table_name_.c_str());
+    return true;
+}
+
+/**
+ * @brief Parse the next slice of the file, a token may be split across slices
+ *
+ * @param a_json   slice of the JSON text
+ * @param a_length slice length
+ * @return false on a syntax error, the errors of the table model are thrown
+ */
+bool casper::see::TableParser::ParseSlice (const char* a_json, size_t a_length)
+{
+    size_t idx = 0;
+
+    if ( -1 != error_col_ ) {
+        return false;
+    }
+
+    while ( idx < a_length ) {
+
+        const char c = a_json[idx];
+
+        switch ( cs_ ) {
+
+            case EString:
+            {
+                // ... copy the run of plain characters in one go ...
+                size_t end = idx;
+                while ( end < a_length && '"' != a_json[end] && '\\' != a_json[end] ) {
+                    end++;
+                }
+                token_.append(a_json + idx, end - idx);
+                offset_ += end - idx;
+                idx      = end;
+                if ( idx == a_length ) {
+                    continue;
+                }
+                if ( '\\' == a_json[idx] ) {
+                    token_ += '\\';
+                    string_has_escapes_ = true;
+                    cs_ = EEscape;
+                } else if ( false == EndToken() ) {
+                    return Fail();
+                }
+                break;
+            }
+
+            case EEscape:
+                if ( NULL == strchr("\"\\/bfnrtu", c) || '\0' == c ) {
+                    return Fail();
+                }
+                token_ += c;
+                cs_ = EString;
+                break;
+
+            case ENumber:
+            case ELiteral:
+                if ( ( ENumber == cs_ && ( ( c >= '0' && c <= '9' ) || '.' == c || 'e' == c || 'E' == c || '+' == c || '-' == c ) )
+                    || ( ELiteral == cs_ && c >= 'a' && c <= 'z' ) ) {
+                    token_ += c;
+                    break;
+                }
+                if ( false == EndToken() ) {
+                    return Fail();
+                }
+                continue; // ... the delimiter is parsed in the next state ...
+
+            default:
+
+                if ( ' ' == c || '\n' == c || '\r' == c || '\t' == c ) {
+                    break;
+                }
+
+                switch ( cs_ ) {
+
+                    case EValue:
+                        if ( '{' == c ) {
+                            Open('{');
+                            cs_    = EKey;
+                            first_ = true;
+                        } else if ( '[' == c ) {
+                            Open('[');
+                            cs_    = EValue;
+                            first_ = true;
+                        } else if ( ']' == c && true == first_ && 0 != top_ && '[' == stack_[top_ - 1] ) {
+                            // ... an empty array ...
+                            Close(']');
+                        } else if ( '"' == c ) {
+                            token_.clear();
+                            is_key_             = false;
+                            string_has_escapes_ = false;
+                            cs_                 = EString;
+                        } else if ( '-' == c || ( c >= '0' && c <= '9' ) ) {
+                            token_.assign(1, c);
+                            cs_ = ENumber;
+                        } else if ( 't' == c || 'f' == c || 'n' == c ) {
+                            token_.assign(1, c);
+                            cs_ = ELiteral;
+                        } else {
+                            return Fail();
+                        }
+                        break;
+
+                    case EKey:
+                        if ( '"' == c ) {
+                            token_.clear();
+                            is_key_             = true;
+                            string_has_escapes_ = false;
+                            cs_                 = EString;
+                        } else if ( '}' == c && true == first_ ) {
+                            // ... an empty object ...
+                            Close('}');
+                        } else {
+                            return Fail();
+                        }
+                        break;
+
+                    case EColon:
+                        if ( ':' != c ) {
+                            return Fail();
+                        }
+                        first_ = false;
+                        cs_    = EValue;
+                        break;
+
+                    case EComma:
+                        if ( ',' == c ) {
+                            first_ = false;
+                            cs_    = ( '{' == stack_[top_ - 1] ? EKey : EValue );
+                        } else if ( ( ']' == c && '[' == stack_[top_ - 1] ) || ( '}' == c && '{' == stack_[top_ - 1] ) ) {
+                            Close(c);
+                        } else {
+                            return Fail();
+                        }
+                        break;
+
+                    default: // EDone
+                        // ... like Json::Reader the text after the top array is ignored ...
+                        offset_ += a_length - idx;
+                        return true;
+                }
+                break;
+        }
+        idx++;
+        offset_++;
+    }
+    return true;
+}
+
+/**
+ * @brief Finish the parsing, the file must have ended after the top array
+ */
+bool casper::see::TableParser::FinishParse ()
+{
+    if ( -1 != error_col_ ) {
+        return false;
+    }
+    if ( ENumber == cs_ || ELiteral == cs_ ) {
+        if ( false == EndToken() ) {
+            return Fail();
+        }
+    }
+    if ( EDone != cs_ ) {
+        return Fail();
+    }
+    parse_completed_ = true;
+    return true;
+}
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark ::: TABLE MODEL :::
+#pragma mark -
+#endif
+
+/**
+ * @brief Record a syntax error at the current offset
+ */
+bool casper::see::TableParser::Fail ()
+{
+    error_col_ = (int) offset_;
+    success_   = false;
+    return false;
+}
+
+/**
+ * @brief An array or object starts
+ */
+void casper::see::TableParser::Open (char a_bracket)
+{
+    switch ( top_ ) {
+        case 0:
+            if ( '[' != a_bracket ) {
+                throw OSAL_EXCEPTION_NA("the table top object must be an array");
+            }
+            break;
+        case 1:
+            if ( '{' != a_bracket ) {
+                throw OSAL_EXCEPTION("missing mandatory field %s", "name");
+            }
+            key_.clear();
+            column_name_.clear();
+            pending_.clear();
+            has_name_ = false;
+            has_type_ = false;
+            has_data_ = false;
+            numeric_  = false;
+            column_   = NULL;
+            break;
+        case 2:
+            if ( "data" == key_ ) {
+                if ( '[' != a_bracket ) {
+                    throw OSAL_EXCEPTION_NA("the column data must be an array");
+                }
+                has_data_ = true;
+                in_data_  = true;
+                if ( true == has_name_ && true == has_type_ && NULL == column_ ) {
+                    BeginColumn();
+                }
+            } else if ( "name" == key_ ) {
+                throw OSAL_EXCEPTION_NA("the column name must be a string");
+            } else if ( "type" == key_ ) {
+                has_type_ = true;
+                numeric_  = false;
+            }
+            break;
+        case 3:
+            if ( true == in_data_ ) {
+                throw OSAL_EXCEPTION("column '%s' has an array or object cell", column_name_.c_str());
+            }
+            break;
+        default:
+            break;
+    }
+
+    if ( top_ == stack_size_ ) {
+        int* stack = (int*) realloc(stack_, sizeof(int) * stack_size_ * 2);
+        if ( NULL == stack ) {
+            throw OSAL_EXCEPTION_NA("out of memory");
+        }
+        stack_       = stack;
+        stack_size_ *= 2;
+    }
+    stack_[top_++] = a_bracket;
+}
+
+/**
+ * @brief The innermost array or object ends
+ */
+void casper::see::TableParser::Close (char a_bracket)
+{
+    top_--;
+    cs_ = ( 0 == top_ ? EDone : EComma );
+
+    switch ( top_ ) {
+        case 0:
+            table_.EndLoad();
+            break;
+        case 1:
+            if ( false == has_name_ || false == has_type_ || false == has_data_ ) {
+                throw OSAL_EXCEPTION("missing mandatory field %s", false == has_name_ ? "name" : false == has_type_ ? "type" : "data");
+            }
+            if ( NULL == column_ ) {
+                BeginColumn();
+            }
+            table_.EndColumn(*column_, rows_);
+            column_ = NULL;
+            break;
+        case 2:
+            if ( ']' == a_bracket ) {
+                in_data_ = false;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief A string, number or literal value ends
+ *
+ * @param a_kind 's' string, 'n' number, 't' true, 'f' false or 'z' null
+ */
+void casper::see::TableParser::Scalar (char a_kind)
+{
+    switch ( top_ ) {
+        case 0:
+            throw OSAL_EXCEPTION_NA("the table top object must be an array");
+        case 1:
+            throw OSAL_EXCEPTION("missing mandatory field %s", "name");
+        case 2:
+            Field(a_kind);
+            break;
+        case 3:
+            if ( true == in_data_ ) {
+                if ( NULL != column_ ) {
+                    AppendCell(a_kind, token_);
+                } else {
+                    pending_.push_back(Cell());
+                    pending_.back().kind_ = a_kind;
+                    pending_.back().text_ = token_;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    cs_ = EComma;
+}
+
+/**
+ * @brief A scalar member of the column object ends
+ */
+void casper::see::TableParser::Field (char a_kind)
+{
+    if ( "name" == key_ ) {
+        if ( 'z' == a_kind ) {
+            has_name_ = false;
+        } else if ( 's' == a_kind ) {
+            has_name_    = true;
+            column_name_ = token_;
+        } else {
+            throw OSAL_EXCEPTION_NA("the column name must be a string");
+        }
+    } else if ( "type" == key_ ) {
+        has_type_ = ( 'z' != a_kind );
+        numeric_  = ( 's' == a_kind && "number" == token_ );
+    } else if ( "data" == key_ ) {
+        // ... like Json::Value::size() a scalar has no rows ...
+        has_data_ = ( 'z' != a_kind );
+    }
+}
+
+/**
+ * @brief Create, or find on a partial load, the column and append the cells read before it was known
+ */
+void casper::see::TableParser::BeginColumn ()
+{
+    column_ = &table_.LoadColumn(column_name_.c_str());
+    column_->Reserve(column_->Size() + pending_.size(), numeric_ ? Term::ENumber : Term::EText);
+    for ( auto it = pending_.begin(); it != pending_.end(); ++it ) {
+        AppendCell(it->kind_, it->text_);
+    }
+    std::vector<Cell>().swap(pending_);
+}
+
+/**
+ * @brief Append a cell converted like Json::Value::asDouble or Json::Value::asString
+ */
+void casper::see::TableParser::AppendCell (char a_kind, const std::string& a_text)
+{
+    const char* text    = a_text.c_str();
+    const bool  integer = ( 'n' == a_kind && NULL == strpbrk(text, ".eE") );
+
+    if ( true == numeric_ ) {
+        switch ( a_kind ) {
+            case 'n':
+                if ( true == integer ) {
+                    // ... integers are parsed as 64 bits, -0 is a plain 0 ...
+                    errno = 0;
+                    if ( '-' == text[0] ) {
+                        const long long value = strtoll(text, NULL, 10);
+                        if ( 0 == errno ) {
+                            column_->Append(Value((double) value));
+                            return;
+                        }
+                    } else {
+                        const unsigned long long value = strtoull(text, NULL, 10);
+                        if ( 0 == errno ) {
+                            column_->Append(Value((double) value));
+                            return;
+                        }
+                    }
+                }
+                column_->Append(Value(strtod(text, NULL)));
+                break;
+            case 't':
+                column_->Append(Value(1.0));
+                break;
+            case 'f':
+            case 'z':
+                column_->Append(Value(0.0));
+                break;
+            default:
+                throw OSAL_EXCEPTION("column '%s' has the text '%s' in a number column", column_name_.c_str(), text);
+        }
+    } else {
+        switch ( a_kind ) {
+            case 's':
+                column_->Append(Value(a_text));
+                break;
+            case 'n':
+            {
+                Json::Value number;
+
+                errno = 0;
+                if ( true == integer && '-' == text[0] ) {
+                    const long long value = strtoll(text, NULL, 10);
+                    number = ( 0 == errno ? Json::Value((Json::Int64) value) : Json::Value(strtod(text, NULL)) );
+                } else if ( true == integer ) {
+                    const unsigned long long value = strtoull(text, NULL, 10);
+                    number = ( 0 == errno ? Json::Value((Json::UInt64) value) : Json::Value(strtod(text, NULL)) );
+                } else {
+                    number = Json::Value(strtod(text, NULL));
+                }
+                column_->Append(Value(number.asString()));
+                break;
+            }
+            case 't':
+                column_->Append(Value(std::string("true")));
+                break;
+            case 'f':
+                column_->Append(Value(std::string("false")));
+                break;
+            default:
+                column_->Append(Value(std::string()));
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Close the scanned string, number or literal and hand it to the model
+ *
+ * @return false if the token is not valid JSON
+ */
+bool casper::see::TableParser::EndToken ()
+{
+    switch ( cs_ ) {
+        case EString:
+            if ( true == string_has_escapes_ && false == Unescape(token_) ) {
+                return false;
+            }
+            if ( true == is_key_ ) {
+                if ( 2 == top_ ) {
+                    key_ = token_;
+                }
+                cs_ = EColon;
+            } else {
+                Scalar('s');
+            }
+            return true;
+        case ENumber:
+            if ( false == IsNumber(token_) ) {
+                return false;
+            }
+            Scalar('n');
+            return true;
+        case ELiteral:
+            if ( "true" == token_ ) {
+                Scalar('t');
+            } else if ( "false" == token_ ) {
+                Scalar('f');
+            } else if ( "null" == token_ ) {
+                Scalar('z');
+            } else {
+                return false;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Check a number literal against the JSON grammar, -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+ *
+ * @return true if @a a_text is a complete JSON number
+ */
+bool casper::see::TableParser::IsNumber (const std::string& a_text)
+{
+    const char* p = a_text.c_str();
+
+    if ( '-' == *p ) {
+        p++;
+    }
+    // ... a leading zero is only allowed on it's own ...
+    if ( '0' == *p ) {
+        p++;
+    } else if ( *p >= '1' && *p <= '9' ) {
+        while ( *p >= '0' && *p <= '9' ) {
+            p++;
+        }
+    } else {
+        return false;
+    }
+    if ( '.' == *p ) {
+        p++;
+        if ( *p < '0' || *p > '9' ) {
+            return false;
+        }
+        while ( *p >= '0' && *p <= '9' ) {
+            p++;
+        }
+    }
+    if ( 'e' == *p || 'E' == *p ) {
+        p++;
+        if ( '+' == *p || '-' == *p ) {
+            p++;
+        }
+        if ( *p < '0' || *p > '9' ) {
+            return false;
+        }
+        while ( *p >= '0' && *p <= '9' ) {
+            p++;
+        }
+    }
+    return p == a_text.c_str() + a_text.length();
+}
+
+/**
+ * @brief Replace the escape sequences of a string by the characters they stand for, in place
+ *
+ * @return false on an invalid \\u sequence
+ */
+bool casper::see::TableParser::Unescape (std::string& io_string) const
+{
+    size_t dst = 0;
+
+    for ( size_t src = 0; src < io_string.length(); ++src ) {
+        if ( '\\' != io_string[src] ) {
+            io_string[dst++] = io_string[src];
+            continue;
+        }
+        switch ( io_string[++src] ) {
+            case 'b': io_string[dst++] = '\b'; break;
+            case 'f': io_string[dst++] = '\f'; break;
+            case 'n': io_string[dst++] = '\n'; break;
+            case 'r': io_string[dst++] = '\r'; break;
+            case 't': io_string[dst++] = '\t'; break;
+            case 'u':
+            {
+                uint32_t codepoint = 0;
+
+                for ( int unit = 0; unit < 2; ++unit ) {
+                    uint32_t code_unit = 0;
+
+                    if ( src + 4 >= io_string.length() ) {
+                        return false;
+                    }
+                    for ( int digit = 0; digit < 4; ++digit ) {
+                        const uint8_t hex = kHexTable[(uint8_t) io_string[++src]];
+                        if ( 0xFF == hex ) {
+                            return false;
+                        }
+                        code_unit = ( code_unit << 4 ) | hex;
+                    }
+                    if ( 0 == unit ) {
+                        codepoint = code_unit;
+                        if ( code_unit < 0xD800 || code_unit > 0xDBFF ) {
+                            break;
+                        }
+                        // ... a high surrogate must be followed by the low one ...
+                        if ( src + 2 >= io_string.length() || '\\' != io_string[src + 1] || 'u' != io_string[src + 2] ) {
+                            return false;
+                        }
+                        src += 2;
+                    } else {
+                        if ( code_unit < 0xDC00 || code_unit > 0xDFFF ) {
+                            return false;
+                        }
+                        codepoint = 0x10000 + ( ( codepoint & 0x3FF ) << 10 ) + ( code_unit & 0x3FF );
+                    }
+                }
+
+                if ( codepoint <= 0x7F ) {
+                    io_string[dst++] = (char) codepoint;
+                } else if ( codepoint <= 0x7FF ) {
+                    io_string[dst++] = (char) (0xC0 | ((codepoint >> 6) & 0x1F));
+                    io_string[dst++] = (char) (0x80 |  (codepoint       & 0x3F));
+                } else if ( codepoint <= 0xFFFF ) {
+                    io_string[dst++] = (char) (0xE0 | ((codepoint >> 12) & 0x0F));
+                    io_string[dst++] = (char) (0x80 | ((codepoint >> 6)  & 0x3F));
+                    io_string[dst++] = (char) (0x80 |  (codepoint        & 0x3F));
+                } else {
+                    io_string[dst++] = (char) (0xF0 | ((codepoint >> 18) & 0x07));
+                    io_string[dst++] = (char) (0x80 | ((codepoint >> 12) & 0x3F));
+                    io_string[dst++] = (char) (0x80 | ((codepoint >> 6)  & 0x3F));
+                    io_string[dst++] = (char) (0x80 |  (codepoint        & 0x3F));
+                }
+                break;
+            }
+            default: // '"', '\\' and '/'
+                io_string[dst++] = io_string[src];
+                break;
+        }
+    }
+    io_string.resize(dst);
+    return true;
+}
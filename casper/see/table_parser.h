@@ -0,0 +1,131 @@
+#pragma once
+/**
+ * @file table_parser.h declaration of the streaming Table loader
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef NRS_CASPER_CASPER_SEE_TABLE_PARSER_H
+#define NRS_CASPER_CASPER_SEE_TABLE_PARSER_H
+
+#include "osal/utils/json_parser_base.h"
+#include "casper/see/table.h"
+#include <string>
+#include <vector>
+
+namespace casper
+{
+    namespace see
+    {
+
+        /**
+         * @brief Incremental parser of the table JSON files, appends the rows straight into a #Table
+         *
+         * The file is an array of column objects with a "name", a "type" and a "data" array, the same model
+         * #Table::Load reads from a parsed document. The text is fed in slices of any size, the cells are
+         * converted like Json::Value::asDouble and Json::Value::asString would and no document is built. A
+         * column whose "data" comes before it's "name" or "type" keeps the cells until the object ends.
+         */
+        class TableParser : public osal::utils::JsonParserBase
+        {
+        protected: // Data types
+
+            /**
+             * @brief Parser states
+             */
+            enum State
+            {
+                EValue,        //!< Before a value
+                EKey,          //!< Before an object key or the end of the object
+                EColon,        //!< After an object key
+                EComma,        //!< After a value
+                EString,       //!< Inside a string
+                EEscape,       //!< After a backslash inside a string
+                ENumber,       //!< Inside a number
+                ELiteral,      //!< Inside true, false or null
+                EDone          //!< After the top array
+            };
+
+            /**
+             * @brief Cell of a column kept until it's type is known
+             */
+            struct Cell
+            {
+                char        kind_;  //!< 's' string, 'n' number, 't' true, 'f' false or 'z' null
+                std::string text_;  //!< The string or the number literal
+            };
+
+        protected: // Data
+
+            Table&            table_;         //!< Table being loaded
+            std::string       table_name_;    //!< Name of the table
+            std::string       token_;         //!< String, number or literal being scanned
+            bool              is_key_;        //!< #token_ is an object key
+            bool              first_;         //!< No element was read yet from the innermost array or object
+            std::string       key_;           //!< Last key of the column object
+            size_t            offset_;        //!< Bytes parsed so far
+            int               rows_;          //!< Height of the loaded columns, -1 before the first one
+            bool              in_data_;       //!< Inside the "data" array of a column
+            bool              has_name_;      //!< The column has a non null "name"
+            bool              has_type_;      //!< The column has a non null "type"
+            bool              has_data_;      //!< The column has a non null "data"
+            std::string       column_name_;   //!< Value of "name"
+            bool              numeric_;       //!< The "type" is "number"
+            Table::Column*    column_;        //!< Column receiving the cells, NULL until the name and type are known
+            std::vector<Cell> pending_;       //!< Cells read before the name and type were known
+
+        public: // Constructor(s) / Destructor
+
+            TableParser (Table& a_table, const char* a_name);
+            virtual ~TableParser ();
+
+        public: // Method(s) / Function(s)
+
+            virtual bool InitParse   ();
+            virtual bool ParseSlice  (const char* a_json, size_t a_length);
+            virtual bool FinishParse ();
+
+            size_t ErrorOffset () const;
+
+        protected: // Method(s) / Function(s)
+
+            bool Fail         ();
+            void Open         (char a_bracket);
+            void Close        (char a_bracket);
+            void Scalar       (char a_kind);
+            void Field        (char a_kind);
+            void AppendCell   (char a_kind, const std::string& a_text);
+            void BeginColumn  ();
+            bool Unescape     (std::string& io_string) const;
+            bool EndToken     ();
+
+            static bool IsNumber (const std::string& a_text);
+
+        };
+
+        /**
+         * @return offset of the byte where the syntax error was found
+         */
+        inline size_t TableParser::ErrorOffset () const
+        {
+            return offset_;
+        }
+
+    } // namespace see
+} // namespace casper
+
+#endif // NRS_CASPER_CASPER_SEE_TABLE_PARSER_H
@@ -0,0 +1,143 @@
+/**
+ * @file batch_test.cc checks that a batch calculation matches one calculation per parameter set
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/test/test_helpers.h"
+
+#include <random>
+#include <vector>
+
+/*
+ * The lanes calculate the numeric formulas together, CONCATENATE, IFERROR and the comparisons with a text are
+ * calculated lane by lane, c5 divides by zero in the lanes where p1 is 5.
+ */
+static const char* k_model_ = R"JSON({
+ "values":   { "p1": {"type":"DECIMAL","value":"p1"},    "p2": {"type":"DECIMAL","value":"p2"},
+               "p3": {"type":"TEXT",   "value":"p3"},    "p4": {"type":"DECIMAL","value":"p4"},
+               "A4": {"type":"DECIMAL","value":"k1=1.5"} },
+ "formulas": { "B1": {"type":"DECIMAL","value":"c1=ROUND(p1*k1+p2/4,2)"},
+               "B2": {"type":"DECIMAL","value":"c2=IF(p1>3,c1*2,c1-p2)"},
+               "B3": {"type":"DECIMAL","value":"c3=MAX(c1,c2,1)-MIN(p1,p2)"},
+               "B4": {"type":"DECIMAL","value":"c4=ROUNDUP(c2/3,1)+ROUNDDOWN(-c1/7,2)+ABS(p2-p1)+p2^2"},
+               "B5": {"type":"DECIMAL","value":"c5=IF(p1=5,0,p2/(p1-5))"},
+               "B6": {"type":"DECIMAL","value":"c6=(p1>=p2)+(p1<=2)+(p1<>p2)+IF(c2)"},
+               "B7": {"type":"DECIMAL","value":"c7=k1*10"},
+               "B8": {"type":"DECIMAL","value":"c8=c7+c3"},
+               "B9": {"type":"TEXT",   "value":"c9=CONCATENATE(p3,\"-\",c1)"},
+               "B10":{"type":"DECIMAL","value":"c10=IF(p3=\"x\",1,2)+c4"},
+               "B11":{"type":"DECIMAL","value":"c11=IFERROR(1/(p2-3),c1)+c10"} },
+ "lines": { "header": { "C20": {"type":"DECIMAL","name":"AMT"} }, "values": [ ], "formulas": [ ] }
+})JSON";
+
+/*
+ * The LINES sums are not calculated by lanes, the batch falls back to incremental calculations
+ */
+static const char* k_lines_model_ = R"JSON({
+ "values":   { "p1": {"type":"DECIMAL","value":"p1"},    "p2": {"type":"DECIMAL","value":"p2"} },
+ "formulas": { "B1": {"type":"DECIMAL","value":"c1=p1*2+p2"},
+               "B2": {"type":"DECIMAL","value":"c2=SUM(LINES[AMT])+c1"} },
+ "lines": { "header": { "C10": {"type":"DECIMAL","name":"AMT"} },
+            "values":   [ ],
+            "formulas": [ {"AMT":"C11=c1*2"}, {"AMT":"C12=p1+p2"} ] }
+})JSON";
+
+/**
+ * @brief Calculate each parameter set on it's own, the reference results
+ */
+static void CalculateEach (const char* a_model, const std::vector<Json::Value>& a_params, std::vector<Json::Value>& o_results)
+{
+    casper::see::test::TestSee see;
+    see.LoadModelFromString(a_model);
+    o_results.resize(a_params.size());
+    for ( size_t i = 0; i < a_params.size(); ++i ) {
+        see.CalculateAll(a_params[i]);
+        see.SerializeScalarsToJSONObject(o_results[i]);
+    }
+}
+
+/**
+ * @brief Calculate the parameter sets as one batch and compare with the reference, then check that an
+ *        incremental calculation after the batch starts from the last lane
+ */
+static void CheckBatch (const char* a_test, const char* a_model, const std::vector<Json::Value>& a_params)
+{
+    std::vector<Json::Value>   reference, batch;
+    Json::Value                after;
+    casper::see::test::TestSee see;
+
+    CalculateEach(a_model, a_params, reference);
+
+    see.SetIncremental(true);
+    see.LoadModelFromString(a_model);
+    see.CalculateBatch(a_params, batch);
+    CASPER_CHECK(batch.size() == a_params.size(), "%s: %zu results for %zu lanes", a_test, batch.size(), a_params.size());
+    for ( size_t i = 0; i < batch.size() && i < reference.size(); ++i ) {
+        CASPER_CHECK(batch[i] == reference[i], "%s, lane %zu %s: batch %s reference %s", a_test, i,
+                     a_params[i].toStyledString().c_str(), batch[i].toStyledString().c_str(),
+                     reference[i].toStyledString().c_str());
+    }
+
+    see.CalculateAll(a_params[1]);
+    see.SerializeScalarsToJSONObject(after);
+    CASPER_CHECK(after == reference[1], "%s, after the batch: %s reference %s", a_test, after.toStyledString().c_str(),
+                 reference[1].toStyledString().c_str());
+}
+
+int main (int /* a_argc */, char** /* a_argv */)
+{
+    const char*              texts[] = { "x", "y", "7" };
+    std::mt19937             generator(7);
+    std::vector<Json::Value> params(300);
+
+    for ( size_t i = 0; i < params.size(); ++i ) {
+        params[i]["p1"] = static_cast<double>(generator() % 12) - 2.0;
+        params[i]["p2"] = static_cast<double>(generator() % 16) / 4.0;
+        params[i]["p3"] = texts[generator() % 3];
+        // ... a number as text is not a plain number, those lanes are calculated one by one ...
+        if ( 0 == i % 50 ) {
+            params[i]["p2"] = "2.5";
+        }
+    }
+
+    try {
+        CheckBatch("lanes", k_model_, params);
+
+        std::vector<Json::Value> shared(params.begin(), params.begin() + 20);
+        for ( auto& lane : shared ) {
+            lane["p3"] = "x";
+        }
+        CheckBatch("only numbers vary", k_model_, shared);
+
+        std::vector<Json::Value> names(params.begin(), params.begin() + 20);
+        names[7]["p3"] = Json::Value(Json::nullValue);
+        names[9]["p4"] = 1.0;
+        CheckBatch("different names", k_model_, names);
+
+        std::vector<Json::Value> lines(params.begin(), params.begin() + 40);
+        for ( auto& lane : lines ) {
+            lane.removeMember("p3");
+        }
+        CheckBatch("lines", k_lines_model_, lines);
+    } catch (const osal::Exception& a_exception) {
+        CASPER_CHECK(false, "%s", a_exception.Message());
+    }
+
+    return casper::see::test::Summary("batch_test");
+}
@@ -0,0 +1,152 @@
+/**
+ * @file context_stress_test.cc checks that threads calculating one shared model match the serial results
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Meant to be built with SANITIZE=thread as well, the contexts share the formulas, the tables and the
+ * lazy loading of the tables.
+ */
+
+#include "casper/see/test/test_helpers.h"
+#include "casper/see/table.h"
+#include "casper/see/value.h"
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+static const int k_threads_ = 8;
+static const int k_sets_    = 200;
+static const int k_rounds_  = 10;
+
+static const char* k_model_ = R"JSON({
+ "values":   { "A1": {"type":"DECIMAL","value":"p1=1"}, "A2": {"type":"DECIMAL","value":"p2=2"},
+               "A3": {"type":"TEXT","value":"p3=\"a\""} },
+ "formulas": { "B1": {"type":"DECIMAL","value":"r1=p1*2+p2"},
+               "B2": {"type":"DECIMAL","value":"r2=IF(r1>10,r1-1,r1+1)"},
+               "B3": {"type":"DECIMAL","value":"r3=VLOOKUP(p1,RATES,2)"},
+               "B4": {"type":"DECIMAL","value":"r4=SUMIFS(RATES[rate],RATES[kind],p3)"},
+               "B5": {"type":"DECIMAL","value":"r5=r2*r3+r4"},
+               "B6": {"type":"DECIMAL","value":"r6=SUM(LINES[AMT])"},
+               "B7": {"type":"DECIMAL","value":"r7=IF(p2>5,VLOOKUP(p2,RATES,2),r6/2)"} },
+ "lines": { "header": { "C10": {"type":"DECIMAL","name":"AMT"}, "D10": {"type":"TEXT","name":"KIND"} },
+            "values":   [ {"KIND":"D11=\"a\""}, {"KIND":"D12=\"b\""}, {"KIND":"D13=\"c\""} ],
+            "formulas": [ {"AMT":"C11=p1*3"}, {"AMT":"C12=p2+r1"}, {"AMT":"C13=r5-p1"} ] }
+})JSON";
+
+static const char* k_rates_ = R"JSON([
+ {"name":"code","type":"number","data":[1,2,3,4,5,6,7,8,9,10]},
+ {"name":"rate","type":"number","data":[0.5,1.5,2.25,3,4.75,5,6.5,7,8.125,9]},
+ {"name":"kind","type":"text","data":["a","b","a","c","b","a","c","a","b","c"]}
+])JSON";
+
+/**
+ * @brief Calculate random parameter sets on several threads, each with it's own context, and compare each
+ *        result with the serial one
+ */
+static void CheckThreads (const char* a_test, casper::see::test::TestSee& a_see, const std::vector<Json::Value>& a_params,
+                          const std::vector<Json::Value>& a_expected)
+{
+    std::atomic<int>         mismatches(0), errors(0);
+    std::vector<std::thread> pool;
+
+    for ( int t = 0; t < k_threads_; ++t ) {
+        pool.emplace_back([&, t] {
+            casper::see::EvalContext context;
+            std::mt19937             generator(t);
+
+            a_see.InitContext(context);
+            for ( int k = 0; k < k_rounds_ * k_sets_ / k_threads_; ++k ) {
+                const size_t i = generator() % a_params.size();
+                Json::Value  result;
+                try {
+                    a_see.CalculateAll(a_params[i], context);
+                    a_see.SerializeScalarsToJSONObject(context, result);
+                } catch (const osal::Exception& a_exception) {
+                    if ( 0 == errors++ ) {
+                        fprintf(stderr, "%s, set %zu: %s\n", a_test, i, a_exception.Message());
+                    }
+                    continue;
+                }
+                if ( result != a_expected[i] && 0 == mismatches++ ) {
+                    fprintf(stderr, "%s, set %zu: %s expected %s\n", a_test, i, result.toStyledString().c_str(),
+                            a_expected[i].toStyledString().c_str());
+                }
+            }
+        });
+    }
+    for ( auto& thread : pool ) {
+        thread.join();
+    }
+
+    CASPER_CHECK(0 == mismatches.load(), "%s: %d mismatches", a_test, mismatches.load());
+    CASPER_CHECK(0 == errors.load(), "%s: %d errors", a_test, errors.load());
+}
+
+int main (int /* a_argc */, char** /* a_argv */)
+{
+    const char*              kinds[] = { "a", "b", "c", "z" };
+    std::mt19937             generator(7);
+    std::vector<Json::Value> params(k_sets_), expected(k_sets_);
+
+    for ( auto& set : params ) {
+        set["p1"] = static_cast<double>(1 + generator() % 10);
+        set["p2"] = static_cast<double>(generator() % 11);
+        set["p3"] = kinds[generator() % 4];
+    }
+
+    try {
+        casper::see::test::TempDir tables;
+        tables.Write("RATES.json", k_rates_);
+
+        casper::see::test::TestSee see;
+        see.SetJsonTablesPath(tables.Path());
+        see.LoadModelFromString(k_model_);
+
+        // ... serial reference, on the model's own context ...
+        for ( size_t i = 0; i < params.size(); ++i ) {
+            see.CalculateAll(params[i]);
+            see.SerializeScalarsToJSONObject(expected[i]);
+        }
+
+        // ... the contexts load the table on first use, at the same time ...
+        see.UnloadTable("RATES");
+        CheckThreads("lazy table", see, params, expected);
+
+        // ... rows no parameter reaches, the rest of the table is read from disk on first use ...
+        see.UnloadTable("RATES");
+        casper::see::Table* partial = new casper::see::Table("RATES", true);
+        // ... AddColumn may move the columns added before, each one is filled before the next is added ...
+        casper::see::Table::Column& code = partial->AddColumn("code");
+        code.Append(casper::see::Value(11.0));
+        code.Append(casper::see::Value(12.0));
+        casper::see::Table::Column& rate = partial->AddColumn("rate");
+        rate.Append(casper::see::Value(100.0));
+        rate.Append(casper::see::Value(100.0));
+        casper::see::Table::Column& kind = partial->AddColumn("kind");
+        kind.Append(casper::see::Value(std::string("y")));
+        kind.Append(casper::see::Value(std::string("x")));
+        see.LoadTable(partial);
+        CheckThreads("partial table", see, params, expected);
+    } catch (const osal::Exception& a_exception) {
+        CASPER_CHECK(false, "%s", a_exception.Message());
+    }
+
+    return casper::see::test::Summary("context_stress_test");
+}
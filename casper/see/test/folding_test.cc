@@ -0,0 +1,99 @@
+/**
+ * @file folding_test.cc checks that the folded formulas calculate the results of the unfolded model
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/test/test_helpers.h"
+
+#include <random>
+#include <vector>
+
+static const char* k_model_ = R"JSON({
+ "values":   { "p1": {"type":"DECIMAL","value":"p1"},    "p2": {"type":"DECIMAL","value":"p2"},
+               "A3": {"type":"DECIMAL","value":"k1=3"},  "A4": {"type":"DECIMAL","value":"k2=0.25"},
+               "A5": {"type":"TEXT",   "value":"k3=\"x\""} },
+ "formulas": { "B1": {"type":"DECIMAL","value":"c1=k1*2+k2"},
+               "B2": {"type":"DECIMAL","value":"c2=IF(c1>5,ROUND(c1/7,2),c1)"},
+               "B3": {"type":"TEXT",   "value":"c3=k3&\"-\"&c2"},
+               "B4": {"type":"DECIMAL","value":"r1=p1*c2+k2"},
+               "B5": {"type":"DECIMAL","value":"r2=IF(p2>c1,r1-c2,MAX(r1,k1))"},
+               "B6": {"type":"DECIMAL","value":"r3=SUM(LINES[AMT])+c1"},
+               "B7": {"type":"TEXT",   "value":"r4=IF(p2>1,c3,k3)"} },
+ "lines": { "header": { "C10": {"type":"DECIMAL","name":"AMT"} },
+            "values":   [ ],
+            "formulas": [ {"AMT":"C11=c1*2"}, {"AMT":"C12=p1+c2"}, {"AMT":"C13=r2-k1"} ] }
+})JSON";
+
+/**
+ * @brief Calculate the parameter sets on a model loaded with or without constant folding
+ */
+static void Calculate (bool a_folding, bool a_incremental, const std::vector<Json::Value>& a_params,
+                       std::vector<Json::Value>& o_results, size_t& o_folded)
+{
+    casper::see::test::TestSee see;
+    see.SetConstantFolding(a_folding);
+    see.SetIncremental(a_incremental);
+    see.LoadModelFromString(k_model_);
+    o_folded = see.FoldedFormulasCount();
+    o_results.resize(a_params.size());
+    for ( size_t i = 0; i < a_params.size(); ++i ) {
+        see.CalculateAll(a_params[i]);
+        see.SerializeScalarsToJSONObject(o_results[i]);
+    }
+}
+
+int main (int /* a_argc */, char** /* a_argv */)
+{
+    std::mt19937             generator(4);
+    std::vector<Json::Value> params(200);
+    for ( size_t i = 0; i < params.size(); ++i ) {
+        params[i]["p1"] = static_cast<double>(generator() % 20) - 5.0;
+        params[i]["p2"] = static_cast<double>(generator() % 12);
+        // ... every fourth set overrides a literal the folded formulas read ...
+        if ( 0 == i % 4 ) {
+            params[i]["k1"] = static_cast<double>(generator() % 6);
+        }
+        if ( 0 == i % 7 ) {
+            params[i]["k3"] = "y";
+        }
+    }
+
+    try {
+        std::vector<Json::Value> folded, unfolded, incremental;
+        size_t folded_count = 0, unfolded_count = 0, incremental_count = 0;
+        Calculate(true , false, params, folded     , folded_count);
+        Calculate(false, false, params, unfolded   , unfolded_count);
+        Calculate(true , true , params, incremental, incremental_count);
+
+        CASPER_CHECK(folded_count > 0  , "the model has formulas to fold");
+        CASPER_CHECK(0 == unfolded_count, "%zu formulas folded with folding disabled", unfolded_count);
+        for ( size_t i = 0; i < params.size(); ++i ) {
+            CASPER_CHECK(folded[i] == unfolded[i], "set %zu %s: folded %s unfolded %s", i,
+                         params[i].toStyledString().c_str(), folded[i].toStyledString().c_str(),
+                         unfolded[i].toStyledString().c_str());
+            CASPER_CHECK(incremental[i] == unfolded[i], "set %zu %s: incremental %s unfolded %s", i,
+                         params[i].toStyledString().c_str(), incremental[i].toStyledString().c_str(),
+                         unfolded[i].toStyledString().c_str());
+        }
+    } catch (const osal::Exception& a_exception) {
+        CASPER_CHECK(false, "%s", a_exception.Message());
+    }
+
+    return casper::see::test::Summary("folding_test");
+}
@@ -0,0 +1,91 @@
+/**
+ * @file lines_vlookup_test.cc checks VLOOKUP on the cloned LINES table, whatever the case of the table name
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/test/test_helpers.h"
+
+static const int k_rows_ = 5;
+
+/**
+ * @brief Model whose r1 looks up p1 in the CODE column of the LINES table, spelled @a a_table
+ */
+static std::string Model (const char* a_table)
+{
+    char model[1024];
+
+    snprintf(model, sizeof(model), R"JSON({
+ "values":   { "p1": {"type":"DECIMAL","value":"p1"} },
+ "formulas": { "B1": {"type":"DECIMAL","value":"r1=VLOOKUP(p1,%s[CODE],2,FALSE)"},
+               "B2": {"type":"DECIMAL","value":"r2=VLOOKUP(p1+0.5,%s[CODE],2,TRUE)+r1"} },
+ "lines": { "header": { "C10": {"type":"DECIMAL","name":"CODE"}, "D10": {"type":"DECIMAL","name":"RATE"} },
+            "values": [ ], "formulas": [ ] }
+})JSON", a_table, a_table);
+    return model;
+}
+
+/**
+ * @brief Clone one line per code, the rate of code n is p1 * n * 10
+ */
+static void CloneLines (Json::Value& a_lines, size_t& o_number_of_added_lines)
+{
+    char cell[64];
+
+    for ( int row = 11; row < 11 + k_rows_; ++row ) {
+        Json::Value formulas;
+        snprintf(cell, sizeof(cell), "C%d=%d", row, row - 10);
+        formulas["CODE"] = cell;
+        snprintf(cell, sizeof(cell), "D%d=p1*%d", row, ( row - 10 ) * 10);
+        formulas["RATE"] = cell;
+        a_lines["formulas"].append(formulas);
+        a_lines["values"].append(Json::Value(Json::objectValue));
+    }
+    o_number_of_added_lines = k_rows_;
+}
+
+int main (int /* a_argc */, char** /* a_argv */)
+{
+    for ( auto table : { "lines", "LINES", "Lines" } ) {
+        try {
+            casper::see::test::TestSee see;
+            casper::StringMultiHash    clones;
+            Json::Value                model;
+
+            see.SetIncremental(true);
+            CASPER_CHECK(true == Json::Reader().parse(Model(table), model), "%s: invalid model", table);
+            see.LoadModel(model, clones, nullptr, CloneLines);
+
+            // ... the same engine, so the lookups also follow the parameter incrementally ...
+            for ( int code = 1; code <= k_rows_; ++code ) {
+                Json::Value params, result;
+                params["p1"] = static_cast<double>(code);
+                see.CalculateAll(params);
+                see.SerializeScalarsToJSONObject(result);
+
+                const double rate = code * code * 10.0;
+                CASPER_CHECK(result["r1"].asDouble() == rate && result["r2"].asDouble() == 2 * rate,
+                             "%s, p1 = %d: %s", table, code, result.toStyledString().c_str());
+            }
+        } catch (const osal::Exception& a_exception) {
+            CASPER_CHECK(false, "%s: %s", table, a_exception.Message());
+        }
+    }
+
+    return casper::see::test::Summary("lines_vlookup_test");
+}
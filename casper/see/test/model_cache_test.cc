@@ -0,0 +1,158 @@
+/**
+ * @file model_cache_test.cc checks that a damaged model cache is ignored and rebuilt from the JSON model
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Meant to be built with SANITIZE=address as well, a cache that ends in the middle of a formula must not
+ * leak the formulas read before.
+ */
+
+#include "casper/see/test/test_helpers.h"
+#include "casper/see/model_cache.h"
+
+#include <string.h>
+
+static const char* k_model_ = R"JSON({
+ "values":   { "p1": {"type":"DECIMAL","value":"p1"}, "p2": {"type":"DECIMAL","value":"p2"},
+               "A3": {"type":"DECIMAL","value":"k1=2.5"} },
+ "formulas": { "B1": {"type":"DECIMAL","value":"r1=ROUND(p1*k1+p2,2)"},
+               "B2": {"type":"DECIMAL","value":"r2=IF(r1>10,r1-1,r1+1)"},
+               "B3": {"type":"DECIMAL","value":"r3=SUM(LINES[AMT])+r2"} },
+ "lines": { "header": { "C10": {"type":"DECIMAL","name":"AMT"} },
+            "values":   [ ],
+            "formulas": [ {"AMT":"C11=p1*3"}, {"AMT":"C12=p2+r1"}, {"AMT":"C13=r2-p1"} ] }
+})JSON";
+
+/**
+ * @return contents of a file, empty if it can't be read
+ */
+static std::string ReadFile (const std::string& a_name)
+{
+    std::string contents;
+    char        buffer[4096];
+    size_t      length;
+
+    FILE* file = fopen(a_name.c_str(), "rb");
+    if ( nullptr == file ) {
+        return contents;
+    }
+    while ( 0 != ( length = fread(buffer, 1, sizeof(buffer), file) ) ) {
+        contents.append(buffer, length);
+    }
+    fclose(file);
+    return contents;
+}
+
+/**
+ * @brief Load the model with the cache and calculate one parameter set
+ *
+ * @return the scalars
+ */
+static Json::Value Calculate (const std::string& a_model_file, const std::string& a_cache_file)
+{
+    casper::see::test::TestSee see;
+    casper::StringMultiHash    clones;
+    Json::Value                params, result;
+
+    see.SetModelCacheFile(a_cache_file.c_str());
+    see.LoadModelFromFile(a_model_file.c_str(), clones);
+    params["p1"] = 3.0;
+    params["p2"] = 1.25;
+    see.CalculateAll(params);
+    see.SerializeScalarsToJSONObject(result);
+    return result;
+}
+
+/**
+ * @brief Write a damaged cache, the load must ignore it, match the reference and write a good cache again
+ */
+static void CheckDamaged (const char* a_test, const std::string& a_model_file, const std::string& a_cache_file,
+                          const std::string& a_damaged, const Json::Value& a_reference, size_t a_cache_size)
+{
+    FILE* file = fopen(a_cache_file.c_str(), "wb");
+    CASPER_CHECK(nullptr != file, "%s: unable to write %s", a_test, a_cache_file.c_str());
+    if ( nullptr == file ) {
+        return;
+    }
+    fwrite(a_damaged.data(), 1, a_damaged.size(), file);
+    fclose(file);
+
+    const Json::Value result = Calculate(a_model_file, a_cache_file);
+    CASPER_CHECK(result == a_reference, "%s: %s reference %s", a_test, result.toStyledString().c_str(),
+                 a_reference.toStyledString().c_str());
+
+    const std::string rebuilt = ReadFile(a_cache_file);
+    CASPER_CHECK(rebuilt.size() == a_cache_size && rebuilt != a_damaged, "%s: the cache was not rebuilt", a_test);
+}
+
+/**
+ * @return @a a_data with a valid checksum in place of it's last 8 bytes, so that the reader parses it
+ */
+static std::string Checksummed (const std::string& a_data)
+{
+    std::string    data     = a_data.substr(0, a_data.size() - sizeof(uint64_t));
+    const uint64_t checksum = casper::see::ModelCache::Hash(data.data(), data.size());
+    data.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+    return data;
+}
+
+int main (int /* a_argc */, char** /* a_argv */)
+{
+    try {
+        casper::see::test::TempDir folder;
+        const std::string          model_file = folder.Write("model.json", k_model_);
+        const std::string          cache_file = folder.Path() + "model.cache";
+        char                       test[64];
+
+        // ... the first load writes the cache, the second one reads it ...
+        const Json::Value reference = Calculate(model_file, cache_file);
+        const std::string cache     = ReadFile(cache_file);
+        CASPER_CHECK(cache.size() > 0, "the cache was not written");
+        if ( 0 == cache.size() ) {
+            return casper::see::test::Summary("model_cache_test");
+        }
+        const Json::Value cached = Calculate(model_file, cache_file);
+        CASPER_CHECK(cached == reference, "cached: %s reference %s", cached.toStyledString().c_str(),
+                     reference.toStyledString().c_str());
+
+        const size_t step = cache.size() / 50 + 1;
+        for ( size_t length = 0; length < cache.size(); length += step ) {
+            snprintf(test, sizeof(test), "truncated to %zu bytes", length);
+            CheckDamaged(test, model_file, cache_file, cache.substr(0, length), reference, cache.size());
+        }
+
+        for ( size_t offset = 0; offset < cache.size(); offset += step ) {
+            std::string corrupted = cache;
+            corrupted[offset] ^= 0x5a;
+            snprintf(test, sizeof(test), "byte %zu corrupted", offset);
+            CheckDamaged(test, model_file, cache_file, corrupted, reference, cache.size());
+        }
+
+        // ... a valid checksum over truncated data, the reader runs out of data half way through the formulas ...
+        const size_t data_size = cache.size() - sizeof(uint64_t);
+        for ( size_t length = data_size / 2; length < data_size; length += data_size / 40 + 1 ) {
+            snprintf(test, sizeof(test), "data cut at %zu bytes", length);
+            CheckDamaged(test, model_file, cache_file, Checksummed(cache.substr(0, length) + std::string(sizeof(uint64_t), '\0')),
+                         reference, cache.size());
+        }
+    } catch (const osal::Exception& a_exception) {
+        CASPER_CHECK(false, "%s", a_exception.Message());
+    }
+
+    return casper::see::test::Summary("model_cache_test");
+}
@@ -0,0 +1,136 @@
+/**
+ * @file parallel_test.cc checks that the level by level parallel calculation matches the serial one
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/test/test_helpers.h"
+
+#include <random>
+#include <vector>
+
+static const int k_rows_ = 60;
+
+/**
+ * @brief Model whose scalars sum a LINES table calculated from the parameters
+ */
+static std::string Model ()
+{
+    const char* kinds[] = { "a", "b", "c" };
+    Json::Value model;
+
+    model["values"]["p1"]["type"]  = "DECIMAL";
+    model["values"]["p1"]["value"] = "p1";
+    model["values"]["p2"]["type"]  = "DECIMAL";
+    model["values"]["p2"]["value"] = "p2";
+    model["values"]["p3"]["type"]  = "TEXT";
+    model["values"]["p3"]["value"] = "p3";
+    model["values"]["A4"]["type"]  = "DECIMAL";
+    model["values"]["A4"]["value"] = "k1=1.5";
+
+    model["lines"]["header"]["C10"]["type"] = "DECIMAL";
+    model["lines"]["header"]["C10"]["name"] = "AMT";
+    model["lines"]["header"]["D10"]["type"] = "TEXT";
+    model["lines"]["header"]["D10"]["name"] = "KIND";
+    model["lines"]["header"]["E10"]["type"] = "DECIMAL";
+    model["lines"]["header"]["E10"]["name"] = "RATE";
+    model["lines"]["values"]   = Json::Value(Json::arrayValue);
+    model["lines"]["formulas"] = Json::Value(Json::arrayValue);
+    for ( int row = 11; row < 11 + k_rows_; ++row ) {
+        char        cell[128];
+        Json::Value value, formula;
+
+        snprintf(cell, sizeof(cell), "D%d=\"%s\"", row, kinds[row % 3]);
+        value["KIND"] = cell;
+        snprintf(cell, sizeof(cell), "E%d=ROUND(p2/%d+k1,4)", row, row);
+        formula["RATE"] = cell;
+        snprintf(cell, sizeof(cell), "C%d=IF(p1>%d,p1*E%d,E%d-p1)", row, row % 7, row, row);
+        formula["AMT"] = cell;
+        model["lines"]["values"].append(value);
+        model["lines"]["formulas"].append(formula);
+    }
+
+    const char* formulas[][2] = {
+        { "B1", "total=SUM(LINES[AMT])"                  },
+        { "B2", "rates=SUM(LINES[RATE])"                 },
+        { "B3", "bykind=SUMIFS(LINES[AMT],LINES[KIND],p3)" },
+        { "B4", "head=SUM(C11:C30)"                      },
+        { "B5", "mix=ROUND(total/MAX(rates,1),6)+bykind"   },
+        { "B6", "pick=IF(p2>5,head,total-bykind)"          }
+    };
+    for ( auto formula : formulas ) {
+        model["formulas"][formula[0]]["type"]  = "DECIMAL";
+        model["formulas"][formula[0]]["value"] = formula[1];
+    }
+
+    return Json::FastWriter().write(model);
+}
+
+/**
+ * @brief Calculate the parameter sets with a number of threads
+ */
+static void Calculate (size_t a_threads, bool a_incremental, const std::string& a_model,
+                       const std::vector<Json::Value>& a_params, std::vector<Json::Value>& o_results)
+{
+    casper::see::test::TestSee see;
+    see.SetCalculationThreads(a_threads);
+    see.SetIncremental(a_incremental);
+    see.LoadModelFromString(a_model.c_str());
+    o_results.resize(a_params.size());
+    for ( size_t i = 0; i < a_params.size(); ++i ) {
+        see.CalculateAll(a_params[i]);
+        see.SerializeScalarsToJSONObject(o_results[i]);
+    }
+}
+
+int main (int /* a_argc */, char** /* a_argv */)
+{
+    const char*              kinds[] = { "a", "b", "c", "z" };
+    const std::string        model   = Model();
+    std::mt19937             generator(6);
+    std::vector<Json::Value> params(150);
+
+    for ( size_t i = 0; i < params.size(); ++i ) {
+        params[i]["p1"] = static_cast<double>(generator() % 10);
+        params[i]["p2"] = static_cast<double>(generator() % 10) / 4.0;
+        params[i]["p3"] = kinds[generator() % 4];
+    }
+
+    try {
+        std::vector<Json::Value> serial;
+        Calculate(0, false, model, params, serial);
+        CASPER_CHECK(serial[0]["total"].isDouble() && serial[0]["bykind"].isDouble(), "sums of set 0 %s",
+                     serial[0].toStyledString().c_str());
+
+        for ( size_t threads : { 0, 2, 4, 8 } ) {
+            for ( bool incremental : { false, true } ) {
+                std::vector<Json::Value> parallel;
+                Calculate(threads, incremental, model, params, parallel);
+                for ( size_t i = 0; i < params.size(); ++i ) {
+                    CASPER_CHECK(parallel[i] == serial[i], "%zu threads%s, set %zu %s: parallel %s serial %s", threads,
+                                 incremental ? " incremental" : "", i, params[i].toStyledString().c_str(),
+                                 parallel[i].toStyledString().c_str(), serial[i].toStyledString().c_str());
+                }
+            }
+        }
+    } catch (const osal::Exception& a_exception) {
+        CASPER_CHECK(false, "%s", a_exception.Message());
+    }
+
+    return casper::see::test::Summary("parallel_test");
+}
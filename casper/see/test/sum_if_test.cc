@@ -0,0 +1,153 @@
+/**
+ * @file sum_if_test.cc checks that SUMIF on a table gives exactly the row by row sum for every operator
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/test/test_helpers.h"
+
+#include <random>
+#include <vector>
+
+/*
+ * Numbers of very different magnitudes, any other order of the additions gives another sum, the large
+ * ones are rare so that some comparisons match only a few rows
+ */
+static const double k_numbers_[] = { 1e16, -1e16, 1.0, 0.1, 0.3, -2.5, 3.25, 1e-3, 7.0, 2.0 };
+static const double k_rare_[]    = { 1e20, -1e20, 5e18 };
+
+static const char* k_operators_[] = { "<", "<=", ">", ">=", "=", "<>" };
+
+/**
+ * @brief SUMIF as a scan of the rows, the reference
+ */
+static double SumIfByRow (const std::vector<double>& a_rows, const std::string& a_operator, double a_key)
+{
+    double sum = 0.0;
+
+    for ( const double number : a_rows ) {
+        bool match;
+        if ( "<" == a_operator ) {
+            match = number < a_key;
+        } else if ( "<=" == a_operator ) {
+            match = number <= a_key;
+        } else if ( ">" == a_operator ) {
+            match = number > a_key;
+        } else if ( ">=" == a_operator ) {
+            match = number >= a_key;
+        } else if ( "=" == a_operator ) {
+            match = number == a_key;
+        } else {
+            match = number != a_key;
+        }
+        if ( true == match ) {
+            sum += number;
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief Check every operator against the keys on a table of @a a_rows rows
+ */
+static void CheckTable (std::mt19937& a_generator, int a_rows)
+{
+    std::vector<double> rows;
+    std::vector<double> keys = { 0.3, 1.0, -3.0, 1e19, -1e19, 0.0 };
+    std::vector<double> expected;
+    Json::Value         table(Json::arrayValue), column, model;
+    char                cell[64], formula[256];
+
+    for ( int row = 0; row < a_rows; ++row ) {
+        rows.push_back(0 == a_generator() % 50 ? k_rare_[a_generator() % 3] : k_numbers_[a_generator() % 10]);
+    }
+    for ( int key = 0; key < 4; ++key ) {
+        keys.push_back(k_numbers_[a_generator() % 10]);
+    }
+
+    column["name"] = "amount";
+    column["type"] = "number";
+    column["data"] = Json::Value(Json::arrayValue);
+    for ( const double number : rows ) {
+        column["data"].append(number);
+    }
+    table.append(column);
+
+    model["values"]["p1"]["type"]  = "DECIMAL";
+    model["values"]["p1"]["value"] = "p1";
+    model["lines"]["header"]["C10"]["type"] = "DECIMAL";
+    model["lines"]["header"]["C10"]["name"] = "KEY";
+    model["lines"]["header"]["D10"]["type"] = "DECIMAL";
+    model["lines"]["header"]["D10"]["name"] = "S";
+    model["lines"]["values"]   = Json::Value(Json::arrayValue);
+    model["lines"]["formulas"] = Json::Value(Json::arrayValue);
+
+    int line = 11;
+    for ( const double key : keys ) {
+        for ( const char* op : k_operators_ ) {
+            Json::Value formulas;
+            snprintf(formula, sizeof(formula), "C%d=%.17g", line, key);
+            formulas["KEY"] = formula;
+            snprintf(formula, sizeof(formula), "D%d=SUMIF(AMOUNTS[amount],\"%s\"&LINES[[#This Row],[KEY]])", line, op);
+            formulas["S"] = formula;
+            model["lines"]["formulas"].append(formulas);
+
+            // ... scalars are above the lines header, one column per key ...
+            snprintf(cell, sizeof(cell), "%c%zu", static_cast<char>('E' + ( line - 11 ) / 6), 1 + ( line - 11 ) % 6);
+            snprintf(formula, sizeof(formula), "r%d=D%d", line, line);
+            model["formulas"][cell]["type"]  = "DECIMAL";
+            model["formulas"][cell]["value"] = formula;
+
+            expected.push_back(SumIfByRow(rows, op, key));
+            ++line;
+        }
+    }
+
+    casper::see::test::TempDir folder;
+    casper::see::test::TestSee see;
+    Json::Value                params, result;
+
+    folder.Write("AMOUNTS.json", Json::FastWriter().write(table));
+    see.SetJsonTablesPath(folder.Path());
+    see.LoadModelFromString(Json::FastWriter().write(model).c_str());
+    params["p1"] = 1.0;
+    see.CalculateAll(params);
+    see.SerializeScalarsToJSONObject(result);
+
+    for ( size_t idx = 0; idx < expected.size(); ++idx ) {
+        snprintf(cell, sizeof(cell), "r%zu", 11 + idx);
+        const double sum = result[cell].asDouble();
+        CASPER_CHECK(sum == expected[idx], "%d rows, amount %s %.17g: %.17g row by row %.17g", a_rows,
+                     k_operators_[idx % 6], keys[idx / 6], sum, expected[idx]);
+    }
+}
+
+int main (int /* a_argc */, char** /* a_argv */)
+{
+    std::mt19937 generator(11);
+
+    try {
+        for ( int rows : { 1, 7, 40, 400, 5000 } ) {
+            CheckTable(generator, rows);
+        }
+    } catch (const osal::Exception& a_exception) {
+        CASPER_CHECK(false, "%s", a_exception.Message());
+    }
+
+    return casper::see::test::Summary("sum_if_test");
+}
@@ -0,0 +1,193 @@
+/**
+ * @file table_parser_test.cc checks the streaming table parser against Json::Reader and the JSON grammar
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Every document is also parsed in two slices split at each offset, a token cut in half must give the
+ * same table as the whole text.
+ */
+
+#include "casper/see/test/test_helpers.h"
+#include "casper/see/table_parser.h"
+
+#include <string>
+
+/*
+ * Escapes, \u sequences with and without surrogate pairs, the data of the second column comes before it's type
+ */
+static const char* k_escapes_ = R"JSON([
+ {"name":"S","type":"text","data":["a\"b","\\","\/","\b\f\n\r\t","\u0041\u00e9\u20ac","\ud83d\ude00","x\u0000y",""]},
+ {"data":["\u0031",2,true,false,null,"z","\"\u002f",-1.5],"name":"T","type":"text"}
+])JSON";
+
+/*
+ * Integers, fractions and exponents in a number column and in a text column
+ */
+static const char* k_numbers_ = R"JSON([
+ {"name":"N","type":"number","data":[0,-0,7,-12,1.5,-2.25e3,1E+2,1e-2,0.000125,123456789012345678,18446744073709551616,-9223372036854775809,true,false,null]},
+ {"name":"T","type":"text",  "data":[0,-0,7,-12,1.5,-2.25e3,1E+2,1e-2,0.000125,123456789012345678,18446744073709551616,-9223372036854775809,true,false,null]}
+])JSON";
+
+/**
+ * @return the cells of every column, one line per column
+ */
+static std::string Dump (const casper::see::Table& a_table)
+{
+    std::string dump;
+    char        number[64];
+
+    for ( const auto& column : a_table.GetColumns() ) {
+        dump += column.name_ + ":";
+        for ( size_t row = 0; row < column.Size(); ++row ) {
+            casper::Term term;
+            column.Get(row, term);
+            if ( true == term.IsNumber() ) {
+                snprintf(number, sizeof(number), " n%.17g", term.GetNumber());
+                dump += number;
+            } else {
+                dump += std::string(" s'") + term.GetText() + "'";
+            }
+        }
+        dump += "\n";
+    }
+    return dump;
+}
+
+/**
+ * @brief Load a document with Json::Reader and Table::Load, the reference
+ */
+static std::string Reference (const std::string& a_json)
+{
+    casper::see::Table table("t", false);
+    Json::Value        document;
+
+    CASPER_CHECK(true == Json::Reader().parse(a_json, document), "Json::Reader rejects %s", a_json.c_str());
+    table.Load(document, "t");
+    return Dump(table);
+}
+
+/**
+ * @brief Parse a document in two slices, the first one ends at @a a_split
+ *
+ * @return false on a syntax or a table error
+ */
+static bool Stream (const std::string& a_json, size_t a_split, std::string& o_dump)
+{
+    casper::see::Table       table("t", false);
+    casper::see::TableParser parser(table, "t");
+
+    try {
+        parser.InitParse();
+        if (    false == parser.ParseSlice(a_json.c_str(), a_split)
+             || false == parser.ParseSlice(a_json.c_str() + a_split, a_json.length() - a_split)
+             || false == parser.FinishParse() ) {
+            return false;
+        }
+    } catch (const osal::Exception& /* a_exception */) {
+        return false;
+    }
+    o_dump = Dump(table);
+    return true;
+}
+
+/**
+ * @brief A valid document gives the reference table wherever it's split
+ */
+static void CheckValid (const char* a_test, const std::string& a_json, const std::string& a_expected)
+{
+    for ( size_t split = 0; split <= a_json.length(); ++split ) {
+        std::string dump;
+        const bool  parsed = Stream(a_json, split, dump);
+        CASPER_CHECK(true == parsed, "%s, split at %zu: rejected", a_test, split);
+        CASPER_CHECK(false == parsed || a_expected == dump, "%s, split at %zu:\n%s\nexpected\n%s", a_test, split,
+                     dump.c_str(), a_expected.c_str());
+        if ( false == parsed || a_expected != dump ) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief An invalid document is rejected wherever it's split
+ */
+static void CheckInvalid (const std::string& a_json)
+{
+    for ( size_t split = 0; split <= a_json.length(); ++split ) {
+        std::string dump;
+        if ( true == Stream(a_json, split, dump) ) {
+            CASPER_CHECK(false, "%s, split at %zu: accepted", a_json.c_str(), split);
+            return;
+        }
+    }
+}
+
+int main (int /* a_argc */, char** /* a_argv */)
+{
+    std::string escapes, numbers;
+
+    try {
+        escapes = Reference(k_escapes_);
+        numbers = Reference(k_numbers_);
+    } catch (const osal::Exception& a_exception) {
+        CASPER_CHECK(false, "%s", a_exception.Message());
+        return casper::see::test::Summary("table_parser_test");
+    }
+
+    CASPER_CHECK(std::string::npos != escapes.find("S: s'a\"b' s'\\' s'/' s'\b\f\n\r\t' s'A\xC3\xA9\xE2\x82\xAC' s'\xF0\x9F\x98\x80'"),
+                 "unexpected reference %s", escapes.c_str());
+    CheckValid("escapes", k_escapes_, escapes);
+    CheckValid("numbers", k_numbers_, numbers);
+    CheckValid("empty table", "[]", "");
+    CheckValid("empty column", "[{\"name\":\"E\",\"type\":\"number\",\"data\":[]}]", "E:\n");
+    CheckValid("text after the table", "[{\"name\":\"E\",\"type\":\"number\",\"data\":[1]}] trailing", "E: n1\n");
+
+    const char* numbers_grammar[] = {
+        "01", "-01", "00", "1.", "-", ".5", "-.5", "+1", "1e", "1e+", "1E-", "1.2.3", "1..2", "--1", "1-2", "1e2e3",
+        "1e2.5", "1.e5", "1+", "0x1", "-a", "Infinity", "NaN"
+    };
+    for ( auto number : numbers_grammar ) {
+        CheckInvalid(std::string("[{\"name\":\"N\",\"type\":\"number\",\"data\":[") + number + "]}]");
+        CheckInvalid(std::string("[{\"name\":\"T\",\"type\":\"text\",\"data\":[1,") + number + ",2]}]");
+    }
+
+    const char* strings_grammar[] = {
+        "\\x", "\\u12", "\\u12g4", "\\U0041", "\\ud83d", "\\ud83dx", "\\ud83d\\u0041", "\\ud83d\\n", "abc\\"
+    };
+    for ( auto text : strings_grammar ) {
+        CheckInvalid(std::string("[{\"name\":\"S\",\"type\":\"text\",\"data\":[\"") + text + "\"]}]");
+    }
+
+    const char* documents_grammar[] = {
+        "", " ", "[", "[{", "[1", "[{\"name\"}]", "[{\"name\":\"S\",}]", "[{\"name\":\"S\" \"type\":\"text\"}]",
+        "[{\"name\":\"S\",\"type\":\"text\",\"data\":[tru]}]", "[{\"name\":\"S\",\"type\":\"text\",\"data\":[nul]}]",
+        "[{\"name\":\"S\",\"type\":\"text\",\"data\":[1,]}]", "[{\"name\":\"S\",\"type\":\"text\",\"data\":[,1]}]",
+        "[{\"name\":\"S\",\"type\":\"text\",\"data\":[1}]}]", "{\"name\":\"S\"}"
+    };
+    for ( auto document : documents_grammar ) {
+        CheckInvalid(document);
+    }
+
+    // ... every truncation of a valid document is rejected ...
+    const std::string whole = k_numbers_;
+    for ( size_t length = 0; length < whole.find_last_of(']') + 1; ++length ) {
+        std::string dump;
+        CASPER_CHECK(false == Stream(whole.substr(0, length), length / 2, dump), "truncated at %zu: accepted", length);
+    }
+
+    return casper::see::test::Summary("table_parser_test");
+}
@@ -0,0 +1,170 @@
+/**
+ * @file test_helpers.h declaration of the helpers shared by the see engine tests and benchmarks
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#ifndef NRS_CASPER_CASPER_SEE_TEST_TEST_HELPERS_H
+#define NRS_CASPER_CASPER_SEE_TEST_TEST_HELPERS_H
+
+#include "casper/see/see.h"
+#include "json/json.h"
+
+#include <chrono>
+#include <string>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * @brief Report a failed condition and count it, the test keeps running
+ */
+#define CASPER_CHECK(a_condition, ...) \
+    do { \
+        if ( false == static_cast<bool>(a_condition) ) { \
+            fprintf(stderr, "%s:%d: check '%s' failed: ", __FILE__, __LINE__, #a_condition); \
+            fprintf(stderr, __VA_ARGS__); \
+            fprintf(stderr, "\n"); \
+            ++casper::see::test::g_failures; \
+        } \
+    } while (0)
+
+namespace casper
+{
+    namespace see
+    {
+        namespace test
+        {
+            static int g_failures = 0; //!< Checks failed so far, the exit code of the test
+
+            /**
+             * @brief Engine with the loading of in memory models opened to the tests
+             */
+            class TestSee : public See
+            {
+            public:
+
+                using See::LoadModel;
+                using See::LoadModelFromFile;
+
+                /**
+                 * @brief Load a model from it's JSON text
+                 *
+                 * @param a_json model in the format of the model files
+                 */
+                void LoadModelFromString (const char* a_json)
+                {
+                    Json::Value     model;
+                    Json::Reader    reader;
+                    StringMultiHash clones;
+                    if ( false == reader.parse(a_json, model) ) {
+                        throw OSAL_EXCEPTION("Invalid test model: %s", reader.getFormattedErrorMessages().c_str());
+                    }
+                    LoadModel(model, clones);
+                }
+
+                /**
+                 * @brief Set the folder of the lookup table files
+                 */
+                void SetJsonTablesPath (const std::string& a_path)
+                {
+                    json_tables_path_ = a_path;
+                }
+            };
+
+            /**
+             * @brief Folder with the files written by a test, removed with it's contents when destroyed
+             */
+            class TempDir
+            {
+            private:
+
+                std::string path_;
+
+            public:
+
+                TempDir ()
+                {
+                    char path[] = "/tmp/casper_see_test_XXXXXX";
+                    if ( nullptr == mkdtemp(path) ) {
+                        throw OSAL_EXCEPTION_NA("Unable to create a temporary folder!");
+                    }
+                    path_  = path;
+                    path_ += "/";
+                }
+
+                ~TempDir ()
+                {
+                    const std::string command = "rm -rf '" + path_ + "'";
+                    if ( 0 != system(command.c_str()) ) {
+                        fprintf(stderr, "Unable to remove %s\n", path_.c_str());
+                    }
+                }
+
+                const std::string& Path () const
+                {
+                    return path_;
+                }
+
+                /**
+                 * @brief Write a file in the folder
+                 *
+                 * @return full name of the file
+                 */
+                std::string Write (const char* a_name, const std::string& a_contents) const
+                {
+                    const std::string name = path_ + a_name;
+                    FILE* file = fopen(name.c_str(), "wb");
+                    if ( nullptr == file ) {
+                        throw OSAL_EXCEPTION("Unable to write %s!", name.c_str());
+                    }
+                    fwrite(a_contents.data(), 1, a_contents.size(), file);
+                    fclose(file);
+                    return name;
+                }
+            };
+
+            /**
+             * @return milliseconds elapsed since a_start
+             */
+            inline double ElapsedMs (const std::chrono::steady_clock::time_point& a_start)
+            {
+                return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - a_start).count();
+            }
+
+            /**
+             * @brief Print the outcome of the test
+             *
+             * @return exit code of the test
+             */
+            inline int Summary (const char* a_test)
+            {
+                if ( 0 == g_failures ) {
+                    fprintf(stdout, "%s: passed\n", a_test);
+                    return EXIT_SUCCESS;
+                }
+                fprintf(stdout, "%s: %d check(s) failed\n", a_test, g_failures);
+                return EXIT_FAILURE;
+            }
+
+        } // namespace test
+    } // namespace see
+} // namespace casper
+
+#endif // NRS_CASPER_CASPER_SEE_TEST_TEST_HELPERS_H
@@ -0,0 +1,154 @@
+/**
+ * @file value.cc implementation of the compact value stored by the lookup tables
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/value.h"
+
+#include "osal/exception.h"
+
+static_assert(sizeof(casper::see::Value) == 16, "casper::see::Value must stay 16 bytes");
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark ::: StringPool :::
+#pragma mark -
+#endif
+
+std::mutex                                casper::see::StringPool::mutex_;
+std::unordered_map<std::string, uint32_t> casper::see::StringPool::index_;
+std::atomic<std::string*>                 casper::see::StringPool::chunks_[casper::see::StringPool::k_max_chunks_];
+uint32_t                                  casper::see::StringPool::count_ = 1;
+size_t                                    casper::see::StringPool::bytes_ = 0;
+
+/**
+ * @brief Return the handle of a string, adding it to the pool when needed
+ */
+uint32_t casper::see::StringPool::Intern (const std::string& a_string)
+{
+    // ... the empty string is handle 0 ...
+    if ( 0 == a_string.size() ) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const auto it = index_.find(a_string);
+    if ( index_.end() != it ) {
+        return it->second;
+    }
+
+    const uint32_t handle = count_;
+    const uint32_t chunk  = handle >> k_chunk_bits_;
+    if ( chunk >= k_max_chunks_ ) {
+        throw OSAL_EXCEPTION("String pool is full, %u strings interned", count_);
+    }
+    std::string* strings = chunks_[chunk].load(std::memory_order_relaxed);
+    if ( nullptr == strings ) {
+        strings = new std::string[k_chunk_size_];
+    }
+    strings[handle & ( k_chunk_size_ - 1 )] = a_string;
+    chunks_[chunk].store(strings, std::memory_order_release);
+
+    index_[a_string] = handle;
+    count_  += 1;
+    bytes_  += a_string.size();
+    return handle;
+}
+
+/**
+ * @brief Find the handle of a string without adding it to the pool
+ *
+ * @return false if the string was never interned
+ */
+bool casper::see::StringPool::Find (const std::string& a_string, uint32_t& o_handle)
+{
+    if ( 0 == a_string.size() ) {
+        o_handle = 0;
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const auto it = index_.find(a_string);
+    if ( index_.end() == it ) {
+        return false;
+    }
+    o_handle = it->second;
+    return true;
+}
+
+/**
+ * @return number of strings in the pool
+ */
+size_t casper::see::StringPool::Size ()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_ - 1;
+}
+
+/**
+ * @return number of characters held by the pool
+ */
+size_t casper::see::StringPool::Bytes ()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark ::: Value :::
+#pragma mark -
+#endif
+
+/**
+ * @brief Keep the type, number and text of a term
+ */
+void casper::see::Value::operator = (const casper::Term& a_term)
+{
+    type_   = a_term.type_;
+    number_ = a_term.number_;
+    text_   = ( 0 != a_term.text_.size() ? StringPool::Intern(a_term.text_) : 0 );
+}
+
+/**
+ * @brief Copy the value to a term
+ */
+void casper::see::Value::Get (casper::Term& o_term) const
+{
+    o_term.type_   = type_;
+    o_term.number_ = number_;
+    o_term.text_   = StringPool::Get(text_);
+    o_term.aux_text_.clear();
+    o_term.aux_condition_.clear();
+}
+
+/**
+ * @return the numeric value, text is converted like Term::ToNumber does
+ */
+double casper::see::Value::ToNumber () const
+{
+    if ( Term::ENumber == type_ ) {
+        return number_;
+    }
+    Term term;
+    Get(term);
+    return term.ToNumber();
+}
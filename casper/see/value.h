@@ -0,0 +1,183 @@
+/**
+ * @file value.h declaration of the compact value stored by the lookup tables
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#ifndef NRS_CASPER_CASPER_SEE_VALUE_H
+#define NRS_CASPER_CASPER_SEE_VALUE_H
+
+#include "casper/term.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+namespace casper
+{
+    namespace see
+    {
+        /**
+         * @brief Process wide pool of interned strings
+         *
+         * Strings are never released, equal strings share one handle so the pool grows with the number of
+         * distinct strings loaded. Interning takes a lock, reading a handle doesn't.
+         */
+        class StringPool
+        {
+        public: // Constants
+
+            static const uint32_t k_chunk_bits_ = 12;
+            static const uint32_t k_chunk_size_ = 1 << k_chunk_bits_;
+            static const uint32_t k_max_chunks_ = 1 << 16;
+
+        protected: // Data
+
+            static std::mutex                                mutex_;   //!< Serializes #Intern
+            static std::unordered_map<std::string, uint32_t> index_;   //!< Maps the strings to their handles
+            static std::atomic<std::string*>                 chunks_[k_max_chunks_]; //!< Strings by handle, in chunks that never move
+            static uint32_t                                  count_;   //!< Number of interned strings, handle 0 is the empty string
+            static size_t                                    bytes_;   //!< Characters held by the pool
+
+        public: // Static Method(s) / Function(s)
+
+            static uint32_t           Intern (const std::string& a_string);
+            static bool               Find   (const std::string& a_string, uint32_t& o_handle);
+            static const std::string& Get    (uint32_t a_handle);
+            static size_t             Size   ();
+            static size_t             Bytes  ();
+
+        };
+
+        /**
+         * @brief 16 byte value with the type bits of a Term and either a number or an interned string
+         *
+         * The scanner and parser fields of Term are not kept, a value is converted to a Term when it's read by
+         * the evaluator.
+         */
+        class Value
+        {
+        protected: // Data
+
+            uint32_t type_;    //!< Term type bits
+            uint32_t text_;    //!< #StringPool handle of the text
+            double   number_;  //!< Numeric value
+
+        public: // Constructor(s) / Destructor
+
+            Value ();
+            Value (double a_number);
+            Value (const std::string& a_text);
+            Value (const Term& a_term);
+
+        public: // Method(s) / Function(s)
+
+            void               operator = (const Term& a_term);
+            void               Get        (Term& o_term) const;
+            unsigned           GetType    () const;
+            double             GetNumber  () const;
+            const std::string& GetText    () const;
+            uint32_t           TextHandle () const;
+            double             ToNumber   () const;
+
+        public: // Static Method(s) / Function(s)
+
+            static Value       Text       (uint32_t a_handle);
+
+        };
+
+        /**
+         * @return the string of a handle returned by #Intern
+         */
+        inline const std::string& StringPool::Get (uint32_t a_handle)
+        {
+            if ( 0 == a_handle ) {
+                static const std::string empty;
+                return empty;
+            }
+            return chunks_[a_handle >> k_chunk_bits_].load(std::memory_order_acquire)[a_handle & ( k_chunk_size_ - 1 )];
+        }
+
+        inline Value::Value ()
+        {
+            type_   = Term::EUndefined;
+            text_   = 0;
+            number_ = 0.0;
+        }
+
+        inline Value::Value (double a_number)
+        {
+            type_   = Term::ENumber;
+            text_   = 0;
+            number_ = a_number;
+        }
+
+        inline Value::Value (const std::string& a_text)
+        {
+            type_   = Term::EText;
+            text_   = StringPool::Intern(a_text);
+            number_ = NAN;
+        }
+
+        inline Value::Value (const Term& a_term)
+        {
+            *this = a_term;
+        }
+
+        inline unsigned Value::GetType () const
+        {
+            return type_;
+        }
+
+        inline double Value::GetNumber () const
+        {
+            return number_;
+        }
+
+        inline const std::string& Value::GetText () const
+        {
+            return StringPool::Get(text_);
+        }
+
+        /**
+         * @return the pool handle of the text, equal texts have equal handles
+         */
+        inline uint32_t Value::TextHandle () const
+        {
+            return text_;
+        }
+
+        /**
+         * @return a text value from a #StringPool handle
+         */
+        inline Value Value::Text (uint32_t a_handle)
+        {
+            Value value;
+
+            value.type_   = Term::EText;
+            value.text_   = a_handle;
+            value.number_ = NAN;
+            return value;
+        }
+
+    } // namespace see
+} // namespace casper
+
+#endif // NRS_CASPER_CASPER_SEE_VALUE_H
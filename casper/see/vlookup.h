@@ -34,7 +34,10 @@ namespace casper
     namespace see
     {
         /**
-         * @brief Specialization of Formula for VLOOKUP
+         * @brief Specialization of Formula for VLOOKUP on the LINES table
+         *
+         * One formula per search column and result column, the lookups depend on it so that they are calculated
+         * after the cells of the cloned lines. The lookups themselves are answered by See::LinesVlookup.
          */
         class Vlookup : public Formula
         {
@@ -52,19 +55,21 @@ namespace casper
             
             Vlookup (See& a_see,
                      const char* const a_search_column_name, const int& a_result_column_index);
+            Vlookup (See& a_see, ModelCacheReader& a_reader);
             virtual ~Vlookup ();
 
         public: // Inherited virtual method(s) / function(s)
 
             virtual void CalculateDependencies (See& a_see);
-            virtual Term VLOOKUP               (const Term& a_value, const char* const a_lookup_col, const Term& a_result_index, bool a_range_lookup);
+            virtual Kind GetKind               () const;
+            virtual void Save                  (ModelCacheWriter& a_writer) const;
 
-        protected: // Method(s) / Function(s)
+        }; // end of class Vlookup
 
-            void    SeekColumnsInfo            (const char* const a_search_column_name, const int& a_result_column_index,
-                                                ColumnInfo& o_search_column_info, ColumnInfo& o_result_column_info);
-
-        }; // end of class LinesVLookup
+        inline Formula::Kind Vlookup::GetKind () const
+        {
+            return EVlookup;
+        }
 
     } // end of namespace see
 
@@ -0,0 +1,136 @@
+/**
+ * @file worker_pool.cc implementation of the threads used to calculate independent formulas
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/see/worker_pool.h"
+
+/**
+ * @brief Constructor, starts the worker threads
+ *
+ * @param a_size number of workers including the calling thread
+ */
+casper::see::WorkerPool::WorkerPool (size_t a_size)
+    : job_(nullptr), job_count_(0), next_index_(0), busy_workers_(0), generation_(0), stop_(false)
+{
+    for ( size_t worker = 1; worker < a_size; ++worker ) {
+        threads_.push_back(std::thread(&WorkerPool::Loop, this, worker));
+    }
+}
+
+/**
+ * @brief Destructor, stops and joins the worker threads
+ */
+casper::see::WorkerPool::~WorkerPool ()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for ( auto& thread : threads_ ) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Run a batch of jobs, returns when all are done
+ *
+ * If a job throws the remaining jobs are not started and the first exception is rethrown here.
+ *
+ * @param a_count number of jobs
+ * @param a_job   function called with the worker number and the job index
+ */
+void casper::see::WorkerPool::Run (size_t a_count, const casper::see::WorkerPool::Job& a_job)
+{
+    if ( 0 == a_count ) {
+        return;
+    }
+
+    // ... not worth waking up the workers ...
+    if ( 1 == a_count || 0 == threads_.size() ) {
+        for ( size_t idx = 0; idx < a_count; ++idx ) {
+            a_job(0, idx);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_          = &a_job;
+        job_count_    = a_count;
+        busy_workers_ = threads_.size();
+        error_        = nullptr;
+        next_index_.store(0);
+        generation_  += 1;
+    }
+    work_cv_.notify_all();
+
+    Work(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return 0 == busy_workers_; });
+    job_ = nullptr;
+    if ( nullptr != error_ ) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * @brief Worker thread body, waits for batches until the pool is destroyed
+ */
+void casper::see::WorkerPool::Loop (size_t a_worker)
+{
+    uint64_t generation = 0;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while ( true ) {
+        work_cv_.wait(lock, [this, generation] { return stop_ || generation != generation_; });
+        if ( true == stop_ ) {
+            return;
+        }
+        generation = generation_;
+        lock.unlock();
+        Work(a_worker);
+        lock.lock();
+        if ( 0 == --busy_workers_ ) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief Pick and run jobs of the current batch until none is left
+ */
+void casper::see::WorkerPool::Work (size_t a_worker)
+{
+    for ( size_t idx = next_index_++; idx < job_count_; idx = next_index_++ ) {
+        try {
+            (*job_)(a_worker, idx);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if ( nullptr == error_ ) {
+                error_ = std::current_exception();
+            }
+            next_index_.store(job_count_);
+        }
+    }
+}
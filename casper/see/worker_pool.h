@@ -0,0 +1,93 @@
+/**
+ * @file worker_pool.h declaration of the threads used to calculate independent formulas
+ *
+ * Copyright (c) 2010-2016 Neto Ranito & Seabra LDA. All rights reserved.
+ *
+ * This file is part of casper.
+ *
+ * casper is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper  is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#ifndef NRS_CASPER_CASPER_SEE_WORKER_POOL_H
+#define NRS_CASPER_CASPER_SEE_WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace casper
+{
+    namespace see
+    {
+        /**
+         * @brief Fixed set of threads that run one batch of independent jobs at a time
+         *
+         * The calling thread is worker 0 and takes part in the batch, #Run returns when all jobs are done.
+         */
+        class WorkerPool
+        {
+        public: // Typedefs
+
+            typedef std::function<void(size_t a_worker, size_t a_index)> Job;
+
+        protected: // Data
+
+            std::vector<std::thread> threads_;       //!< Workers 1 .. N-1
+            std::mutex               mutex_;         //!< Protects the batch state
+            std::condition_variable  work_cv_;       //!< Signals a new batch or the shutdown
+            std::condition_variable  done_cv_;       //!< Signals the end of the batch
+            const Job*               job_;           //!< Job of the running batch
+            size_t                   job_count_;     //!< Number of jobs of the running batch
+            std::atomic<size_t>      next_index_;    //!< Next job to pick
+            size_t                   busy_workers_;  //!< Workers still running the batch
+            uint64_t                 generation_;    //!< Incremented for each batch
+            bool                     stop_;          //!< Set by the destructor
+            std::exception_ptr       error_;         //!< First exception thrown by a job
+
+        public: // Constructor(s) / Destructor
+
+            WorkerPool (size_t a_size);
+            virtual ~WorkerPool ();
+
+            WorkerPool (const WorkerPool& a_pool) = delete;
+            WorkerPool& operator = (const WorkerPool& a_pool) = delete;
+
+        public: // Method(s) / Function(s)
+
+            size_t Size () const;
+            void   Run  (size_t a_count, const Job& a_job);
+
+        protected: // Method(s) / Function(s)
+
+            void   Loop (size_t a_worker);
+            void   Work (size_t a_worker);
+
+        };
+
+        /**
+         * @return Number of workers, including the calling thread
+         */
+        inline size_t WorkerPool::Size () const
+        {
+            return threads_.size() + 1;
+        }
+
+    } // namespace see
+} // namespace casper
+
+#endif // NRS_CASPER_CASPER_SEE_WORKER_POOL_H
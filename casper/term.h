@@ -68,6 +68,11 @@ namespace casper
         class SumIfs;
         class Vlookup;
         class Table;
+        class ModelCacheWriter;
+        class ModelCacheReader;
+        class Value;
+        class LookupCache;
+        class LinesIndex;
     }
 
     /*
@@ -122,6 +127,11 @@ namespace casper
         friend class see::SumIfs;
         friend class see::Vlookup;
         friend class see::Table;
+        friend class see::ModelCacheWriter;
+        friend class see::ModelCacheReader;
+        friend class see::Value;
+        friend class see::LookupCache;
+        friend class see::LinesIndex;
         friend class java::FakeJavaParser;
         friend class java::FakeJavaExpression;
         friend class epaper::calc::BasicParser;
@@ -73,11 +73,13 @@ osal::utils::JsonParserBase::JsonParserBase (uint32_t a_capacity)
     error_col_             = -1;
     success_               = true;
 
+#if !defined(CASPER_NO_ICU)
     icu_error_code_     = UErrorCode::U_ZERO_ERROR;
     icu_normalizer_ptr_ = U_ICU_NAMESPACE::Normalizer2::getInstance(NULL, "nfc", UNORM2_COMPOSE, icu_error_code_);
     if ( UErrorCode::U_ZERO_ERROR != icu_error_code_ ) {
         icu_normalizer_ptr_ = nullptr;
     }
+#endif
     fractional_digits_cnt_ = 0;
 }
 
@@ -29,8 +29,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <string>
 
+#if !defined(CASPER_NO_ICU)
 #include "unicode/normalizer2.h" // U_ICU_NAMESPACE::Normalizer2
+#endif
 
 namespace osal {
 
@@ -100,8 +103,10 @@ namespace osal {
 
         protected: // ICU
 
+#if !defined(CASPER_NO_ICU)
             const U_ICU_NAMESPACE::Normalizer2* icu_normalizer_ptr_;     //!< UTF8 string normalizer.
             UErrorCode                          icu_error_code_;         //!<
+#endif
             std::string                         icu_normalized_string_;  //!<
 
         protected:
@@ -155,6 +160,10 @@ namespace osal {
 
         inline const std::string& JsonParserBase::NormalizeString (const char* a_string)
         {
+#if defined(CASPER_NO_ICU)
+            icu_normalized_string_ = a_string;
+            return icu_normalized_string_;
+#else
             if ( nullptr == icu_normalizer_ptr_ ) {
                 icu_normalized_string_ = a_string;
                 return icu_normalized_string_;
@@ -172,6 +181,7 @@ namespace osal {
             }
 
             return icu_normalized_string_;
+#endif
         }
 
     } // endof namespace utils